@@ -7,8 +7,13 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>  // for min/max
+#include <vector>
+
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "DebugDraw.h"
+#endif
 
-#include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
@@ -16,6 +21,7 @@
 #include "CoordinateSystem.h"
 #include "PerlinNoiseField3.h"
 #include "Entity.h"
+#include "OctahedralMap.h"
 
 using namespace ObjLibrary;
 namespace
@@ -41,6 +47,7 @@ namespace
 
 
 
+#ifndef GAME_HEADLESS
 bool Asteroid :: isUnitSphere (const ObjLibrary::ObjModel& base_model)
 {
 	static const double TOLERANCE = 1.0e-3;
@@ -55,6 +62,7 @@ bool Asteroid :: isUnitSphere (const ObjLibrary::ObjModel& base_model)
 	}
 	return true;
 }
+#endif  // GAME_HEADLESS is not defined
 
 double Asteroid :: calculateMass (double inner_radius,
                                   double outer_radius)
@@ -65,10 +73,11 @@ double Asteroid :: calculateMass (double inner_radius,
 	return PI * outer_radius * outer_radius * inner_radius * DENSITY / 6.0;
 }
 
-ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
-                                                       double inner_radius,
-                                                       double outer_radius,
-                                                       ObjLibrary::Vector3 random_noise_offset)
+#ifndef GAME_HEADLESS
+ObjLibrary::ObjModel Asteroid :: createModel (const ObjLibrary::ObjModel& base_model,
+                                              double inner_radius,
+                                              double outer_radius,
+                                              const ObjLibrary::Vector3& random_noise_offset)
 {
 	assert(isUnitSphere(base_model));
 
@@ -76,16 +85,28 @@ ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjMode
 	double radius_average    = (outer_radius + inner_radius) * 0.5;
 	double radius_half_range = (outer_radius - inner_radius) * 0.5;
 
-	for(unsigned int v = 0; v < model.getVertexCount(); v++)
+	// calculate the noise for all vertexes at once
+	unsigned int vertex_count = model.getVertexCount();
+	std::vector<float> v_x(vertex_count);
+	std::vector<float> v_y(vertex_count);
+	std::vector<float> v_z(vertex_count);
+	std::vector<float> v_noise(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		Vector3 offset_vertex = model.getVertexPosition(v) + random_noise_offset;
+		v_x[v] = (float)(offset_vertex.x);
+		v_y[v] = (float)(offset_vertex.y);
+		v_z[v] = (float)(offset_vertex.z);
+	}
+	NOISE.perlinNoise(vertex_count, v_x.data(), v_y.data(), v_z.data(), v_noise.data());
+
+	for(unsigned int v = 0; v < vertex_count; v++)
 	{
 		const Vector3& old_vertex = model.getVertexPosition(v);
 		assert(!old_vertex.isZero());
 		//assert(old_vertex.isUnit());  // tolerances are too tight, so skip
 
-		Vector3 offset_vertex = old_vertex + random_noise_offset;
-		double noise = NOISE.perlinNoise((float)(offset_vertex.x),
-		                                 (float)(offset_vertex.y),
-		                                 (float)(offset_vertex.z));
+		double noise = v_noise[v];
 		assert(noise >= -1.0);
 		assert(noise <=  1.0);
 
@@ -95,8 +116,19 @@ ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjMode
 	}
 
 	// don't check invariant in helper function
-	return model.getDisplayList();
+	return model;
+}
+
+ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
+                                                       double inner_radius,
+                                                       double outer_radius,
+                                                       ObjLibrary::Vector3 random_noise_offset)
+{
+	assert(isUnitSphere(base_model));
+
+	return createModel(base_model, inner_radius, outer_radius, random_noise_offset).getDisplayList();
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
@@ -104,14 +136,15 @@ Asteroid :: Asteroid ()
 		: Entity()
 		, m_inner_radius(0.0)
 		, m_random_noise_offset()
-		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
-		, m_rotation_rate(0.0)
 		, m_is_crystals(false)
+		, m_radius_map()
+		, mv_lower_detail_display_lists()
 {
 	assert(!isInitialized());
 	assert(invariant());
 }
 
+#ifndef GAME_HEADLESS
 static Vector3 g_noise_offset;  // to copy value out of parameter into member field initialized after
 Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
                       const ObjLibrary::Vector3& velocity,
@@ -129,21 +162,43 @@ Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
 		         1.0)
 		, m_inner_radius(inner_radius)
 		, m_random_noise_offset(g_noise_offset)  // copy from value set above
-		, m_rotation_axis(Vector3::getRandomUnitVector())
-		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
 		, m_is_crystals(true)
+		, m_radius_map()
+		, mv_lower_detail_display_lists()
 {
 	assert(inner_radius >= 0.0);
 	assert(inner_radius <= outer_radius);
 	assert(isUnitSphere(base_model));
 
-	// rotate randomly
-	m_coords.rotateAroundForward(random01() * TWO_PI);
-	m_coords.rotateAroundUp     (random01() * TWO_PI);
-	m_coords.rotateAroundRight  (random01() * TWO_PI);
-	m_coords.rotateAroundForward(random01() * TWO_PI);
-	m_coords.rotateAroundUp     (random01() * TWO_PI);
-	m_coords.rotateAroundRight  (random01() * TWO_PI);
+	rotateRandomly();
+
+	assert(isInitialized());
+	assert(invariant());
+}
+#endif  // GAME_HEADLESS is not defined
+
+Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
+                      const ObjLibrary::Vector3& velocity,
+                      double inner_radius,
+                      double outer_radius,
+                      const ObjLibrary::DisplayList& display_list)
+		: Entity(position,
+		         velocity,
+		         calculateMass(inner_radius, outer_radius),
+		         outer_radius,
+		         display_list,
+		         1.0)
+		, m_inner_radius(inner_radius)
+		, m_random_noise_offset(Vector3::getRandomSphereVector() * NOISE_OFFSET_MAX)
+		, m_is_crystals(true)
+		, m_radius_map()
+		, mv_lower_detail_display_lists()
+{
+	assert(inner_radius >= 0.0);
+	assert(inner_radius <= outer_radius);
+	assert(display_list.isReady());
+
+	rotateRandomly();
 
 	assert(isInitialized());
 	assert(invariant());
@@ -158,49 +213,94 @@ double Asteroid :: getRadiusForDirection (const ObjLibrary::Vector3& direction)
 	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
 	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
 
-	Vector3 in_local = m_coords.worldToLocal(direction);
+	Vector3 in_local = getCoordinateSystem().worldToLocal(direction);
 	assert(in_local.isUnit());
-	Vector3 offset_vertex = in_local + m_random_noise_offset;
-	double noise = NOISE.perlinNoise((float)(offset_vertex.x),
-	                                 (float)(offset_vertex.y),
-	                                 (float)(offset_vertex.z));
+	double noise;
+	if(m_radius_map.isEmpty())
+		noise = calculateNoise(in_local);
+	else
+		noise = m_radius_map.getValue(in_local);
 
 	return radius_average + noise * radius_half_range;
 }
 
-void Asteroid :: drawAxes (double length) const
+void Asteroid :: getRadiiForDirections (unsigned int count,
+                                        const ObjLibrary::Vector3 a_directions[],
+                                        double a_radii[]) const
+{
+	assert(isInitialized());
+	assert(a_directions != nullptr || count == 0);
+	assert(a_radii      != nullptr || count == 0);
+
+	if(!m_radius_map.isEmpty())
+	{
+		// the table is already fast
+		for(unsigned int i = 0; i < count; i++)
+			a_radii[i] = getRadiusForDirection(a_directions[i]);
+		return;
+	}
+
+	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
+	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
+
+	std::vector<Vector3> v_local(count);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		assert(a_directions[i].isUnit());
+		v_local[i] = getCoordinateSystem().worldToLocal(a_directions[i]);
+		assert(v_local[i].isUnit());
+	}
+	std::vector<float> v_noise(count);
+	calculateNoise(count, v_local.data(), v_noise.data());
+
+	for(unsigned int i = 0; i < count; i++)
+		a_radii[i] = radius_average + v_noise[i] * radius_half_range;
+}
+
+const ObjLibrary::DisplayList& Asteroid :: getDetailDisplayList (unsigned int level) const
 {
 	assert(isInitialized());
+	assert(level < getDetailLevelCount());
+
+	if(level == 0)
+		return getDisplayList();
+	else
+		return mv_lower_detail_display_lists[level - 1];
+}
 
-	glPushMatrix();
-		m_coords.applyDrawTransformations();
-
-		glBegin(GL_LINES);
-			glColor3d(1.0, 0.0, 0.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(length, 0.0, 0.0);
-			glColor3d(0.0, 1.0, 0.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(0.0, length, 0.0);
-			glColor3d(0.0, 0.0, 1.0);
-			glVertex3d(0.0, 0.0, 0.0);
-			glVertex3d(0.0, 0.0, length);
-		glEnd();
-	glPopMatrix();
+#ifndef GAME_HEADLESS
+void Asteroid :: drawAxes (DebugDraw& r_debug_draw,
+                           double length) const
+{
+	assert(isInitialized());
+	assert(length >= 0.0);
+
+	// local X, Y, and Z axes
+	const CoordinateSystem& coords = getCoordinateSystem();
+	const Vector3& position = coords.getPosition();
+	r_debug_draw.addLine(position, position + coords.getForward() * length, Vector3(1.0, 0.0, 0.0));
+	r_debug_draw.addLine(position, position + coords.getUp()      * length, Vector3(0.0, 1.0, 0.0));
+	r_debug_draw.addLine(position, position + coords.getRight()   * length, Vector3(0.0, 0.0, 1.0));
 }
 
-void Asteroid :: drawSurfaceEquators () const
+void Asteroid :: drawSurfaceEquators (DebugDraw& r_debug_draw) const
 {
 	assert(isInitialized());
 
 	static const unsigned int MARKERS_PER_ARC = 10;
 
-	drawSurfaceMarker(Vector3::UNIT_X_PLUS,  Vector3(1.0, 0.0, 0.0));
-	drawSurfaceMarker(Vector3::UNIT_X_MINUS, Vector3(1.0, 0.0, 0.0));
-	drawSurfaceMarker(Vector3::UNIT_Y_PLUS,  Vector3(0.0, 1.0, 0.0));
-	drawSurfaceMarker(Vector3::UNIT_Y_MINUS, Vector3(0.0, 1.0, 0.0));
-	drawSurfaceMarker(Vector3::UNIT_Z_PLUS,  Vector3(0.0, 0.0, 1.0));
-	drawSurfaceMarker(Vector3::UNIT_Z_MINUS, Vector3(0.0, 0.0, 1.0));
+	// find all the marker directions first to get the radii at once
+	std::vector<Vector3> v_directions;
+	std::vector<Vector3> v_colours;
+	v_directions.push_back(Vector3::UNIT_X_PLUS);
+	v_directions.push_back(Vector3::UNIT_X_MINUS);
+	v_colours.insert(v_colours.end(), 2, Vector3(1.0, 0.0, 0.0));
+	v_directions.push_back(Vector3::UNIT_Y_PLUS);
+	v_directions.push_back(Vector3::UNIT_Y_MINUS);
+	v_colours.insert(v_colours.end(), 2, Vector3(0.0, 1.0, 0.0));
+	v_directions.push_back(Vector3::UNIT_Z_PLUS);
+	v_directions.push_back(Vector3::UNIT_Z_MINUS);
+	v_colours.insert(v_colours.end(), 2, Vector3(0.0, 0.0, 1.0));
 
 	for(unsigned int m = 1; m < MARKERS_PER_ARC; m++)
 	{
@@ -210,22 +310,30 @@ void Asteroid :: drawSurfaceEquators () const
 		double radians4 = radians3 + HALF_PI;
 		Vector3 colour(1.0, 1.0, ((m % 2 == 0) ? 0.0 : 1.0));
 
-		drawSurfaceMarker(Vector3::UNIT_X_PLUS.getRotatedY(radians1), colour);
-		drawSurfaceMarker(Vector3::UNIT_X_PLUS.getRotatedY(radians2), colour);
-		drawSurfaceMarker(Vector3::UNIT_X_PLUS.getRotatedY(radians3), colour);
-		drawSurfaceMarker(Vector3::UNIT_X_PLUS.getRotatedY(radians4), colour);
-
-		drawSurfaceMarker(Vector3::UNIT_Y_PLUS.getRotatedZ(radians1), colour);
-		drawSurfaceMarker(Vector3::UNIT_Y_PLUS.getRotatedZ(radians2), colour);
-		drawSurfaceMarker(Vector3::UNIT_Y_PLUS.getRotatedZ(radians3), colour);
-		drawSurfaceMarker(Vector3::UNIT_Y_PLUS.getRotatedZ(radians4), colour);
-
-		drawSurfaceMarker(Vector3::UNIT_Z_PLUS.getRotatedX(radians1), colour);
-		drawSurfaceMarker(Vector3::UNIT_Z_PLUS.getRotatedX(radians2), colour);
-		drawSurfaceMarker(Vector3::UNIT_Z_PLUS.getRotatedX(radians3), colour);
-		drawSurfaceMarker(Vector3::UNIT_Z_PLUS.getRotatedX(radians4), colour);
+		v_directions.push_back(Vector3::UNIT_X_PLUS.getRotatedY(radians1));
+		v_directions.push_back(Vector3::UNIT_X_PLUS.getRotatedY(radians2));
+		v_directions.push_back(Vector3::UNIT_X_PLUS.getRotatedY(radians3));
+		v_directions.push_back(Vector3::UNIT_X_PLUS.getRotatedY(radians4));
+
+		v_directions.push_back(Vector3::UNIT_Y_PLUS.getRotatedZ(radians1));
+		v_directions.push_back(Vector3::UNIT_Y_PLUS.getRotatedZ(radians2));
+		v_directions.push_back(Vector3::UNIT_Y_PLUS.getRotatedZ(radians3));
+		v_directions.push_back(Vector3::UNIT_Y_PLUS.getRotatedZ(radians4));
+
+		v_directions.push_back(Vector3::UNIT_Z_PLUS.getRotatedX(radians1));
+		v_directions.push_back(Vector3::UNIT_Z_PLUS.getRotatedX(radians2));
+		v_directions.push_back(Vector3::UNIT_Z_PLUS.getRotatedX(radians3));
+		v_directions.push_back(Vector3::UNIT_Z_PLUS.getRotatedX(radians4));
+		v_colours.insert(v_colours.end(), 12, colour);
 	}
+	assert(v_colours.size() == v_directions.size());
+
+	std::vector<double> v_radii(v_directions.size());
+	getRadiiForDirections(v_directions.size(), v_directions.data(), v_radii.data());
+	for(unsigned int i = 0; i < v_directions.size(); i++)
+		drawSurfaceMarker(r_debug_draw, v_directions[i], v_radii[i], v_colours[i]);
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
@@ -238,45 +346,99 @@ void Asteroid :: removeCrystals ()
 	assert(invariant());
 }
 
-void Asteroid :: updatePhysics (double delta_time,
-                                const Entity& black_hole)
+void Asteroid :: addLowerDetailDisplayList (const ObjLibrary::DisplayList& display_list)
+{
+	assert(display_list.isReady());
+
+	mv_lower_detail_display_lists.push_back(display_list);
+
+	assert(invariant());
+}
+
+void Asteroid :: setRadiusMapResolution (unsigned int resolution)
 {
 	assert(isInitialized());
-	assert(delta_time > 0.0);
 
-	Entity::updatePhysics(delta_time, black_hole);
+	if(resolution == m_radius_map.getResolution())
+		return;
 
-	double rotation_radians = m_rotation_rate * delta_time;
-	m_coords.rotateAroundArbitrary(m_rotation_axis, rotation_radians);
+	m_radius_map = OctahedralMap(resolution,
+	                             [this] (unsigned int count,
+	                                     const Vector3 a_directions[],
+	                                     float a_values[])
+	                             {  calculateNoise(count, a_directions, a_values);  });
 
 	assert(invariant());
 }
 
 
 
-void Asteroid :: drawSurfaceMarker (const ObjLibrary::Vector3& direction,
+double Asteroid :: calculateNoise (const ObjLibrary::Vector3& local_direction) const
+{
+	assert(local_direction.isUnit());
+
+	Vector3 offset_vertex = local_direction + m_random_noise_offset;
+	return NOISE.perlinNoise((float)(offset_vertex.x),
+	                         (float)(offset_vertex.y),
+	                         (float)(offset_vertex.z));
+}
+
+void Asteroid :: calculateNoise (unsigned int count,
+                                 const ObjLibrary::Vector3 a_local_directions[],
+                                 float a_noise[]) const
+{
+	assert(a_local_directions != nullptr || count == 0);
+	assert(a_noise            != nullptr || count == 0);
+
+	std::vector<float> v_x(count);
+	std::vector<float> v_y(count);
+	std::vector<float> v_z(count);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		assert(a_local_directions[i].isUnit());
+
+		Vector3 offset_vertex = a_local_directions[i] + m_random_noise_offset;
+		v_x[i] = (float)(offset_vertex.x);
+		v_y[i] = (float)(offset_vertex.y);
+		v_z[i] = (float)(offset_vertex.z);
+	}
+	NOISE.perlinNoise(count, v_x.data(), v_y.data(), v_z.data(), a_noise);
+}
+
+void Asteroid :: rotateRandomly ()
+{
+	assert(!isInBodies());
+
+	Vector3 rotation_axis = Vector3::getRandomUnitVector();
+	double  rotation_rate = std::min(random01(), random01()) * ROTATION_RATE_MAX;  // mostly rotate slowly
+	setRotation(rotation_axis, rotation_rate);
+
+	m_coords.rotateAroundForward(random01() * TWO_PI);
+	m_coords.rotateAroundUp     (random01() * TWO_PI);
+	m_coords.rotateAroundRight  (random01() * TWO_PI);
+	m_coords.rotateAroundForward(random01() * TWO_PI);
+	m_coords.rotateAroundUp     (random01() * TWO_PI);
+	m_coords.rotateAroundRight  (random01() * TWO_PI);
+}
+
+#ifndef GAME_HEADLESS
+void Asteroid :: drawSurfaceMarker (DebugDraw& r_debug_draw,
+                                    const ObjLibrary::Vector3& direction,
+                                    double radius,
                                     const ObjLibrary::Vector3& colour) const
 {
+	static const double MARKER_SIZE = 5.0;
+
 	assert(isInitialized());
 	assert(direction.isUnit());
 
-	const Vector3& position = getPosition();
-	double radius = getRadiusForDirection(direction);
-
-	glColor3d(colour.x, colour.y, colour.z);
-	glPushMatrix();
-		glTranslated(position.x, position.y, position.z);
-		glTranslated(direction.x * radius, direction.y * radius, direction.z * radius);
-		glScaled(5.0, 5.0, 5.0);
-		glutSolidOctahedron();
-	glPopMatrix();
+	r_debug_draw.addSolidMarker(getPosition() + direction * radius, MARKER_SIZE, colour);
 }
+#endif  // GAME_HEADLESS is not defined
 
 bool Asteroid :: invariant () const
 {
 	if(m_inner_radius < 0.0) return false;
 	if(m_inner_radius > getRadius()) return false;
-	if(!m_rotation_axis.isUnit()) return false;
-	if(m_rotation_rate < 0.0) return false;
 	return true;
 }
@@ -7,13 +7,18 @@
 #pragma once
 
 #include <cassert>
+#include <vector>
 
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
 
+#include "GameSettings.h"
 #include "CoordinateSystem.h"
 #include "Entity.h"
+#include "OctahedralMap.h"
+
+class DebugDraw;
 
 
 
@@ -34,15 +39,27 @@
 //    a higher-polygon sphere for the base model will produce a
 //    higher-polygon asteroid.
 //
+//  Lower-detail versions of the model can be added, made from
+//    lower-polygon base spheres with the same noise, so that
+//    distant asteroids can be drawn with fewer triangles but
+//    the same shape.  The display list set when the Asteroid is
+//    created is the full-detail level 0.
+//
+//  The surface radius can optionally be read from a table
+//    calculated when the radius map resolution is set, instead
+//    of calculating the noise for every direction.  This is
+//    much faster, but only approximates the true surface
+//    between the table entries.  A higher resolution is more
+//    accurate but uses more memory.
+//
 //  Class Invariant:
 //    <1> m_inner_radius >= 0.0
 //    <2> m_inner_radius <= getRadius()
-//    <3> m_rotation_axis.isUnit()
-//    <4> m_rotation_rate >= 0.0
 //
 class Asteroid : public Entity
 {
 public:
+#ifndef GAME_HEADLESS
 //
 //  Class Function: isUnitSphere
 //
@@ -57,6 +74,7 @@ public:
 //  Side Effect: N/A
 //
 	static bool isUnitSphere (const ObjLibrary::ObjModel& base_model);
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  Class Function: calculateMass
@@ -75,6 +93,31 @@ public:
 	static double calculateMass (double inner_radius,
 	                             double outer_radius);
 
+#ifndef GAME_HEADLESS
+//
+//  Class Function: createModel
+//
+//  Purpose: To create the model for an Asteroid.  This does
+//           not use OpenGL, so it can be called on any thread.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel that wil be modified to
+//                    produce the asteroid
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: A copy of base_model with the vertexes positioned
+//           based on Perlin noise and the inner and outer
+//           radii.
+//  Side Effect: N/A
+//
+	static ObjLibrary::ObjModel createModel (
+	                   const ObjLibrary::ObjModel& base_model,
+	                   double inner_radius,
+	                   double outer_radius,
+	                   const ObjLibrary::Vector3& random_noise_offset);
+
 //
 //  Class Function: createDisplayList
 //
@@ -87,9 +130,7 @@ public:
 //    <4> random_noise_offset: The offset for the Perlin noise
 //  Preconditions:
 //    <1> isUnitSphere(base_model)
-//  Returns: A DisplayList based on base_model.  The vertexes
-//           are positioned based on Perlin noise and the inner
-//           and outer radii.
+//  Returns: A DisplayList of the model createModel returns.
 //  Side Effect: N/A
 //
 	static ObjLibrary::DisplayList createDisplayList (
@@ -97,6 +138,7 @@ public:
 	                   double inner_radius,
 	                   double outer_radius,
 	                   ObjLibrary::Vector3 random_noise_offset);
+#endif  // GAME_HEADLESS is not defined
 
 public:
 //
@@ -111,6 +153,7 @@ public:
 //
 	Asteroid ();
 
+#ifndef GAME_HEADLESS
 //
 //  Constructor
 //
@@ -141,11 +184,70 @@ public:
 	          double inner_radius,
 	          double outer_radius,
 	          const ObjLibrary::ObjModel& base_model);
+#endif  // GAME_HEADLESS is not defined
+
+//
+//  Constructor
+//
+//  Purpose: To create a random asteroid with the specified
+//           position, inner and out radii, and DisplayList.
+//  Parameter(s):
+//    <1> position: The position of the asteroid origin
+//    <2> velocity: The velocity of the asteroid
+//    <3> inner_radius: The inner asteroid radius
+//    <4> outer_radius: The outer asteroid radius
+//    <5> display_list: The DisplayList for this asteroid
+//  Preconditions: N/A
+//    <1> inner_radius >= 0.0
+//    <2> inner_radius <= outer_radius
+//    <3> display_list.isReady()
+//  Returns: N/A
+//  Side Effect: A new Asteroid is created at position position
+//               with velocity velocity.  It has the same random
+//               surface, orientation, and rotational velocity
+//               that the base model constructor would have
+//               chosen, but it is displayed with display_list
+//               unchanged.  This is intended for the headless
+//               simulation, where there are no real models.
+//
+	Asteroid (const ObjLibrary::Vector3& position,
+	          const ObjLibrary::Vector3& velocity,
+	          double inner_radius,
+	          double outer_radius,
+	          const ObjLibrary::DisplayList& display_list);
 
 	Asteroid (const Asteroid& to_copy) = default;
 	~Asteroid () = default;
 	Asteroid& operator= (const Asteroid& to_copy) = default;
 
+//
+//  getInnerRadius
+//
+//  Purpose: To determine the inner radius of this Asteroid.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The inner radius.  No part of the surface is closer
+//           to the Asteroid origin than this.
+//  Side Effect: N/A
+//
+	double getInnerRadius () const
+	{  return m_inner_radius;  }
+
+//
+//  getNoiseOffset
+//
+//  Purpose: To determine where in the Perlin noise field the
+//           surface of this Asteroid comes from.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The random noise offset, as passed to createModel.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getNoiseOffset () const
+	{  return m_random_noise_offset;  }
+
 //
 //  getRadiusForDirection
 //
@@ -165,6 +267,33 @@ public:
 	double getRadiusForDirection (
 	                const ObjLibrary::Vector3& direction) const;
 
+//
+//  getRadiiForDirections
+//
+//  Purpose: To determine the surface radius of this Asteroid in
+//           each of the specified directions.  The directions
+//           are specified in world space coordinates from the
+//           Asteroid origin.  This is faster than calling
+//           getRadiusForDirection for each direction if there
+//           is no surface radius table.
+//  Parameter(s):
+//    <1> count: The number of directions
+//    <2> a_directions: An array of the directions to measure
+//                      the surface in
+//    <3> a_radii: An array to store the radii in
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> a_directions[i].isUnit() for all i < count
+//  Returns: N/A
+//  Side Effect: a_radii[i] is set to the distance from the
+//               Asteroid origin to its surface in direction
+//               a_directions[i], for all i < count.
+//
+	void getRadiiForDirections (
+	                unsigned int count,
+	                const ObjLibrary::Vector3 a_directions[],
+	                double a_radii[]) const;
+
 //
 //  isCrystals
 //
@@ -184,21 +313,83 @@ public:
 		return m_is_crystals;
 	}
 
+//
+//  getRadiusMapResolution
+//
+//  Purpose: To determine how finely the surface radius table
+//           for this Asteroid divides the directions.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The resolution of the surface radius table, or 0 if
+//           there is no table.
+//  Side Effect: N/A
+//
+	unsigned int getRadiusMapResolution () const
+	{  return m_radius_map.getResolution();  }
+
+//
+//  getRadiusMapMemorySize
+//
+//  Purpose: To determine how much memory the surface radius
+//           table for this Asteroid uses.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The size of the surface radius table in bytes.
+//  Side Effect: N/A
+//
+	unsigned int getRadiusMapMemorySize () const
+	{  return m_radius_map.getMemorySize();  }
+
+//
+//  getDetailLevelCount
+//
+//  Purpose: To determine how many levels of detail this
+//           Asteroid can be drawn at.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of levels of detail.  Level 0 is the
+//           display list for this Asteroid, and each level
+//           after it was added with addLowerDetailDisplayList.
+//  Side Effect: N/A
+//
+	unsigned int getDetailLevelCount () const
+	{  return 1 + mv_lower_detail_display_lists.size();  }
+
+//
+//  getDetailDisplayList
+//
+//  Purpose: To retrieve the display list for the specified
+//           level of detail.
+//  Parameter(s):
+//    <1> level: The level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> level < getDetailLevelCount()
+//  Returns: The DisplayList for level level.  Level 0 is the
+//           same as getDisplayList.
+//  Side Effect: N/A
+//
+	const ObjLibrary::DisplayList& getDetailDisplayList (
+	                                   unsigned int level) const;
+
+#ifndef GAME_HEADLESS
 //
 //  drawAxes
 //
 //  Purpose: To display the XYZ axes of the local coordinate
 //           system for this Asteroid.
 //  Parameter(s):
-//    <1> length: The length of the axes
+//    <1> r_debug_draw: The DebugDraw to add the axes to
+//    <2> length: The length of the axes
 //  Preconditions:
 //    <1> isInitialized()
 //    <2> length >= 0.0
 //  Returns: N/A
-//  Side Effect: The current orientation of this Asteroid is
-//               displayed.
+//  Side Effect: Lines showing the current orientation of this
+//               Asteroid are added to r_debug_draw.
 //
-	void drawAxes (double length) const;
+	void drawAxes (DebugDraw& r_debug_draw,
+	               double length) const;
 
 //
 //  drawSurfaceEquators
@@ -207,14 +398,16 @@ public:
 //           to the surface of this Asteroid along the XY, YZ,
 //           and ZX planes.  The planes are aligned in world
 //           coordinates.
-//  Parameter(s): N/A
+//  Parameter(s):
+//    <1> r_debug_draw: The DebugDraw to add the markers to
 //  Preconditions:
 //    <1> isInitialized()
 //  Returns: N/A
-//  Side Effect: Markers are displayed showing the collision
-//               surface of this Asteroid.
+//  Side Effect: Markers showing the collision surface of this
+//               Asteroid are added to r_debug_draw.
 //
-	void drawSurfaceEquators () const;
+	void drawSurfaceEquators (DebugDraw& r_debug_draw) const;
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  removeCrystals
@@ -230,45 +423,122 @@ public:
 	void removeCrystals ();
 
 //
-//  updatePhysics
+//  addLowerDetailDisplayList
 //
-//  Purpose: To perform the physics updates for this Entity
-//           for one time step.
+//  Purpose: To add another level of detail to this Asteroid.
 //  Parameter(s):
-//    <1> delta_time: The length of the time step in seconds
-//    <2> black_hole: The black hole
+//    <1> display_list: The DisplayList for the new level
+//  Preconditions:
+//    <1> display_list.isReady()
+//  Returns: N/A
+//  Side Effect: A new level of detail is added after the
+//               existing ones.  It is drawn with display_list,
+//               which should have fewer triangles than the
+//               level before.
+//
+	void addLowerDetailDisplayList (
+	                   const ObjLibrary::DisplayList& display_list);
+
+//
+//  setRadiusMapResolution
+//
+//  Purpose: To change how getRadiusForDirection finds the
+//           surface of this Asteroid.
+//  Parameter(s):
+//    <1> resolution: The resolution for the surface radius
+//                    table, or 0 for none
 //  Preconditions:
 //    <1> isInitialized()
-//    <2> delta_time > 0.0
 //  Returns: N/A
-//  Side Effect: This Entity is updated for one time step.  This
-//               includes rotation.
+//  Side Effect: If resolution is 0, any surface radius table is
+//               removed and the noise is calculated for every
+//               direction.  Otherwise, a new surface radius
+//               table with resolution cells along each side is
+//               calculated and used from now on.
 //
-	virtual void updatePhysics (double delta_time,
-	                            const Entity& black_hole);
+	void setRadiusMapResolution (unsigned int resolution);
 
 private:
 //
+//  calculateNoise
+//
+//  Purpose: To calculate the noise value that determines the
+//           surface radius of this Asteroid in the specified
+//           direction.
+//  Parameter(s):
+//    <1> local_direction: The direction in local coordinates
+//  Preconditions:
+//    <1> local_direction.isUnit()
+//  Returns: The noise value in direction local_direction.  This
+//           is in the range [-1, 1].
+//  Side Effect: N/A
+//
+	double calculateNoise (
+	            const ObjLibrary::Vector3& local_direction) const;
+
+//
+//  calculateNoise
+//
+//  Purpose: To calculate the noise values for the specified
+//           directions at once.
+//  Parameter(s):
+//    <1> count: The number of directions
+//    <2> a_local_directions: An array of the directions in
+//                            local coordinates
+//    <3> a_noise: An array to store the noise values in
+//  Preconditions:
+//    <1> a_local_directions[i].isUnit() for all i < count
+//  Returns: N/A
+//  Side Effect: a_noise[i] is set to the noise value in
+//               direction a_local_directions[i], for all
+//               i < count.  These are the same values as
+//               calculateNoise returns for each direction.
+//
+	void calculateNoise (
+	            unsigned int count,
+	            const ObjLibrary::Vector3 a_local_directions[],
+	            float a_noise[]) const;
+
+//
+//  rotateRandomly
+//
+//  Purpose: To rotate this Asteroid to a random orientation and
+//           give it a random rotation rate.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This Asteroid is rotated randomly and set to
+//               rotate around a random axis.
+//
+	void rotateRandomly ();
+
+#ifndef GAME_HEADLESS
+//
 //  drawSurfaceMarker
 //
 //  Purpose: To display a markers showing the distance to the
 //           surface of this Asteroid in the specified
 //           direction.
 //  Parameter(s):
-//    <1> direction: The direction to the marker in world
+//    <1> r_debug_draw: The DebugDraw to add the marker to
+//    <2> direction: The direction to the marker in world
 //                   coordinates
-//    <2> colour: The marker colour
+//    <3> radius: The surface radius in direction direction
+//    <4> colour: The marker colour
 //  Preconditions:
 //    <1> isInitialized()
 //    <2> direction.isUnit()
 //  Returns: N/A
-//  Side Effect: A marker is displayed showing the distance to
-//               the collision surface of this Asteroid in
-//               direction direction.
+//  Side Effect: A marker at distance radius from the center of
+//               this Asteroid in direction direction is added
+//               to r_debug_draw.
 //
 	void drawSurfaceMarker (
+	                   DebugDraw& r_debug_draw,
 	                   const ObjLibrary::Vector3& direction,
+	                   double radius,
 	                   const ObjLibrary::Vector3& colour) const;
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  invariant
@@ -284,9 +554,9 @@ private:
 private:
 	double m_inner_radius;
 	ObjLibrary::Vector3 m_random_noise_offset;
-	ObjLibrary::Vector3 m_rotation_axis;
-	double m_rotation_rate;
 	bool m_is_crystals;
+	OctahedralMap m_radius_map;  // noise values
+	std::vector<ObjLibrary::DisplayList> mv_lower_detail_display_lists;  // levels 1+
 };
 
 
@@ -0,0 +1,123 @@
+//
+//  AvoidCheck.cpp
+//
+//  A program to check that Game::findAsteroidsToAvoid finds the
+//    same asteroids, in the same order, as testing every
+//    asteroid.  Spaceships with random positions and velocities
+//    near the asteroids are checked at several times while the
+//    game runs.
+//
+//  Usage: avoid_check
+//
+
+#include <cstdlib>  // for rand
+#include <iostream>
+#include <vector>
+#include <utility>  // for pair
+#include <algorithm>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "Asteroid.h"
+#include "Spaceship.h"
+#include "SteeringBehaviours.h"
+#include "Game.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+namespace
+{
+	const double DELTA_TIME = 0.5;
+	const unsigned int CHECK_COUNT = 10;
+	const unsigned int TICKS_PER_CHECK = 50;
+	const unsigned int AGENTS_PER_CHECK = 500;
+
+	const double AGENT_SPREAD = 1000.0;
+	const double AGENT_SPEED_MAX = 1000.0;
+	const double AGENT_MASS = 1.0;
+	const double AGENT_RADIUS = 10.0;
+	const double AGENT_ROTATION_RATE = 1.0;
+	const double ACCELERATIONS[] = { 25.0, 50.0 };  // same as the drones and the player
+	const unsigned int ACCELERATION_COUNT = sizeof(ACCELERATIONS) / sizeof(ACCELERATIONS[0]);
+
+	double random0to1 ()
+	{
+		return rand() / (double)(RAND_MAX);
+	}
+
+	Vector3 randomVector (double size)
+	{
+		return Vector3((random0to1() * 2.0 - 1.0) * size,
+		               (random0to1() * 2.0 - 1.0) * size,
+		               (random0to1() * 2.0 - 1.0) * size);
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	DisplayList display_list;
+	display_list.begin();
+	display_list.end();
+
+	Game::loadModels("Models/");
+	Game game(1);
+
+	vector<unsigned int> v_found;
+	vector<pair<double, unsigned int> > v_times;
+	unsigned int avoid_count = 0;
+	for(unsigned int check = 0; check < CHECK_COUNT; check++)
+	{
+		for(unsigned int t = 0; t < TICKS_PER_CHECK; t++)
+			game.update(DELTA_TIME);
+
+		for(unsigned int i = 0; i < AGENTS_PER_CHECK; i++)
+		{
+			const Asteroid& near = game.getAsteroid(rand() % game.getAsteroidCount());
+			Spaceship agent(near.getPosition() + randomVector(AGENT_SPREAD),
+			                near.getVelocity() + randomVector(AGENT_SPEED_MAX),
+			                AGENT_MASS, AGENT_RADIUS,
+			                ACCELERATIONS[0], ACCELERATIONS[0], AGENT_ROTATION_RATE,
+			                display_list, Vector3::ZERO);
+			double max_acceleration = ACCELERATIONS[i % ACCELERATION_COUNT];
+
+			game.findAsteroidsToAvoid(agent, max_acceleration, v_found);
+
+			// nearest first by time to closest approach, and then by index
+			v_times.clear();
+			for(unsigned int a = 0; a < game.getAsteroidCount(); a++)
+			{
+				const Asteroid& asteroid = game.getAsteroid(a);
+				if(SteeringBehaviours::isAvoid(agent, asteroid, max_acceleration))
+					v_times.push_back(make_pair(SteeringBehaviours::getClosestApproachTime(agent, asteroid), a));
+			}
+			sort(v_times.begin(), v_times.end());
+
+			bool is_match = v_found.size() == v_times.size();
+			for(unsigned int n = 0; is_match && n < v_found.size(); n++)
+				if(v_found[n] != v_times[n].second)
+					is_match = false;
+			if(!is_match)
+			{
+				cerr << "Found " << v_found.size() << " asteroids to avoid instead of " << v_times.size()
+				     << ", or in a different order, at time " << game.getTime() << " for a spaceship at "
+				     << agent.getPosition() << endl;
+				return 1;
+			}
+			avoid_count += v_found.size();
+		}
+	}
+
+	// otherwise, nothing was checked
+	if(avoid_count == 0)
+	{
+		cerr << "No spaceships had asteroids to avoid" << endl;
+		return 1;
+	}
+
+	cout << "Avoid check passed (" << avoid_count << " asteroids to avoid found)" << endl;
+	return 0;
+}
@@ -6,7 +6,10 @@
 
 #include <cassert>
 
-#include "GetGlut.h"
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+#endif
 
 #include "ObjLibrary/Vector3.h"
 
@@ -42,6 +45,7 @@ BlackHole :: BlackHole (const ObjLibrary::Vector3& position,
 
 
 
+#ifndef GAME_HEADLESS
 void BlackHole :: draw () const
 {
 	assert(isInitialized());
@@ -55,4 +59,5 @@ void BlackHole :: draw () const
 	// draw accretion disk - has to be last because of transparency
 	Entity::draw();
 }
+#endif  // GAME_HEADLESS is not defined
 
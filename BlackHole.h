@@ -9,6 +9,7 @@
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
+#include "GameSettings.h"
 #include "CoordinateSystem.h"
 #include "Entity.h"
 
@@ -65,6 +66,7 @@ public:
 	~BlackHole () = default;
 	BlackHole& operator= (const BlackHole& to_copy) = default;
 
+#ifndef GAME_HEADLESS
 //
 //  draw
 //
@@ -76,6 +78,7 @@ public:
 //               position with its current rotation.
 //
 	virtual void draw () const;
+#endif  // GAME_HEADLESS is not defined
 
 private:
 	double m_disk_radius;
@@ -0,0 +1,256 @@
+//
+//  BroadPhase.cpp
+//
+
+#include "BroadPhase.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>  // for sort
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	double getComponent (const Vector3& vector, unsigned int axis)
+	{
+		assert(axis < 3);
+
+		switch(axis)
+		{
+		case 0:  return vector.x;
+		case 1:  return vector.y;
+		default: return vector.z;
+		}
+	}
+
+	bool isPairLess (const BroadPhase::Pair& pair1,
+	                 const BroadPhase::Pair& pair2)
+	{
+		if(pair1.m_group1 != pair2.m_group1)
+			return pair1.m_group1 < pair2.m_group1;
+		if(pair1.m_index1 != pair2.m_index1)
+			return pair1.m_index1 < pair2.m_index1;
+		if(pair1.m_group2 != pair2.m_group2)
+			return pair1.m_group2 < pair2.m_group2;
+		return pair1.m_index2 < pair2.m_index2;
+	}
+
+}  // end of anonymous namespace
+
+
+
+const unsigned int BroadPhase :: GROUP_COUNT_MAX;  // value is set in header file
+
+
+
+BroadPhase :: BroadPhase ()
+		: mv_spheres()
+		, mv_pairs()
+{
+	for(unsigned int g = 0; g < GROUP_COUNT_MAX; g++)
+	{
+		ma_interact_masks[g] = 0;
+		ma_group_sizes[g]    = 0;
+	}
+
+	assert(invariant());
+}
+
+
+
+bool BroadPhase :: isGroupsInteract (unsigned int group1,
+                                     unsigned int group2) const
+{
+	assert(group1 < GROUP_COUNT_MAX);
+	assert(group2 < GROUP_COUNT_MAX);
+
+	return (ma_interact_masks[group1] & (1u << group2)) != 0;
+}
+
+unsigned long long BroadPhase :: getPossiblePairCount () const
+{
+	unsigned long long count = 0;
+	for(unsigned int g1 = 0; g1 < GROUP_COUNT_MAX; g1++)
+	{
+		unsigned long long size1 = ma_group_sizes[g1];
+		if(isGroupsInteract(g1, g1) && size1 > 1)
+			count += size1 * (size1 - 1) / 2;
+
+		for(unsigned int g2 = g1 + 1; g2 < GROUP_COUNT_MAX; g2++)
+			if(isGroupsInteract(g1, g2))
+				count += size1 * ma_group_sizes[g2];
+	}
+	return count;
+}
+
+const BroadPhase::Pair& BroadPhase :: getPair (unsigned int index) const
+{
+	assert(index < getPairCount());
+
+	return mv_pairs[index];
+}
+
+
+
+void BroadPhase :: setGroupsInteract (unsigned int group1,
+                                      unsigned int group2)
+{
+	assert(group1 < GROUP_COUNT_MAX);
+	assert(group2 < GROUP_COUNT_MAX);
+
+	ma_interact_masks[group1] |= 1u << group2;
+	ma_interact_masks[group2] |= 1u << group1;
+
+	assert(invariant());
+}
+
+void BroadPhase :: clear ()
+{
+	mv_spheres.clear();
+	mv_pairs.clear();
+	for(unsigned int g = 0; g < GROUP_COUNT_MAX; g++)
+		ma_group_sizes[g] = 0;
+
+	assert(invariant());
+}
+
+void BroadPhase :: addSphere (unsigned int group,
+                              unsigned int index,
+                              const ObjLibrary::Vector3& center,
+                              double radius)
+{
+	assert(group < GROUP_COUNT_MAX);
+	assert(radius >= 0.0);
+
+	Sphere sphere;
+	sphere.m_center = center;
+	sphere.m_radius = radius;
+	sphere.m_min    = 0.0;  // set in findPairs
+	sphere.m_max    = 0.0;
+	sphere.m_group  = group;
+	sphere.m_index  = index;
+	mv_spheres.push_back(sphere);
+	ma_group_sizes[group]++;
+
+	assert(invariant());
+}
+
+void BroadPhase :: addSweptSphere (unsigned int group,
+                                   unsigned int index,
+                                   const ObjLibrary::Vector3& start,
+                                   const ObjLibrary::Vector3& end,
+                                   double radius)
+{
+	assert(group < GROUP_COUNT_MAX);
+	assert(radius >= 0.0);
+
+	addSphere(group, index, (start + end) * 0.5, radius + start.getDistance(end) * 0.5);
+
+	assert(invariant());
+}
+
+void BroadPhase :: findPairs ()
+{
+	mv_pairs.clear();
+
+	unsigned int axis = chooseSweepAxis();
+	for(unsigned int s = 0; s < mv_spheres.size(); s++)
+	{
+		Sphere& sphere = mv_spheres[s];
+		double center = getComponent(sphere.m_center, axis);
+		sphere.m_min = center - sphere.m_radius;
+		sphere.m_max = center + sphere.m_radius;
+	}
+
+	sort(mv_spheres.begin(), mv_spheres.end(),
+	     [] (const Sphere& sphere1, const Sphere& sphere2)
+	     {  return sphere1.m_min < sphere2.m_min;  });
+
+	for(unsigned int s1 = 0; s1 < mv_spheres.size(); s1++)
+	{
+		const Sphere& sphere1 = mv_spheres[s1];
+		for(unsigned int s2 = s1 + 1; s2 < mv_spheres.size() &&
+		                              mv_spheres[s2].m_min <= sphere1.m_max; s2++)
+		{
+			const Sphere& sphere2 = mv_spheres[s2];
+			if(!isGroupsInteract(sphere1.m_group, sphere2.m_group))
+				continue;
+
+			// sweep axis already overlaps, so check the box on the others
+			double radius_sum = sphere1.m_radius + sphere2.m_radius;
+			Vector3 difference = sphere1.m_center - sphere2.m_center;
+			if(fabs(difference.x) > radius_sum ||
+			   fabs(difference.y) > radius_sum ||
+			   fabs(difference.z) > radius_sum)
+				continue;
+
+			Pair pair;
+			if(sphere1.m_group <  sphere2.m_group ||
+			  (sphere1.m_group == sphere2.m_group && sphere1.m_index < sphere2.m_index))
+			{
+				pair.m_group1 = sphere1.m_group;
+				pair.m_index1 = sphere1.m_index;
+				pair.m_group2 = sphere2.m_group;
+				pair.m_index2 = sphere2.m_index;
+			}
+			else
+			{
+				pair.m_group1 = sphere2.m_group;
+				pair.m_index1 = sphere2.m_index;
+				pair.m_group2 = sphere1.m_group;
+				pair.m_index2 = sphere1.m_index;
+			}
+			mv_pairs.push_back(pair);
+		}
+	}
+
+	// make order independent of positions
+	sort(mv_pairs.begin(), mv_pairs.end(), isPairLess);
+
+	assert(invariant());
+}
+
+
+
+unsigned int BroadPhase :: chooseSweepAxis () const
+{
+	if(mv_spheres.empty())
+		return 0;
+
+	Vector3 sum;
+	Vector3 sum_squares;
+	for(unsigned int s = 0; s < mv_spheres.size(); s++)
+	{
+		const Vector3& center = mv_spheres[s].m_center;
+		sum += center;
+		sum_squares += Vector3(center.x * center.x,
+		                       center.y * center.y,
+		                       center.z * center.z);
+	}
+
+	// compare n^2 * variance to avoid dividing
+	double count = (double)(mv_spheres.size());
+	double spread_x = sum_squares.x * count - sum.x * sum.x;
+	double spread_y = sum_squares.y * count - sum.y * sum.y;
+	double spread_z = sum_squares.z * count - sum.z * sum.z;
+
+	if(spread_x >= spread_y && spread_x >= spread_z)
+		return 0;
+	else if(spread_y >= spread_z)
+		return 1;
+	else
+		return 2;
+}
+
+bool BroadPhase :: invariant () const
+{
+	unsigned int total = 0;
+	for(unsigned int g = 0; g < GROUP_COUNT_MAX; g++)
+		total += ma_group_sizes[g];
+	if(total != mv_spheres.size()) return false;
+	return true;
+}
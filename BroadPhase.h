@@ -0,0 +1,293 @@
+//
+//  BroadPhase.h
+//
+//  A module to find pairs of spheres that might collide.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  BroadPhase
+//
+//  A class to find the pairs of bounding spheres that might
+//    overlap, so that the (more expensive) exact collision
+//    tests only need to be run for those pairs.  This is done
+//    with sweep-and-prune along a single axis.
+//
+//  Each sphere belongs to a group and has an index within that
+//    group, chosen by the caller.  Pairs are only reported for
+//    groups that have been marked as interacting.  To use a
+//    BroadPhase:
+//      <1> Mark which groups interact with setGroupsInteract
+//      <2> Every time step, call clear(), then addSphere for
+//          every sphere, then findPairs()
+//      <3> Check the candidate pairs from getPair
+//
+//  Every pair is reported with the lower group first, or the
+//    lower index first if the groups are the same.  The pairs
+//    are sorted by group and index, so the order does not
+//    depend on the order the spheres were added in or where
+//    they are.
+//
+//  Class Invariant:
+//    <1> mv_spheres.size() == sum of ma_group_sizes
+//
+class BroadPhase
+{
+public:
+//
+//  GROUP_COUNT_MAX
+//
+//  The maximum number of groups of spheres.
+//
+	static const unsigned int GROUP_COUNT_MAX = 32;
+
+//
+//  Pair
+//
+//  A record to store a candidate pair of spheres.  Each sphere
+//    is identified by its group and its index in that group.
+//
+	struct Pair
+	{
+		unsigned int m_group1;
+		unsigned int m_index1;
+		unsigned int m_group2;
+		unsigned int m_index2;
+	};
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a BroadPhase with no spheres and no
+//           interacting groups.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new BroadPhase is created.
+//
+	BroadPhase ();
+
+	BroadPhase (const BroadPhase& to_copy) = default;
+	~BroadPhase () = default;
+	BroadPhase& operator= (const BroadPhase& to_copy) = default;
+
+//
+//  isGroupsInteract
+//
+//  Purpose: To determine whether pairs are reported between
+//           the specified groups.
+//  Parameter(s):
+//    <1> group1: The first group
+//    <2> group2: The second group
+//  Preconditions:
+//    <1> group1 < GROUP_COUNT_MAX
+//    <2> group2 < GROUP_COUNT_MAX
+//  Returns: Whether spheres in group group1 can form pairs with
+//           spheres in group group2.
+//  Side Effect: N/A
+//
+	bool isGroupsInteract (unsigned int group1,
+	                       unsigned int group2) const;
+
+//
+//  getSphereCount
+//
+//  Purpose: To determine how many spheres have been added since
+//           the last call to clear().
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of spheres.
+//  Side Effect: N/A
+//
+	unsigned int getSphereCount () const
+	{  return mv_spheres.size();  }
+
+//
+//  getPossiblePairCount
+//
+//  Purpose: To determine how many pairs would have to be
+//           checked without this BroadPhase.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of pairs of spheres in interacting
+//           groups.
+//  Side Effect: N/A
+//
+	unsigned long long getPossiblePairCount () const;
+
+//
+//  getPairCount
+//
+//  Purpose: To determine how many candidate pairs were found by
+//           the last call to findPairs().
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of candidate pairs.
+//  Side Effect: N/A
+//
+	unsigned int getPairCount () const
+	{  return mv_pairs.size();  }
+
+//
+//  getPair
+//
+//  Purpose: To retrieve the specified candidate pair.
+//  Parameter(s):
+//    <1> index: Which pair
+//  Preconditions:
+//    <1> index < getPairCount()
+//  Returns: Candidate pair index.  The bounding boxes of the two
+//           spheres overlap.
+//  Side Effect: N/A
+//
+	const Pair& getPair (unsigned int index) const;
+
+//
+//  setGroupsInteract
+//
+//  Purpose: To mark the specified groups as interacting.
+//  Parameter(s):
+//    <1> group1: The first group
+//    <2> group2: The second group
+//  Preconditions:
+//    <1> group1 < GROUP_COUNT_MAX
+//    <2> group2 < GROUP_COUNT_MAX
+//  Returns: N/A
+//  Side Effect: Candidate pairs will be reported between
+//               spheres in group group1 and spheres in group
+//               group2.  If group1 == group2, pairs will be
+//               reported within that group.
+//
+	void setGroupsInteract (unsigned int group1,
+	                        unsigned int group2);
+
+//
+//  clear
+//
+//  Purpose: To remove all spheres and candidate pairs.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This BroadPhase is emptied.  Which groups
+//               interact is not changed.
+//
+	void clear ();
+
+//
+//  addSphere
+//
+//  Purpose: To add a sphere to this BroadPhase.
+//  Parameter(s):
+//    <1> group: The group for the sphere
+//    <2> index: The index of the sphere in its group
+//    <3> center: The sphere center
+//    <4> radius: The sphere radius
+//  Preconditions:
+//    <1> group < GROUP_COUNT_MAX
+//    <2> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: The sphere is added to this BroadPhase.  It
+//               will be checked on the next call to
+//               findPairs().
+//
+	void addSphere (unsigned int group,
+	                unsigned int index,
+	                const ObjLibrary::Vector3& center,
+	                double radius);
+
+//
+//  addSweptSphere
+//
+//  Purpose: To add a sphere that moved during the last time
+//           step to this BroadPhase.
+//  Parameter(s):
+//    <1> group: The group for the sphere
+//    <2> index: The index of the sphere in its group
+//    <3> start: The sphere center at the start of the step
+//    <4> end: The sphere center at the end of the step
+//    <5> radius: The sphere radius
+//  Preconditions:
+//    <1> group < GROUP_COUNT_MAX
+//    <2> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: A sphere containing everywhere the sphere was
+//               during the step is added to this BroadPhase,
+//               so pairs that only touched partway through the
+//               step are still found.
+//
+	void addSweptSphere (unsigned int group,
+	                     unsigned int index,
+	                     const ObjLibrary::Vector3& start,
+	                     const ObjLibrary::Vector3& end,
+	                     double radius);
+
+//
+//  findPairs
+//
+//  Purpose: To find all candidate pairs among the current
+//           spheres.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The spheres are sorted along the axis they are
+//               most spread out along and swept to find all
+//               pairs in interacting groups with overlapping
+//               bounding boxes.  These replace any previous
+//               candidate pairs.
+//
+	void findPairs ();
+
+private:
+//
+//  Sphere
+//
+//  A record to store a sphere and its extent along the sweep
+//    axis.
+//
+	struct Sphere
+	{
+		ObjLibrary::Vector3 m_center;
+		double m_radius;
+		double m_min;
+		double m_max;
+		unsigned int m_group;
+		unsigned int m_index;
+	};
+
+//
+//  chooseSweepAxis
+//
+//  Purpose: To choose which axis to sweep along.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: 0, 1, or 2 for the X, Y, or Z axis.  This is the
+//           axis that the sphere centers vary the most along.
+//  Side Effect: N/A
+//
+	unsigned int chooseSweepAxis () const;
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int ma_interact_masks[GROUP_COUNT_MAX];
+	unsigned int ma_group_sizes[GROUP_COUNT_MAX];
+	std::vector<Sphere> mv_spheres;
+	std::vector<Pair> mv_pairs;
+};
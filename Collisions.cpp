@@ -7,6 +7,8 @@
 #include "Collisions.h"
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 
 #include "ObjLibrary/Vector3.h"
 
@@ -14,7 +16,105 @@
 #include "Entity.h"
 #include "Asteroid.h"
 
+using namespace std;
 using namespace ObjLibrary;
+namespace
+{
+	// for finding when something hits an Asteroid surface
+	const unsigned int SURFACE_SAMPLE_COUNT_MAX = 16;
+	const unsigned int SURFACE_BISECTION_STEPS  = 8;
+
+	//
+	//  calculateSphereOverlap
+	//
+	//  Purpose: To determine when a moving point is inside a
+	//           sphere centered at the origin during a time
+	//           step.
+	//  Parameter(s):
+	//    <1> start: The position of the point at the start of
+	//               the step
+	//    <2> velocity: The velocity of the point
+	//    <3> radius: The sphere radius
+	//    <4> delta_time: The length of the time step
+	//    <5> r_enter: A reference to a double to store the
+	//                 time the point enters the sphere in
+	//    <6> r_leave: A reference to a double to store the
+	//                 time the point leaves the sphere in
+	//  Preconditions:
+	//    <1> radius >= 0.0
+	//    <2> delta_time >= 0.0
+	//  Returns: Whether the point is inside the sphere at any
+	//           time during the step.
+	//  Side Effect: If the point is ever inside the sphere,
+	//               r_enter and r_leave are set to the first
+	//               and last times it is, in seconds after the
+	//               start of the step.
+	//
+	bool calculateSphereOverlap (const Vector3& start,
+	                             const Vector3& velocity,
+	                             double radius,
+	                             double delta_time,
+	                             double& r_enter,
+	                             double& r_leave)
+	{
+		assert(radius >= 0.0);
+		assert(delta_time >= 0.0);
+
+		// solve |start + velocity * t| = radius
+		double a = velocity.getNormSquared();
+		double b = start.dotProduct(velocity);
+		double c = start.getNormSquared() - radius * radius;
+
+		if(a == 0.0)
+		{
+			if(c > 0.0)
+				return false;
+			r_enter = 0.0;
+			r_leave = delta_time;
+			return true;
+		}
+
+		double discriminant = b * b - a * c;
+		if(discriminant < 0.0)
+			return false;  // misses
+
+		double root  = sqrt(discriminant);
+		double enter = (-b - root) / a;
+		double leave = (-b + root) / a;
+		if(leave < 0.0 || enter > delta_time)
+			return false;  // before or after the step
+
+		r_enter = max(enter, 0.0);
+		r_leave = min(leave, delta_time);
+		return true;
+	}
+
+	//
+	//  isTouchingSurface
+	//
+	//  Purpose: To determine if a sphere at the specified
+	//           offset from an Asteroid touches its surface.
+	//  Parameter(s):
+	//    <1> asteroid: The Asteroid
+	//    <2> offset: The sphere center relative to the
+	//                Asteroid origin
+	//    <3> radius: The sphere radius
+	//  Preconditions: N/A
+	//  Returns: Whether the sphere touches or is inside the
+	//           surface of Asteroid asteroid.
+	//  Side Effect: N/A
+	//
+	bool isTouchingSurface (const Asteroid& asteroid,
+	                        const Vector3& offset,
+	                        double radius)
+	{
+		if(offset.isZero())
+			return true;
+		double surface_radius = asteroid.getRadiusForDirection(offset.getNormalized());
+		return offset.isNormLessThan(surface_radius + radius);
+	}
+
+}  // end of anonymous namespace
 
 
 
@@ -49,6 +149,130 @@ bool Collisions :: isCollision (const Entity& entity,
 	return isCollision(asteroid, entity);
 }
 
+bool Collisions :: isCollisionDuring (const Entity& entity1,
+                                      const Entity& entity2,
+                                      double delta_time,
+                                      double& r_impact_time)
+{
+	assert(delta_time >= 0.0);
+
+	Vector3 relative_velocity = entity1.getVelocity() - entity2.getVelocity();
+	Vector3 start = entity1.getPosition() - entity2.getPosition() - relative_velocity * delta_time;
+	double radius_sum = entity1.getRadius() + entity2.getRadius();
+
+	double enter;
+	double leave;
+	if(calculateSphereOverlap(start, relative_velocity, radius_sum, delta_time, enter, leave))
+	{
+		r_impact_time = enter;
+		return true;
+	}
+	if(isCollision(entity1, entity2))
+	{
+		// missed because of rounding error
+		r_impact_time = delta_time;
+		return true;
+	}
+	return false;
+}
+
+bool Collisions :: isCollisionDuring (const Asteroid& asteroid,
+                                      const Entity& entity,
+                                      double delta_time,
+                                      double& r_impact_time)
+{
+	assert(delta_time >= 0.0);
+
+	Vector3 relative_velocity = entity.getVelocity() - asteroid.getVelocity();
+	Vector3 start = entity.getPosition() - asteroid.getPosition() - relative_velocity * delta_time;
+	double entity_radius = entity.getRadius();
+
+	// the surface is always between the inner and outer radii
+	double outer_enter;
+	double outer_leave;
+	if(!calculateSphereOverlap(start, relative_velocity, asteroid.getRadius() + entity_radius,
+	                           delta_time, outer_enter, outer_leave))
+	{
+		if(isCollision(asteroid, entity))
+		{
+			// missed because of rounding error
+			r_impact_time = delta_time;
+			return true;
+		}
+		return false;
+	}
+
+	double search_end = outer_leave;
+	double inner_enter;
+	double inner_leave;
+	bool is_inner = calculateSphereOverlap(start, relative_velocity, asteroid.getInnerRadius() + entity_radius,
+	                                       delta_time, inner_enter, inner_leave);
+	if(is_inner)
+		search_end = inner_enter;  // must be touching by then
+
+	//
+	//  Check the true shape at evenly-spaced times between
+	//    entering the outer radius and reaching the inner radius
+	//    (or leaving the outer radius).  The samples are at most
+	//    the Entity radius apart, so a small Entity cannot pass
+	//    through a bump, unless that would need more samples
+	//    than the maximum.
+	//
+
+	double search_length = search_end - outer_enter;
+	double distance = relative_velocity.getNorm() * search_length;
+	unsigned int sample_count = SURFACE_SAMPLE_COUNT_MAX;
+	if(distance < entity_radius * SURFACE_SAMPLE_COUNT_MAX)
+		sample_count = 1 + (unsigned int)(distance / entity_radius);
+
+	double outside_time = outer_enter;
+	double touching_time = -1.0;
+	for(unsigned int s = 0; s <= sample_count; s++)
+	{
+		double time = outer_enter + search_length * s / sample_count;
+		if(isTouchingSurface(asteroid, start + relative_velocity * time, entity_radius))
+		{
+			touching_time = time;
+			break;
+		}
+		outside_time = time;
+	}
+
+	if(touching_time < 0.0)
+	{
+		if(is_inner)
+			touching_time = search_end;  // missed because of rounding error
+		else if(isCollision(asteroid, entity))
+			touching_time = delta_time;  // same
+		else
+			return false;
+	}
+
+	// find the exact time with bisection
+	if(touching_time > outside_time)
+	{
+		for(unsigned int i = 0; i < SURFACE_BISECTION_STEPS; i++)
+		{
+			double middle = (outside_time + touching_time) * 0.5;
+			if(isTouchingSurface(asteroid, start + relative_velocity * middle, entity_radius))
+				touching_time = middle;
+			else
+				outside_time = middle;
+		}
+	}
+
+	r_impact_time = touching_time;
+	return true;
+}
+
+bool Collisions :: isCollisionDuring (const Entity& entity,
+                                      const Asteroid& asteroid,
+                                      double delta_time,
+                                      double& r_impact_time)
+{
+	return isCollisionDuring(asteroid, entity, delta_time, r_impact_time);
+}
+
 bool Collisions :: isCollision (const Asteroid& asteroid1,
                                 const Asteroid& asteroid2)
 {
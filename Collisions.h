@@ -59,6 +59,71 @@ bool isCollision (const Entity& entity,
 bool isCollision (const Asteroid& asteroid1,
                   const Asteroid& asteroid2);
 
+//
+//  isCollisionDuring
+//
+//  Purpose: To determine if the specified two Entitys collided
+//           at any time during the last time step, and when.
+//           The Entitys are assumed to have moved in straight
+//           lines at their current velocities during the step,
+//           ending at their current positions.  This function
+//           variant treats both Entitys as spheres.
+//  Parameter(s):
+//    <1> entity1: The first Entity
+//    <2> entity2: The second Entity
+//    <3> delta_time: The length of the time step
+//    <4> r_impact_time: A reference to a double to store the
+//                       time of impact in
+//  Preconditions:
+//    <1> delta_time >= 0.0
+//  Returns: Whether entity1 and entity2 touched during the
+//           step.  This is always true if
+//           isCollision(entity1, entity2).
+//  Side Effect: If entity1 and entity2 touched,
+//               r_impact_time is set to the time in seconds
+//               after the start of the step when they first
+//               did.  Otherwise, r_impact_time is unchanged.
+//
+bool isCollisionDuring (const Entity& entity1,
+                        const Entity& entity2,
+                        double delta_time,
+                        double& r_impact_time);
+
+//
+//  isCollisionDuring
+//
+//  Purpose: To determine if the specified Entity collided with
+//           the specified Asteroid at any time during the last
+//           time step, and when.  The time is first narrowed
+//           down using the inner and outer radii of the
+//           Asteroid, and then found using its true shape.
+//           The Asteroid is assumed to have its current
+//           orientation for the whole step.
+//  Parameter(s):
+//    <1> asteroid: The Asteroid
+//    <2> entity: The Entity
+//    <3> delta_time: The length of the time step
+//    <4> r_impact_time: A reference to a double to store the
+//                       time of impact in
+//  Preconditions:
+//    <1> delta_time >= 0.0
+//  Returns: Whether asteroid and entity touched during the
+//           step.  This is always true if
+//           isCollision(asteroid, entity).
+//  Side Effect: If asteroid and entity touched, r_impact_time
+//               is set to the time in seconds after the start
+//               of the step when they first did.  Otherwise,
+//               r_impact_time is unchanged.
+//
+bool isCollisionDuring (const Asteroid& asteroid,
+                        const Entity& entity,
+                        double delta_time,
+                        double& r_impact_time);
+bool isCollisionDuring (const Entity& entity,
+                        const Asteroid& asteroid,
+                        double delta_time,
+                        double& r_impact_time);
+
 //
 //  bounceOff
 //
@@ -4,7 +4,11 @@
 
 #include <cassert>
 
-#include "GetGlut.h"
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+#endif
+
 #include "ObjLibrary/Vector3.h"
 
 #include "CoordinateSystem.h"
@@ -46,6 +50,22 @@ CoordinateSystem :: CoordinateSystem (const ObjLibrary::Vector3& position,
 	assert(invariant());
 }
 
+CoordinateSystem :: CoordinateSystem (const ObjLibrary::Vector3& position,
+                                      const ObjLibrary::Vector3& forward,
+                                      const ObjLibrary::Vector3& up,
+                                      const ObjLibrary::Vector3& right)
+		: m_position(position)
+		, m_forward(forward)
+		, m_up     (up)
+		, m_right  (right)
+{
+	assert(forward.isNormal());
+	assert(up     .isNormal());
+	assert(right  .isNormal());
+
+	assert(invariant());
+}
+
 
 
 ObjLibrary::Vector3 CoordinateSystem :: localToWorld (const ObjLibrary::Vector3& local) const
@@ -97,6 +117,7 @@ void CoordinateSystem :: calculateOrientationMatrix (double a_matrix[]) const
 	a_matrix[15] = 1.0;
 }
 
+#ifndef GAME_HEADLESS
 void CoordinateSystem :: applyDrawTransformations () const
 {
 	glTranslated(m_position.x, m_position.y, m_position.z);
@@ -113,6 +134,7 @@ void CoordinateSystem :: setupCamera () const
 	             look_at.x,    look_at.y,    look_at.z,
 	                m_up.x,       m_up.y,       m_up.z);
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
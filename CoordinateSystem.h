@@ -8,6 +8,8 @@
 
 #include "ObjLibrary/Vector3.h"
 
+#include "GameSettings.h"
+
 
 
 //
@@ -28,6 +30,10 @@ public:
 	CoordinateSystem (const ObjLibrary::Vector3& position,
 	                  const ObjLibrary::Vector3& forward,
 	                  const ObjLibrary::Vector3& up);
+	CoordinateSystem (const ObjLibrary::Vector3& position,
+	                  const ObjLibrary::Vector3& forward,
+	                  const ObjLibrary::Vector3& up,
+	                  const ObjLibrary::Vector3& right);
 	CoordinateSystem (const CoordinateSystem& to_copy) = default;
 	~CoordinateSystem () = default;
 	CoordinateSystem& operator= (const CoordinateSystem& to_copy) = default;
@@ -44,8 +50,10 @@ public:
 	ObjLibrary::Vector3 localToWorld (const ObjLibrary::Vector3& local) const;
 	ObjLibrary::Vector3 worldToLocal (const ObjLibrary::Vector3& world) const;
 	void calculateOrientationMatrix (double a_matrix[]) const;
+#ifndef GAME_HEADLESS
 	void applyDrawTransformations () const;
 	void setupCamera () const;
+#endif  // GAME_HEADLESS is not defined
 
 	void setPosition (const ObjLibrary::Vector3& position);
 	void addPosition (const ObjLibrary::Vector3& delta_position);
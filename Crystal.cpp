@@ -7,7 +7,11 @@
 #include <cassert>
 #include <algorithm>  // for min/max
 
-#include "GetGlut.h"
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+#endif
+
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
@@ -32,12 +36,9 @@ namespace
 
 Crystal :: Crystal ()
 		: Entity()
-		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
-		, m_rotation_rate(0.0)
 		, m_is_gone(false)
 {
 	assert(!isInitialized());
-	assert(invariant());
 }
 
 Crystal :: Crystal (const ObjLibrary::Vector3& position,
@@ -49,14 +50,15 @@ Crystal :: Crystal (const ObjLibrary::Vector3& position,
 		         RADIUS,
 		         display_list,
 		         RADIUS / 0.7)
-		, m_rotation_axis(Vector3::getRandomUnitVector())
-		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
 		, m_is_gone(false)
 {
 	assert(display_list.isReady());
 
+	Vector3 rotation_axis = Vector3::getRandomUnitVector();
+	double  rotation_rate = std::min(random01(), random01()) * ROTATION_RATE_MAX;  // mostly rotate slowly
+	setRotation(rotation_axis, rotation_rate);
+
 	assert(isInitialized());
-	assert(invariant());
 }
 
 
@@ -66,29 +68,6 @@ void Crystal :: markGone ()
 	assert(isInitialized());
 
 	m_is_gone++;
-
-	assert(invariant());
-}
-
-void Crystal :: updatePhysics (double delta_time,
-                               const Entity& black_hole)
-{
-	assert(isInitialized());
-	assert(delta_time > 0.0);
-
-	Entity::updatePhysics(delta_time, black_hole);
-
-	double rotation_radians = m_rotation_rate * delta_time;
-	m_coords.rotateAroundArbitrary(m_rotation_axis, rotation_radians);
-
-	assert(invariant());
-}
-
-
-
-bool Crystal :: invariant () const
-{
-	if(!m_rotation_axis.isUnit()) return false;
-	if(m_rotation_rate < 0.0) return false;
-	return true;
+	if(isInBodies())
+		setBodyActive(false);
 }
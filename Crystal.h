@@ -21,10 +21,6 @@
 //
 //  A class to represent a mineral crystal.
 //
-//  Class Invariant:
-//    <1> m_rotation_axis.isUnit()
-//    <2> m_rotation_rate >= 0.0
-//
 class Crystal : public Entity
 {
 public:
@@ -92,43 +88,12 @@ public:
 //    <1> isInitialized()
 //  Returns: N/A
 //  Side Effect: This crystal is marked as having been
-//               destroyed.
+//               destroyed.  If this Crystal is stored in a
+//               PhysicsBodies, its body is made inactive.
 //
 	void markGone ();
 
-//
-//  updatePhysics
-//
-//  Purpose: To perform the physics updates for this Entity
-//           for one time step.
-//  Parameter(s):
-//    <1> delta_time: The length of the time step in seconds
-//    <2> black_hole: The black hole
-//  Preconditions:
-//    <1> isInitialized()
-//    <2> delta_time > 0.0
-//  Returns: N/A
-//  Side Effect: This Entity is updated for one time step.  This
-//               includes rotation.
-//
-	virtual void updatePhysics (double delta_time,
-	                            const Entity& black_hole);
-
-private:
-//
-//  invariant
-//
-//  Purpose: To determine whether the class invariant is true.
-//  Parameter(s): N/A
-//  Preconditions: N/A
-//  Returns: Whether the class invariant is true.
-//  Side Effect: N/A
-//
-	bool invariant () const;
-
 private:
-	ObjLibrary::Vector3 m_rotation_axis;
-	double m_rotation_rate;
 	bool m_is_gone;
 };
 
@@ -0,0 +1,113 @@
+//
+//  CrystalPool.cpp
+//
+
+#include "CrystalPool.h"
+
+#include <cassert>
+#include <vector>
+
+#include "Crystal.h"
+#include "PhysicsBodies.h"
+
+using namespace std;
+
+
+const unsigned int CrystalPool :: NOT_LIVE;  // value is set in header file
+
+
+
+CrystalPool :: CrystalPool ()
+		: mv_crystals()
+		, mv_live_slots()
+		, mv_live_positions()
+		, mv_free_slots()
+{
+	assert(invariant());
+}
+
+
+
+unsigned int CrystalPool :: add (const Crystal& crystal,
+                                 PhysicsBodies& r_bodies)
+{
+	assert(crystal.isInitialized());
+	assert(!crystal.isGone());
+	assert(!crystal.isInBodies());
+
+	unsigned int slot;
+	if(mv_free_slots.empty())
+	{
+		slot = mv_crystals.size();
+		mv_crystals.push_back(crystal);
+		mv_crystals.back().moveIntoBodies(r_bodies);
+		mv_live_positions.push_back(NOT_LIVE);
+	}
+	else
+	{
+		slot = mv_free_slots.back();
+		mv_free_slots.pop_back();
+
+		unsigned int body = mv_crystals[slot].getBodyIndex();
+		mv_crystals[slot] = crystal;
+		mv_crystals[slot].moveIntoBodies(r_bodies, body);  // reuse body too
+	}
+
+	assert(mv_live_positions[slot] == NOT_LIVE);
+	mv_live_positions[slot] = mv_live_slots.size();
+	mv_live_slots.push_back(slot);
+
+	assert(isLive(slot));
+	assert(invariant());
+	return slot;
+}
+
+void CrystalPool :: remove (unsigned int slot)
+{
+	assert(slot < getSlotCount());
+	assert(isLive(slot));
+
+	mv_crystals[slot].markGone();
+
+	// move the last live slot into the hole
+	unsigned int position  = mv_live_positions[slot];
+	unsigned int last_slot = mv_live_slots.back();
+	mv_live_slots[position]       = last_slot;
+	mv_live_positions[last_slot]  = position;
+	mv_live_slots.pop_back();
+	mv_live_positions[slot] = NOT_LIVE;
+
+	mv_free_slots.push_back(slot);
+
+	assert(!isLive(slot));
+	assert(invariant());
+}
+
+
+
+bool CrystalPool :: invariant () const
+{
+	if(mv_live_positions.size() != mv_crystals.size()) return false;
+	if(mv_live_slots.size() + mv_free_slots.size() != mv_crystals.size()) return false;
+	for(unsigned int i = 0; i < mv_live_slots.size(); i++)
+	{
+		if(mv_live_slots[i] >= mv_crystals.size()) return false;
+		if(mv_live_positions[mv_live_slots[i]] != i) return false;
+	}
+
+	// free slots must be listed once and not be live, so with <2> each slot is in one list
+	vector<bool> v_is_free(mv_crystals.size(), false);
+	for(unsigned int i = 0; i < mv_free_slots.size(); i++)
+	{
+		unsigned int slot = mv_free_slots[i];
+		if(slot >= mv_crystals.size()) return false;
+		if(v_is_free[slot]) return false;
+		if(mv_live_positions[slot] != NOT_LIVE) return false;
+		v_is_free[slot] = true;
+	}
+
+	for(unsigned int s = 0; s < mv_crystals.size(); s++)
+		if(mv_crystals[s].isGone() != (mv_live_positions[s] == NOT_LIVE))
+			return false;
+	return true;
+}
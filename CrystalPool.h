@@ -0,0 +1,225 @@
+//
+//  CrystalPool.h
+//
+//  A module to store the crystals in play in reusable slots.
+//
+
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <vector>
+
+#include "Crystal.h"
+
+class PhysicsBodies;
+
+
+
+//
+//  CrystalPool
+//
+//  A class to store Crystals in slots that are reused after the
+//    crystal in them is gone.  Each crystal is identified by its
+//    slot index, which does not change while the crystal is in
+//    play, so other objects (e.g. Spaceships chasing a crystal)
+//    can store it.  The crystal in a gone slot keeps its
+//    PhysicsBodies body, which is reused by the next crystal
+//    added to the slot.
+//
+//  The slots of gone crystals are kept on a free list, and the
+//    slots of live crystals are kept in a dense array, so adding
+//    a crystal, removing a crystal, and counting the live
+//    crystals all take constant time.  Code that needs every
+//    live crystal loops over getLiveCount and getLiveSlot
+//    instead of checking every slot.  The order of the live
+//    slots changes when a crystal is removed.
+//
+//  Class Invariant:
+//    <1> mv_live_positions.size() == mv_crystals.size()
+//    <2> mv_live_slots.size() + mv_free_slots.size() == mv_crystals.size()
+//    <3> mv_live_positions[mv_live_slots[i]] == i for i < mv_live_slots.size()
+//    <4> mv_live_positions[mv_free_slots[i]] == NOT_LIVE for i < mv_free_slots.size()
+//    <5> mv_crystals[s].isGone() == (mv_live_positions[s] == NOT_LIVE) for all s
+//
+class CrystalPool
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty CrystalPool.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new CrystalPool is created with no slots.
+//
+	CrystalPool ();
+
+	CrystalPool (const CrystalPool& to_copy) = default;
+	~CrystalPool () = default;
+	CrystalPool& operator= (const CrystalPool& to_copy) = default;
+
+//
+//  getSlotCount
+//
+//  Purpose: To determine how many slots this CrystalPool has.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of live and gone crystals.
+//  Side Effect: N/A
+//
+	unsigned int getSlotCount () const
+	{  return mv_crystals.size();  }
+
+//
+//  getLiveCount
+//
+//  Purpose: To determine how many crystals in this CrystalPool
+//           are still in play.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of crystals that are not gone.
+//  Side Effect: N/A
+//
+	unsigned int getLiveCount () const
+	{  return mv_live_slots.size();  }
+
+//
+//  getLiveSlot
+//
+//  Purpose: To determine the slot of the specified live
+//           crystal.
+//  Parameter(s):
+//    <1> live: Which live crystal
+//  Preconditions:
+//    <1> live < getLiveCount()
+//  Returns: The slot index of live crystal live.
+//  Side Effect: N/A
+//
+	unsigned int getLiveSlot (unsigned int live) const
+	{
+		assert(live < getLiveCount());
+
+		return mv_live_slots[live];
+	}
+
+//
+//  isLive
+//
+//  Purpose: To determine whether the crystal in the specified
+//           slot is still in play.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Preconditions:
+//    <1> slot < getSlotCount()
+//  Returns: Whether the crystal in slot slot is not gone.
+//  Side Effect: N/A
+//
+	bool isLive (unsigned int slot) const
+	{
+		assert(slot < getSlotCount());
+
+		return mv_live_positions[slot] != NOT_LIVE;
+	}
+
+//
+//  getCrystal
+//
+//  Purpose: To retrieve the crystal in the specified slot.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Preconditions:
+//    <1> slot < getSlotCount()
+//  Returns: The crystal in slot slot.  It may be gone.
+//  Side Effect: N/A
+//
+	const Crystal& getCrystal (unsigned int slot) const
+	{
+		assert(slot < getSlotCount());
+
+		return mv_crystals[slot];
+	}
+
+//
+//  getCrystal
+//
+//  Purpose: To retrieve the crystal in the specified slot so
+//           that it can be moved.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Preconditions:
+//    <1> slot < getSlotCount()
+//  Returns: The crystal in slot slot.  It may be gone.  It must
+//           not be marked gone except with remove.
+//  Side Effect: N/A
+//
+	Crystal& getCrystal (unsigned int slot)
+	{
+		assert(slot < getSlotCount());
+
+		return mv_crystals[slot];
+	}
+
+//
+//  add
+//
+//  Purpose: To add a crystal to this CrystalPool.
+//  Parameter(s):
+//    <1> crystal: The crystal to add
+//    <2> r_bodies: The PhysicsBodies to store the crystal in
+//  Preconditions:
+//    <1> crystal.isInitialized()
+//    <2> !crystal.isGone()
+//    <3> !crystal.isInBodies()
+//    <4> Every crystal in this CrystalPool is stored in
+//        r_bodies
+//  Returns: The slot the crystal was added to.
+//  Side Effect: The crystal is copied into the most recently
+//               freed slot and given that slot's body in
+//               r_bodies.  If there are no free slots, a new
+//               slot is added and a new body is added to
+//               r_bodies.
+//
+	unsigned int add (const Crystal& crystal,
+	                  PhysicsBodies& r_bodies);
+
+//
+//  remove
+//
+//  Purpose: To remove the crystal in the specified slot from
+//           play.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Preconditions:
+//    <1> slot < getSlotCount()
+//    <2> isLive(slot)
+//  Returns: N/A
+//  Side Effect: The crystal in slot slot is marked as gone and
+//               the slot is added to the free list.  The last
+//               live crystal takes its place among the live
+//               crystals.
+//
+	void remove (unsigned int slot);
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	static const unsigned int NOT_LIVE = UINT_MAX;
+
+private:
+	std::vector<Crystal> mv_crystals;
+	std::vector<unsigned int> mv_live_slots;
+	std::vector<unsigned int> mv_live_positions;  // in mv_live_slots, for each slot
+	std::vector<unsigned int> mv_free_slots;  // used as a stack
+};
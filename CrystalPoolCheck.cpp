@@ -0,0 +1,164 @@
+//
+//  CrystalPoolCheck.cpp
+//
+//  A program to check a CrystalPool against a simple model
+//    while crystals are added and removed at random.  After
+//    every change, the slots, the live crystals, and the
+//    PhysicsBodies bodies are compared with the model.
+//
+//  Usage: crystal_pool_check
+//
+
+#include <cstdlib>  // for rand
+#include <iostream>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "Crystal.h"
+#include "CrystalPool.h"
+#include "PhysicsBodies.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+namespace
+{
+	const unsigned int STEP_COUNT = 10000;
+	const unsigned int PHASE_LENGTH = 1000;  // steps before switching between mostly adding and mostly removing
+
+	bool checkPool (const CrystalPool& pool,
+	                const PhysicsBodies& bodies,
+	                const vector<bool>& v_is_live,
+	                const vector<double>& v_tags,
+	                const vector<unsigned int>& v_body_indexes)
+	{
+		if(pool.getSlotCount() != v_is_live.size())
+		{
+			cerr << "Pool has " << pool.getSlotCount() << " slots instead of " << v_is_live.size() << endl;
+			return false;
+		}
+		if(bodies.getCount() != v_is_live.size())
+		{
+			cerr << "PhysicsBodies has " << bodies.getCount() << " bodies instead of " << v_is_live.size() << endl;
+			return false;
+		}
+
+		unsigned int live_count = 0;
+		for(unsigned int s = 0; s < v_is_live.size(); s++)
+		{
+			const Crystal& crystal = pool.getCrystal(s);
+			if(pool.isLive(s) != v_is_live[s] || crystal.isGone() == v_is_live[s])
+			{
+				cerr << "Slot " << s << " is live or gone when it should not be" << endl;
+				return false;
+			}
+			if(crystal.getBodyIndex() != v_body_indexes[s])
+			{
+				cerr << "Slot " << s << " has body " << crystal.getBodyIndex()
+				     << " instead of " << v_body_indexes[s] << endl;
+				return false;
+			}
+			if(v_is_live[s])
+			{
+				live_count++;
+				if(crystal.getPosition().x != v_tags[s])
+				{
+					cerr << "Slot " << s << " holds the wrong crystal" << endl;
+					return false;
+				}
+			}
+		}
+
+		if(pool.getLiveCount() != live_count)
+		{
+			cerr << "Pool has " << pool.getLiveCount() << " live crystals instead of " << live_count << endl;
+			return false;
+		}
+
+		// every live slot must be listed exactly once
+		vector<bool> v_is_listed(v_is_live.size(), false);
+		for(unsigned int n = 0; n < pool.getLiveCount(); n++)
+		{
+			unsigned int s = pool.getLiveSlot(n);
+			if(s >= v_is_live.size() || !v_is_live[s] || v_is_listed[s])
+			{
+				cerr << "Live crystal " << n << " is in slot " << s << ", which is gone or already listed" << endl;
+				return false;
+			}
+			v_is_listed[s] = true;
+		}
+		return true;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	DisplayList display_list;
+	display_list.begin();
+	display_list.end();
+
+	PhysicsBodies bodies;
+	CrystalPool pool;
+	vector<bool> v_is_live;
+	vector<double> v_tags;  // the x coordinate of the crystal added to each slot
+	vector<unsigned int> v_body_indexes;
+	vector<unsigned int> v_free_slots;  // most recently freed last
+
+	for(unsigned int step = 0; step < STEP_COUNT; step++)
+	{
+		bool is_mostly_adding = (step / PHASE_LENGTH) % 2 == 0;
+		bool is_add = (rand() % 4 != 0) == is_mostly_adding;
+		if(pool.getLiveCount() == 0)
+			is_add = true;
+
+		if(is_add)
+		{
+			double tag = step;
+			unsigned int slot = pool.add(Crystal(Vector3(tag, 0.0, 0.0), Vector3::ZERO, display_list), bodies);
+
+			unsigned int expected = v_is_live.size();
+			if(!v_free_slots.empty())
+			{
+				expected = v_free_slots.back();
+				v_free_slots.pop_back();
+			}
+			if(slot != expected)
+			{
+				cerr << "Step " << step << " added to slot " << slot << " instead of " << expected << endl;
+				return 1;
+			}
+
+			if(slot == v_is_live.size())
+			{
+				v_is_live.push_back(true);
+				v_tags.push_back(tag);
+				v_body_indexes.push_back(pool.getCrystal(slot).getBodyIndex());
+			}
+			else
+			{
+				v_is_live[slot] = true;
+				v_tags[slot] = tag;
+			}
+		}
+		else
+		{
+			unsigned int slot = pool.getLiveSlot(rand() % pool.getLiveCount());
+			pool.remove(slot);
+			v_is_live[slot] = false;
+			v_free_slots.push_back(slot);
+		}
+
+		if(!checkPool(pool, bodies, v_is_live, v_tags, v_body_indexes))
+		{
+			cerr << "    after step " << step << endl;
+			return 1;
+		}
+	}
+
+	cout << "CrystalPool check passed" << endl;
+	return 0;
+}
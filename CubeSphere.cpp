@@ -0,0 +1,314 @@
+//
+//  CubeSphere.cpp
+//
+
+#include "CubeSphere.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <map>
+
+#include "ObjLibrary/Vector2.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/ObjModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI         = 3.1415926535897932384626433832795;
+	const double TWO_PI     = PI * 2.0;
+	const double QUARTER_PI = PI * 0.25;
+
+	// closer than this to the Y axis counts as a pole
+	const double POLE_DISTANCE = 1.0e-9;
+
+
+
+	//
+	//  calculatePosition
+	//
+	//  Purpose: To calculate the position on the sphere for the
+	//           specified cube grid corner.
+	//  Parameter(s):
+	//    <1> a_grid: The corner, as 3 integer coordinates from
+	//                0 to subdivisions
+	//    <2> subdivisions: The number of squares along each
+	//                      edge of the cube
+	//  Preconditions:
+	//    <1> a_grid[i] <= subdivisions for i < 3
+	//    <2> subdivisions >= 1
+	//    <3> At least one of a_grid is 0 or subdivisions
+	//  Returns: The unit vector for the corner.
+	//  Side Effect: N/A
+	//
+	Vector3 calculatePosition (const unsigned int a_grid[3],
+	                           unsigned int subdivisions)
+	{
+		assert(subdivisions >= 1);
+
+		double a_cube[3];
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			assert(a_grid[i] <= subdivisions);
+
+			// space evenly by angle, from -45 to 45 degrees
+			double fraction = 2.0 * a_grid[i] / subdivisions - 1.0;
+			a_cube[i] = tan(fraction * QUARTER_PI);
+		}
+		return Vector3(a_cube[0], a_cube[1], a_cube[2]).getNormalized();
+	}
+
+	//
+	//  calculateLongitude
+	//
+	//  Purpose: To calculate the texture U coordinate for the
+	//           specified position.
+	//  Parameter(s):
+	//    <1> position: The position
+	//  Preconditions: N/A
+	//  Returns: The longitude of position around the Y axis, in
+	//           the range [0, 1].
+	//  Side Effect: N/A
+	//
+	double calculateLongitude (const Vector3& position)
+	{
+		return 0.5 - atan2(position.z, position.x) / TWO_PI;
+	}
+
+	//
+	//  calculateLatitude
+	//
+	//  Purpose: To calculate the texture V coordinate for the
+	//           specified position.
+	//  Parameter(s):
+	//    <1> position: The position
+	//  Preconditions:
+	//    <1> position.isUnit()
+	//  Returns: The latitude of position from the -Y pole to the
+	//           +Y pole, in the range [0, 1].
+	//  Side Effect: N/A
+	//
+	double calculateLatitude (const Vector3& position)
+	{
+		double y = position.y;
+		if(y >  1.0) y =  1.0;  // rounding error
+		if(y < -1.0) y = -1.0;
+		return asin(y) / PI + 0.5;
+	}
+
+	//
+	//  isPole
+	//
+	//  Purpose: To determine if the specified position is at a
+	//           pole, where the longitude is undefined.
+	//  Parameter(s):
+	//    <1> position: The position
+	//  Preconditions: N/A
+	//  Returns: Whether position is on the Y axis.
+	//  Side Effect: N/A
+	//
+	bool isPole (const Vector3& position)
+	{
+		return fabs(position.x) < POLE_DISTANCE &&
+		       fabs(position.z) < POLE_DISTANCE;
+	}
+
+	//
+	//  addTriangle
+	//
+	//  Purpose: To add a triangle to the specified ObjModel.
+	//  Parameter(s):
+	//    <1> r_model: The ObjModel
+	//    <2> mesh: The mesh to add the triangle to
+	//    <3> vertex0
+	//    <4> vertex1
+	//    <5> vertex2: The vertexes of the triangle
+	//  Preconditions:
+	//    <1> mesh < r_model.getMeshCount()
+	//    <2> vertex0 < r_model.getVertexCount()
+	//    <3> vertex1 < r_model.getVertexCount()
+	//    <4> vertex2 < r_model.getVertexCount()
+	//    <5> The model has the same number of texture
+	//        coordinates and normals as vertexes, created for
+	//        each vertex in order
+	//  Returns: N/A
+	//  Side Effect: A triangle is added to mesh mesh of r_model.
+	//               It is wound counterclockwise as seen from
+	//               outside the sphere.  If the triangle crosses
+	//               the texture seam or touches a pole, extra
+	//               texture coordinates are added for it.
+	//
+	void addTriangle (ObjModel& r_model,
+	                  unsigned int mesh,
+	                  unsigned int vertex0,
+	                  unsigned int vertex1,
+	                  unsigned int vertex2)
+	{
+		assert(mesh < r_model.getMeshCount());
+		assert(vertex0 < r_model.getVertexCount());
+		assert(vertex1 < r_model.getVertexCount());
+		assert(vertex2 < r_model.getVertexCount());
+
+		unsigned int a_vertexes[3] = { vertex0, vertex1, vertex2 };
+		const Vector3& position0 = r_model.getVertexPosition(vertex0);
+		const Vector3& position1 = r_model.getVertexPosition(vertex1);
+		const Vector3& position2 = r_model.getVertexPosition(vertex2);
+		Vector3 normal = (position1 - position0).crossProduct(position2 - position0);
+		if(normal.dotProduct(position0 + position1 + position2) < 0.0)
+		{
+			a_vertexes[1] = vertex2;
+			a_vertexes[2] = vertex1;
+		}
+
+		//
+		//  The longitude wraps around from 1 to 0, so a triangle
+		//    across the seam needs 1 added to the small values.
+		//    The longitude at a pole is undefined, so the average
+		//    of the other vertexes is used.
+		//
+
+		double a_u[3];
+		bool a_is_pole[3];
+		double u_min =  1.0e9;
+		double u_max = -1.0e9;
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			const Vector3& position = r_model.getVertexPosition(a_vertexes[i]);
+			a_u[i] = r_model.getTextureCoordinateU(a_vertexes[i]);
+			a_is_pole[i] = isPole(position);
+			if(!a_is_pole[i])
+			{
+				if(a_u[i] < u_min) u_min = a_u[i];
+				if(a_u[i] > u_max) u_max = a_u[i];
+			}
+		}
+
+		bool is_seam = (u_max - u_min > 0.5);
+		double u_sum = 0.0;
+		unsigned int u_count = 0;
+		for(unsigned int i = 0; i < 3; i++)
+			if(!a_is_pole[i])
+			{
+				if(is_seam && a_u[i] < 0.5)
+					a_u[i] += 1.0;
+				u_sum += a_u[i];
+				u_count++;
+			}
+
+		unsigned int face = r_model.addFace(mesh);
+		for(unsigned int i = 0; i < 3; i++)
+		{
+			unsigned int vertex = a_vertexes[i];
+			unsigned int texture_coordinates = vertex;
+			if(a_is_pole[i] && u_count > 0)
+			{
+				double v = r_model.getTextureCoordinateV(vertex);
+				texture_coordinates = r_model.addTextureCoordinate(u_sum / u_count, v);
+			}
+			else if(a_u[i] != r_model.getTextureCoordinateU(vertex))
+			{
+				double v = r_model.getTextureCoordinateV(vertex);
+				texture_coordinates = r_model.addTextureCoordinate(a_u[i], v);
+			}
+			r_model.addFaceVertex(mesh, face, vertex, texture_coordinates, vertex);
+		}
+	}
+
+}  // end of anonymous namespace
+
+
+
+unsigned int CubeSphere :: getVertexCount (unsigned int subdivisions)
+{
+	assert(subdivisions >= 1);
+
+	return 6 * subdivisions * subdivisions + 2;
+}
+
+unsigned int CubeSphere :: getTriangleCount (unsigned int subdivisions)
+{
+	assert(subdivisions >= 1);
+
+	return 12 * subdivisions * subdivisions;
+}
+
+ObjLibrary::ObjModel CubeSphere :: create (unsigned int subdivisions)
+{
+	assert(subdivisions >= 1);
+
+	static const unsigned int FACE_COUNT = 6;
+
+	ObjModel model;
+	unsigned int mesh = model.addMesh();
+
+	//
+	//  Add all the vertexes before any triangles, so that vertex
+	//    i has texture coordinates i and normal i.  Triangles add
+	//    extra texture coordinates at the seam and the poles.
+	//
+	//  The vertexes are shared between faces, so they are found
+	//    by their grid position.
+	//
+
+	unsigned int row_length = subdivisions + 1;
+	map<unsigned int, unsigned int> grid_to_vertex;
+	vector<unsigned int> v_face_vertexes(FACE_COUNT * row_length * row_length);
+	for(unsigned int f = 0; f < FACE_COUNT; f++)
+	{
+		unsigned int axis   = f / 2;
+		unsigned int side   = f % 2;
+		unsigned int axis_a = (axis + 1) % 3;
+		unsigned int axis_b = (axis + 2) % 3;
+		unsigned int* a_face_vertexes = v_face_vertexes.data() + f * row_length * row_length;
+
+		for(unsigned int b = 0; b <= subdivisions; b++)
+			for(unsigned int a = 0; a <= subdivisions; a++)
+			{
+				unsigned int a_grid[3];
+				a_grid[axis]   = side * subdivisions;
+				a_grid[axis_a] = a;
+				a_grid[axis_b] = b;
+				unsigned int key = (a_grid[0] * row_length + a_grid[1]) * row_length + a_grid[2];
+
+				map<unsigned int, unsigned int>::iterator p_found = grid_to_vertex.find(key);
+				if(p_found != grid_to_vertex.end())
+					a_face_vertexes[b * row_length + a] = p_found->second;
+				else
+				{
+					Vector3 position = calculatePosition(a_grid, subdivisions);
+					unsigned int vertex = model.addVertex(position);
+					model.addNormal(position);
+					model.addTextureCoordinate(calculateLongitude(position),
+					                           calculateLatitude(position));
+					grid_to_vertex[key] = vertex;
+					a_face_vertexes[b * row_length + a] = vertex;
+				}
+			}
+	}
+	assert(model.getVertexCount() == getVertexCount(subdivisions));
+	assert(model.getNormalCount() == getVertexCount(subdivisions));
+	assert(model.getTextureCoordinateCount() == getVertexCount(subdivisions));
+
+	// split each square into 2 triangles
+	for(unsigned int f = 0; f < FACE_COUNT; f++)
+	{
+		const unsigned int* a_face_vertexes = v_face_vertexes.data() + f * row_length * row_length;
+		for(unsigned int b = 0; b < subdivisions; b++)
+			for(unsigned int a = 0; a < subdivisions; a++)
+			{
+				unsigned int vertex00 = a_face_vertexes[ b      * row_length + a    ];
+				unsigned int vertex10 = a_face_vertexes[ b      * row_length + a + 1];
+				unsigned int vertex01 = a_face_vertexes[(b + 1) * row_length + a    ];
+				unsigned int vertex11 = a_face_vertexes[(b + 1) * row_length + a + 1];
+				addTriangle(model, mesh, vertex00, vertex10, vertex11);
+				addTriangle(model, mesh, vertex00, vertex11, vertex01);
+			}
+	}
+	assert(model.getFaceCountTotal() == getTriangleCount(subdivisions));
+
+	model.validate();
+	assert(model.isValid());
+	return model;
+}
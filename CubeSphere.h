@@ -0,0 +1,81 @@
+//
+//  CubeSphere.h
+//
+//  A module to generate sphere models in memory.
+//
+
+#pragma once
+
+#include "ObjLibrary/ObjModel.h"
+
+
+
+//
+//  CubeSphere
+//
+//  A namespace to generate unit spheres as ObjModels, so that
+//    they do not have to be loaded from files.  The sphere is
+//    made by dividing each face of a cube into a grid of
+//    squares, moving the grid corners onto the sphere, and
+//    splitting each square into two triangles.  The grid is
+//    spaced evenly by angle instead of by distance across the
+//    cube face, so the triangles are close to the same size
+//    everywhere.  Vertexes on the cube edges are shared between
+//    the faces, so there are no cracks if the vertexes are
+//    moved later.
+//
+//  Each vertex has a normal vector equal to its position.  The
+//    texture coordinates are latitude and longitude, with the Y
+//    axis as the poles, so that the same textures can be used as
+//    for a UV sphere.
+//
+namespace CubeSphere
+{
+//
+//  getVertexCount
+//
+//  Purpose: To determine how many vertexes a cube sphere has.
+//  Parameter(s):
+//    <1> subdivisions: The number of squares along each edge
+//                      of the cube
+//  Preconditions:
+//    <1> subdivisions >= 1
+//  Returns: The number of vertexes in a cube sphere with
+//           subdivisions squares along each cube edge.
+//  Side Effect: N/A
+//
+unsigned int getVertexCount (unsigned int subdivisions);
+
+//
+//  getTriangleCount
+//
+//  Purpose: To determine how many triangles a cube sphere has.
+//  Parameter(s):
+//    <1> subdivisions: The number of squares along each edge
+//                      of the cube
+//  Preconditions:
+//    <1> subdivisions >= 1
+//  Returns: The number of triangles in a cube sphere with
+//           subdivisions squares along each cube edge.
+//  Side Effect: N/A
+//
+unsigned int getTriangleCount (unsigned int subdivisions);
+
+//
+//  create
+//
+//  Purpose: To create a cube sphere with no material.
+//  Parameter(s):
+//    <1> subdivisions: The number of squares along each edge
+//                      of the cube
+//  Preconditions:
+//    <1> subdivisions >= 1
+//  Returns: An ObjModel of a sphere of radius 1 centered at the
+//           origin, with getVertexCount(subdivisions) vertexes
+//           and getTriangleCount(subdivisions) triangles in a
+//           single mesh.
+//  Side Effect: N/A
+//
+ObjLibrary::ObjModel create (unsigned int subdivisions);
+
+}  // end of namespace CubeSphere
@@ -0,0 +1,226 @@
+//
+//  DebugDraw.cpp
+//
+
+#include "DebugDraw.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+#endif
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI = 3.1415926535897932384626433832795;
+
+	// same as used for glutWireSphere before
+	const unsigned int SPHERE_SLICES = 20;
+	const unsigned int SPHERE_STACKS = 15;
+
+	// the corners of an octahedron, in the same order as the faces use them
+	const Vector3 OCTAHEDRON_CORNERS[6] =
+	{
+		Vector3::UNIT_X_PLUS,  Vector3::UNIT_X_MINUS,
+		Vector3::UNIT_Y_PLUS,  Vector3::UNIT_Y_MINUS,
+		Vector3::UNIT_Z_PLUS,  Vector3::UNIT_Z_MINUS,
+	};
+
+	// pairs of points on a unit sphere, with the poles on the Z axis like glutWireSphere
+	vector<Vector3> createUnitSphereLines ()
+	{
+		vector<Vector3> v_points;
+		for(unsigned int stack = 0; stack <= SPHERE_STACKS; stack++)
+		{
+			double polar = stack * PI / SPHERE_STACKS;
+			for(unsigned int slice = 0; slice < SPHERE_SLICES; slice++)
+			{
+				double azimuth0 =  slice      * 2.0 * PI / SPHERE_SLICES;
+				double azimuth1 = (slice + 1) * 2.0 * PI / SPHERE_SLICES;
+				Vector3 point(sin(polar) * cos(azimuth0), sin(polar) * sin(azimuth0), cos(polar));
+
+				// circle of latitude, except at the poles
+				if(stack > 0 && stack < SPHERE_STACKS)
+				{
+					v_points.push_back(point);
+					v_points.push_back(Vector3(sin(polar) * cos(azimuth1), sin(polar) * sin(azimuth1), cos(polar)));
+				}
+
+				// line of longitude to the next stack
+				if(stack < SPHERE_STACKS)
+				{
+					double polar1 = (stack + 1) * PI / SPHERE_STACKS;
+					v_points.push_back(point);
+					v_points.push_back(Vector3(sin(polar1) * cos(azimuth0), sin(polar1) * sin(azimuth0), cos(polar1)));
+				}
+			}
+		}
+		return v_points;
+	}
+}
+
+
+
+const unsigned int DebugDraw :: FLOATS_PER_VERTEX;  // value is set in header file
+
+
+
+DebugDraw :: DebugDraw ()
+		: mv_line_vertices()
+		, mv_triangle_vertices()
+		, m_marker_count(0)
+{
+	assert(invariant());
+}
+
+
+
+unsigned int DebugDraw :: getLineCount () const
+{
+	return mv_line_vertices.size() / (FLOATS_PER_VERTEX * 2);
+}
+
+#ifndef GAME_HEADLESS
+void DebugDraw :: draw () const
+{
+	glPushAttrib(GL_CURRENT_BIT);  // colour arrays leave the current colour undefined
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+		if(!mv_line_vertices.empty())
+		{
+			glInterleavedArrays(GL_C3F_V3F, 0, mv_line_vertices.data());
+			glDrawArrays(GL_LINES, 0, mv_line_vertices.size() / FLOATS_PER_VERTEX);
+		}
+		if(!mv_triangle_vertices.empty())
+		{
+			glInterleavedArrays(GL_C3F_V3F, 0, mv_triangle_vertices.data());
+			glDrawArrays(GL_TRIANGLES, 0, mv_triangle_vertices.size() / FLOATS_PER_VERTEX);
+		}
+	glPopClientAttrib();
+	glPopAttrib();
+}
+#endif  // GAME_HEADLESS is not defined
+
+
+
+void DebugDraw :: clear ()
+{
+	mv_line_vertices.clear();
+	mv_triangle_vertices.clear();
+	m_marker_count = 0;
+
+	assert(invariant());
+}
+
+void DebugDraw :: addLine (const ObjLibrary::Vector3& head,
+                           const ObjLibrary::Vector3& tail,
+                           const ObjLibrary::Vector3& colour)
+{
+	addVertex(mv_line_vertices, head, colour);
+	addVertex(mv_line_vertices, tail, colour);
+
+	assert(invariant());
+}
+
+void DebugDraw :: addLine (const ObjLibrary::Vector3& head,
+                           const ObjLibrary::Vector3& head_colour,
+                           const ObjLibrary::Vector3& tail,
+                           const ObjLibrary::Vector3& tail_colour)
+{
+	addVertex(mv_line_vertices, head, head_colour);
+	addVertex(mv_line_vertices, tail, tail_colour);
+
+	assert(invariant());
+}
+
+void DebugDraw :: addSolidMarker (const ObjLibrary::Vector3& center,
+                                  double size,
+                                  const ObjLibrary::Vector3& colour)
+{
+	assert(size > 0.0);
+
+	// one face in each octant, wound counterclockwise from outside
+	for(unsigned int x = 0; x < 2; x++)
+		for(unsigned int y = 2; y < 4; y++)
+			for(unsigned int z = 4; z < 6; z++)
+			{
+				const Vector3& corner_x = OCTAHEDRON_CORNERS[x];
+				const Vector3& corner_y = OCTAHEDRON_CORNERS[y];
+				const Vector3& corner_z = OCTAHEDRON_CORNERS[z];
+				bool is_flipped = (x + y + z) % 2 == 1;  // an odd number of minus signs
+
+				addVertex(mv_triangle_vertices, center + corner_x * size, colour);
+				if(is_flipped)
+				{
+					addVertex(mv_triangle_vertices, center + corner_z * size, colour);
+					addVertex(mv_triangle_vertices, center + corner_y * size, colour);
+				}
+				else
+				{
+					addVertex(mv_triangle_vertices, center + corner_y * size, colour);
+					addVertex(mv_triangle_vertices, center + corner_z * size, colour);
+				}
+			}
+	m_marker_count++;
+
+	assert(invariant());
+}
+
+void DebugDraw :: addWireMarker (const ObjLibrary::Vector3& center,
+                                 double size,
+                                 const ObjLibrary::Vector3& colour)
+{
+	assert(size > 0.0);
+
+	// every pair of corners on different axes is an edge
+	for(unsigned int a = 0; a < 6; a++)
+		for(unsigned int b = a + 1; b < 6; b++)
+		{
+			if(a / 2 != b / 2)
+				addLine(center + OCTAHEDRON_CORNERS[a] * size, center + OCTAHEDRON_CORNERS[b] * size, colour);
+		}
+	m_marker_count++;
+
+	assert(invariant());
+}
+
+void DebugDraw :: addWireSphere (const ObjLibrary::Vector3& center,
+                                 double radius,
+                                 const ObjLibrary::Vector3& colour)
+{
+	static const vector<Vector3> V_UNIT_SPHERE_LINES = createUnitSphereLines();
+
+	assert(radius > 0.0);
+
+	for(unsigned int i = 0; i < V_UNIT_SPHERE_LINES.size(); i++)
+		addVertex(mv_line_vertices, center + V_UNIT_SPHERE_LINES[i] * radius, colour);
+
+	assert(invariant());
+}
+
+
+
+void DebugDraw :: addVertex (std::vector<float>& r_vertices,
+                             const ObjLibrary::Vector3& position,
+                             const ObjLibrary::Vector3& colour)
+{
+	r_vertices.push_back((float)(colour.x));
+	r_vertices.push_back((float)(colour.y));
+	r_vertices.push_back((float)(colour.z));
+	r_vertices.push_back((float)(position.x));
+	r_vertices.push_back((float)(position.y));
+	r_vertices.push_back((float)(position.z));
+}
+
+bool DebugDraw :: invariant () const
+{
+	if(mv_line_vertices.size()     % (FLOATS_PER_VERTEX * 2) != 0) return false;
+	if(mv_triangle_vertices.size() % (FLOATS_PER_VERTEX * 3) != 0) return false;
+	return true;
+}
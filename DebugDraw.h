@@ -0,0 +1,241 @@
+//
+//  DebugDraw.h
+//
+//  A module to collect lines and markers and draw them all at
+//    once.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  DebugDraw
+//
+//  A class to collect the lines and markers drawn for debugging
+//    and paths during a frame and draw them together at the
+//    end.  Everything is stored in world coordinates as arrays
+//    of coloured float vertexes, so drawing takes one call for
+//    all the lines and one for all the solid markers instead of
+//    separate OpenGL calls and matrix changes for each one.
+//
+//  Markers are octahedra, the same shape as
+//    glutSolidOctahedron and glutWireOctahedron.  Wire markers
+//    and wire spheres are stored as lines.  Lighting and
+//    textures are not used, so everything is drawn in flat
+//    colours.
+//
+//  Class Invariant:
+//    <1> mv_line_vertices.size() % (FLOATS_PER_VERTEX * 2) == 0
+//    <2> mv_triangle_vertices.size() %
+//                                  (FLOATS_PER_VERTEX * 3) == 0
+//
+class DebugDraw
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty DebugDraw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new DebugDraw is created.  It contains no
+//               lines or markers.
+//
+	DebugDraw ();
+
+	DebugDraw (const DebugDraw& to_copy) = default;
+	~DebugDraw () = default;
+	DebugDraw& operator= (const DebugDraw& to_copy) = default;
+
+//
+//  getLineCount
+//
+//  Purpose: To determine how many lines are in this DebugDraw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of lines added since this DebugDraw was
+//           last cleared, including the lines for wire markers
+//           and wire spheres.
+//  Side Effect: N/A
+//
+	unsigned int getLineCount () const;
+
+//
+//  getMarkerCount
+//
+//  Purpose: To determine how many markers are in this
+//           DebugDraw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of solid and wire markers added since
+//           this DebugDraw was last cleared.
+//  Side Effect: N/A
+//
+	unsigned int getMarkerCount () const
+	{  return m_marker_count;  }
+
+//
+//  clear
+//
+//  Purpose: To remove everything from this DebugDraw.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: All lines and markers are removed.  The memory
+//               for them is kept for the next frame.
+//
+	void clear ();
+
+//
+//  addLine
+//
+//  Purpose: To add a line of a single colour to this
+//           DebugDraw.
+//  Parameter(s):
+//    <1> head: The start of the line
+//    <2> tail: The end of the line
+//    <3> colour: The colour of the line
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A line from head to tail is added in colour
+//               colour.
+//
+	void addLine (const ObjLibrary::Vector3& head,
+	              const ObjLibrary::Vector3& tail,
+	              const ObjLibrary::Vector3& colour);
+
+//
+//  addLine
+//
+//  Purpose: To add a line that changes colour to this
+//           DebugDraw.
+//  Parameter(s):
+//    <1> head: The start of the line
+//    <2> head_colour: The colour at head
+//    <3> tail: The end of the line
+//    <4> tail_colour: The colour at tail
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A line from head to tail is added.  Its colour
+//               blends from head_colour to tail_colour.
+//
+	void addLine (const ObjLibrary::Vector3& head,
+	              const ObjLibrary::Vector3& head_colour,
+	              const ObjLibrary::Vector3& tail,
+	              const ObjLibrary::Vector3& tail_colour);
+
+//
+//  addSolidMarker
+//
+//  Purpose: To add a solid marker to this DebugDraw.
+//  Parameter(s):
+//    <1> center: The center of the marker
+//    <2> size: The distance from the center to each corner
+//    <3> colour: The colour of the marker
+//  Preconditions:
+//    <1> size > 0.0
+//  Returns: N/A
+//  Side Effect: A solid octahedron is added at center in colour
+//               colour.
+//
+	void addSolidMarker (const ObjLibrary::Vector3& center,
+	                     double size,
+	                     const ObjLibrary::Vector3& colour);
+
+//
+//  addWireMarker
+//
+//  Purpose: To add a wireframe marker to this DebugDraw.
+//  Parameter(s):
+//    <1> center: The center of the marker
+//    <2> size: The distance from the center to each corner
+//    <3> colour: The colour of the marker
+//  Preconditions:
+//    <1> size > 0.0
+//  Returns: N/A
+//  Side Effect: The 12 edges of an octahedron at center are
+//               added as lines in colour colour.
+//
+	void addWireMarker (const ObjLibrary::Vector3& center,
+	                    double size,
+	                    const ObjLibrary::Vector3& colour);
+
+//
+//  addWireSphere
+//
+//  Purpose: To add a wireframe sphere to this DebugDraw.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//    <3> colour: The colour of the sphere
+//  Preconditions:
+//    <1> radius > 0.0
+//  Returns: N/A
+//  Side Effect: Lines of latitude and longitude for the sphere
+//               are added in colour colour, the same as
+//               glutWireSphere with 20 slices and 15 stacks.
+//
+	void addWireSphere (const ObjLibrary::Vector3& center,
+	                    double radius,
+	                    const ObjLibrary::Vector3& colour);
+
+#ifndef GAME_HEADLESS
+//
+//  draw
+//
+//  Purpose: To draw everything in this DebugDraw.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> The model view matrix only contains the camera
+//        transformation
+//  Returns: N/A
+//  Side Effect: All the lines are drawn with one OpenGL call
+//               and all the solid markers with another.  The
+//               current colour is not changed.
+//
+	void draw () const;
+#endif  // GAME_HEADLESS is not defined
+
+private:
+//
+//  addVertex
+//
+//  Purpose: To add a coloured vertex to the specified array.
+//  Parameter(s):
+//    <1> r_vertices: The array to add to
+//    <2> position: The position of the vertex
+//    <3> colour: The colour of the vertex
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The vertex is added to r_vertices in the
+//               GL_C3F_V3F format.
+//
+	static void addVertex (std::vector<float>& r_vertices,
+	                       const ObjLibrary::Vector3& position,
+	                       const ObjLibrary::Vector3& colour);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	static const unsigned int FLOATS_PER_VERTEX = 6;  // colour and position
+
+private:
+	std::vector<float> mv_line_vertices;
+	std::vector<float> mv_triangle_vertices;
+	unsigned int m_marker_count;
+};
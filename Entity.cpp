@@ -6,12 +6,17 @@
 
 #include <cassert>
 
-#include "GetGlut.h"
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+#endif
+
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
-#include "Gravity.h"
 #include "CoordinateSystem.h"
+#include "GravityKernels.h"
+#include "PhysicsBodies.h"
 
 using namespace ObjLibrary;
 
@@ -24,6 +29,10 @@ Entity :: Entity ()
 		, m_radius(0.0)
 		, m_display_list()
 		, m_scaling_factor(1.0)
+		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
+		, m_rotation_rate(0.0)
+		, mp_bodies(nullptr)
+		, m_body(0)
 {
 	assert(!isInitialized());
 	assert(invariant());
@@ -41,6 +50,10 @@ Entity :: Entity (const ObjLibrary::Vector3& position,
 		, m_radius(radius)
 		, m_display_list(display_list)
 		, m_scaling_factor(scaling_factor)
+		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
+		, m_rotation_rate(0.0)
+		, mp_bodies(nullptr)
+		, m_body(0)
 {
 	assert(mass   >= 0.0);
 	assert(radius >= 0.0);
@@ -53,25 +66,52 @@ Entity :: Entity (const ObjLibrary::Vector3& position,
 
 
 
+#ifndef GAME_HEADLESS
 void Entity :: draw () const
 {
 	assert(isInitialized());
 
 	glPushMatrix();
-		m_coords.applyDrawTransformations();
+		getCoordinateSystem().applyDrawTransformations();
 		glScaled(m_scaling_factor, m_scaling_factor, m_scaling_factor);
 		assert(m_display_list.isReady());
 		m_display_list.draw();
 	glPopMatrix();
 }
+#endif  // GAME_HEADLESS is not defined
+
 
 
+void Entity :: setPosition (const ObjLibrary::Vector3& position)
+{
+	assert(isInitialized());
+
+	if(mp_bodies != nullptr)
+		mp_bodies->setPosition(m_body, position);
+	else
+		m_coords.setPosition(position);
+
+	assert(invariant());
+}
 
 void Entity :: setVelocity (const ObjLibrary::Vector3& velocity)
 {
 	assert(isInitialized());
 
-	m_velocity = velocity;
+	if(mp_bodies != nullptr)
+		mp_bodies->setVelocity(m_body, velocity);
+	else
+		m_velocity = velocity;
+
+	assert(invariant());
+}
+
+void Entity :: setDisplayList (const ObjLibrary::DisplayList& display_list)
+{
+	assert(isInitialized());
+	assert(display_list.isReady());
+
+	m_display_list = display_list;
 
 	assert(invariant());
 }
@@ -80,7 +120,37 @@ void Entity :: addVelocity (const ObjLibrary::Vector3& delta)
 {
 	assert(isInitialized());
 
-	m_velocity += delta;
+	if(mp_bodies != nullptr)
+		mp_bodies->setVelocity(m_body, mp_bodies->getVelocity(m_body) + delta);
+	else
+		m_velocity += delta;
+
+	assert(invariant());
+}
+
+void Entity :: moveIntoBodies (PhysicsBodies& r_bodies)
+{
+	assert(isInitialized());
+	assert(!isInBodies());
+
+	m_body = r_bodies.addBody(m_coords, m_velocity, m_mass,
+	                          m_rotation_axis, m_rotation_rate);
+	mp_bodies = &r_bodies;
+
+	assert(invariant());
+}
+
+void Entity :: moveIntoBodies (PhysicsBodies& r_bodies,
+                               unsigned int body)
+{
+	assert(isInitialized());
+	assert(!isInBodies());
+	assert(body < r_bodies.getCount());
+
+	r_bodies.setBody(body, m_coords, m_velocity, m_mass,
+	                 m_rotation_axis, m_rotation_rate);
+	m_body = body;
+	mp_bodies = &r_bodies;
 
 	assert(invariant());
 }
@@ -91,24 +161,23 @@ void Entity :: updatePhysics (double delta_time,
 	assert(isInitialized());
 	assert(delta_time > 0.0);
 
-	Vector3 old_position = m_coords.getPosition();
-
-	// apply black hole gravity
-	const Vector3& black_hole_position = black_hole.getPosition();
-	Vector3 vector_to_black_hole = black_hole_position - old_position;
-	if(!vector_to_black_hole.isZero())
+	if(mp_bodies != nullptr)
 	{
-		double distance_squared = old_position.getDistanceSquared(black_hole_position);
-		assert(distance_squared > 0.0);
-
-		double magnitude = GRAVITY * black_hole.getMass() / distance_squared;
-		Vector3 acceleration = vector_to_black_hole.getCopyWithNorm(magnitude);
-		m_velocity += acceleration * delta_time;
+		mp_bodies->updateBody(m_body, delta_time,
+		                      black_hole.getPosition(),
+		                      black_hole.getMass());
+	}
+	else
+	{
+		Vector3 position = m_coords.getPosition();
+		GravityKernels::advance(GravityKernels::SCALAR, 1, delta_time,
+		                        black_hole.getPosition(), black_hole.getMass(),
+		                        &position, &m_velocity);
+		m_coords.setPosition(position);
+
+		if(m_rotation_rate != 0.0)
+			m_coords.rotateAroundArbitrary(m_rotation_axis, m_rotation_rate * delta_time);
 	}
-
-	// move according to velocity
-	Vector3 new_position = old_position + m_velocity * delta_time;
-	m_coords.setPosition(new_position);
 /*
 	// rotate based on motion around black hole
 	Vector3 new_vector_to_black_hole = black_hole_position - new_position;
@@ -124,11 +193,48 @@ void Entity :: updatePhysics (double delta_time,
 
 
 
+void Entity :: setRotation (const ObjLibrary::Vector3& axis,
+                            double rate)
+{
+	assert(isInitialized());
+	assert(!isInBodies());
+	assert(axis.isUnit());
+	assert(rate >= 0.0);
+
+	m_rotation_axis = axis;
+	m_rotation_rate = rate;
+
+	assert(invariant());
+}
+
+void Entity :: setOrientation (const CoordinateSystem& coords)
+{
+	assert(isInitialized());
+
+	if(mp_bodies != nullptr)
+	{
+		mp_bodies->setOrientation(m_body, coords.getForward(),
+		                          coords.getUp(), coords.getRight());
+	}
+	else
+	{
+		m_coords = CoordinateSystem(m_coords.getPosition(), coords.getForward(),
+		                            coords.getUp(), coords.getRight());
+	}
+
+	assert(invariant());
+}
+
+
+
 bool Entity :: invariant () const
 {
 	if(m_mass <= 0.0) return false;
 	if(m_radius < 0.0) return false;
 	if(m_display_list.isPartial()) return false;
 	if(m_scaling_factor <= 0.0) return false;
+	if(!m_rotation_axis.isUnit()) return false;
+	if(m_rotation_rate < 0.0) return false;
+	if(mp_bodies != nullptr && m_body >= mp_bodies->getCount()) return false;
 	return true;
 }
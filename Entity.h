@@ -11,7 +11,9 @@
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
+#include "GameSettings.h"
 #include "CoordinateSystem.h"
+#include "PhysicsBodies.h"
 
 
 
@@ -22,13 +24,25 @@
 //    Entity has a coordinate system, a velocity, a mass, and a
 //    collision radius.  The Entity must fit entirely inside the
 //    collision radius, although it is not required to occupy
-//    that whole volume.
+//    that whole volume.  An Entity may also rotate at a
+//    constant rate around a fixed axis.
+//
+//  The position, orientation, velocity, mass, and rotation of
+//    an Entity are normally stored in the Entity itself.  They
+//    can instead be moved into a PhysicsBodies, so that many
+//    Entities can be updated together (see moveIntoBodies).
+//    After that, the Entity is a handle to its body: the
+//    functions here read and write the body, and copying the
+//    Entity produces another handle to the same body.
 //
 //  Class Invariant:
 //    <1> m_mass > 0.0
 //    <2> m_radius >= 0.0
 //    <3> !m_display_list.isPartial()
 //    <4> m_scaling_factor > 0.0
+//    <5> m_rotation_axis.isUnit()
+//    <6> m_rotation_rate >= 0.0
+//    <7> mp_bodies == nullptr || m_body < mp_bodies->getCount()
 //
 class Entity
 {
@@ -108,6 +122,8 @@ public:
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getPosition(m_body);
 		return m_coords.getPosition();
 	}
 
@@ -128,43 +144,44 @@ public:
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getForward(m_body);
 		return m_coords.getForward();
 	}
 	const ObjLibrary::Vector3& getUp () const
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getUp(m_body);
 		return m_coords.getUp();
 	}
 	const ObjLibrary::Vector3& getRight () const
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getRight(m_body);
 		return m_coords.getRight();
 	}
 
 //
 //  getCoordinateSystem
 //
-//  Purpose: To retreive a reference to the coordinate system
-//           for this Entity.  The coordinate system is const
-//           IFF this Entity is.
+//  Purpose: To retreive a copy of the coordinate system for
+//           this Entity.
 //  Parameter(s): N/A
 //  Preconditions:
 //    <1> isInitialized()
 //  Returns: The local coordinate system for this Entity.
 //  Side Effect: N/A
 //
-	const CoordinateSystem& getCoordinateSystem () const
-	{
-		assert(isInitialized());
-
-		return m_coords;
-	}
-	CoordinateSystem& getCoordinateSystem ()
+	CoordinateSystem getCoordinateSystem () const
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getCoordinateSystem(m_body);
 		return m_coords;
 	}
 
@@ -182,6 +199,8 @@ public:
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getVelocity(m_body);
 		return m_velocity;
 	}
 
@@ -199,6 +218,8 @@ public:
 	{
 		assert(isInitialized());
 
+		if(mp_bodies != nullptr)
+			return mp_bodies->getMass(m_body);
 		return m_mass;
 	}
 
@@ -222,6 +243,76 @@ public:
 		return m_radius;
 	}
 
+//
+//  getScalingFactor
+//
+//  Purpose: To determine how much the display list for this
+//           Entity is scaled when it is drawn.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The scaling factor for the display list.
+//  Side Effect: N/A
+//
+	double getScalingFactor () const
+	{
+		assert(isInitialized());
+
+		return m_scaling_factor;
+	}
+
+//
+//  getDisplayList
+//
+//  Purpose: To retrieve the display list for this Entity.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The DisplayList this Entity is drawn with.
+//  Side Effect: N/A
+//
+	const ObjLibrary::DisplayList& getDisplayList () const
+	{
+		assert(isInitialized());
+
+		return m_display_list;
+	}
+
+//
+//  isInBodies
+//
+//  Purpose: To determine whether the physics state of this
+//           Entity is stored in a PhysicsBodies.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether moveIntoBodies has been called for this
+//           Entity.
+//  Side Effect: N/A
+//
+	bool isInBodies () const
+	{
+		return mp_bodies != nullptr;
+	}
+
+//
+//  getBodyIndex
+//
+//  Purpose: To determine which body in its PhysicsBodies stores
+//           the physics state of this Entity.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInBodies()
+//  Returns: The index of the body for this Entity.
+//  Side Effect: N/A
+//
+	unsigned int getBodyIndex () const
+	{
+		assert(isInBodies());
+
+		return m_body;
+	}
+
+#ifndef GAME_HEADLESS
 //
 //  draw
 //
@@ -233,6 +324,21 @@ public:
 //  Side Effect: This Entity is displayed.
 //
 	virtual void draw () const;
+#endif  // GAME_HEADLESS is not defined
+
+//
+//  setPosition
+//
+//  Purpose: To move this Entity to the specified position.
+//  Parameter(s):
+//    <1> position: The new position
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The origin of this Entity is moved to position
+//               position.  Its orientation is unchanged.
+//
+	void setPosition (const ObjLibrary::Vector3& position);
 
 //
 //  setVelocity
@@ -248,6 +354,21 @@ public:
 //
 	void setVelocity (const ObjLibrary::Vector3& velocity);
 
+//
+//  setDisplayList
+//
+//  Purpose: To change how this Entity is displayed.
+//  Parameter(s):
+//    <1> display_list: The new DisplayList
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> display_list.isReady()
+//  Returns: N/A
+//  Side Effect: This Entity is displayed with DisplayList
+//               display_list from now on.
+//
+	void setDisplayList (const ObjLibrary::DisplayList& display_list);
+
 //
 //  addVelocity
 //
@@ -263,6 +384,49 @@ public:
 //
 	void addVelocity (const ObjLibrary::Vector3& delta);
 
+//
+//  moveIntoBodies
+//
+//  Purpose: To move the physics state of this Entity into a
+//           new body in the specified PhysicsBodies.
+//  Parameter(s):
+//    <1> r_bodies: The PhysicsBodies
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> !isInBodies()
+//  Returns: N/A
+//  Side Effect: A body is added to r_bodies with the position,
+//               orientation, velocity, mass, and rotation of
+//               this Entity.  This Entity becomes a handle to
+//               that body.  r_bodies must not be moved or
+//               destroyed while this Entity (or any copy of it)
+//               is in use.
+//
+	void moveIntoBodies (PhysicsBodies& r_bodies);
+
+//
+//  moveIntoBodies
+//
+//  Purpose: To move the physics state of this Entity into an
+//           existing body in the specified PhysicsBodies.
+//  Parameter(s):
+//    <1> r_bodies: The PhysicsBodies
+//    <2> body: Which body to replace
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> !isInBodies()
+//    <3> body < r_bodies.getCount()
+//  Returns: N/A
+//  Side Effect: Body body in r_bodies is replaced with the
+//               position, orientation, velocity, mass, and
+//               rotation of this Entity and this Entity becomes
+//               a handle to it, as above.  This is used to
+//               reuse the body of an Entity that is no longer
+//               needed.
+//
+	void moveIntoBodies (PhysicsBodies& r_bodies,
+	                     unsigned int body);
+
 //
 //  updatePhysics
 //
@@ -277,9 +441,9 @@ public:
 //  Returns: N/A
 //  Side Effect: This Entity is updated for one time step.  The
 //               default implementation accelerates this Entity
-//               according to the gravity of black_hole and then
-//               moves this Entity based on its updated
-//               velocity.
+//               according to the gravity of black_hole, moves
+//               this Entity based on its updated velocity, and
+//               then rotates it around its rotation axis.
 //
 	virtual void updatePhysics (double delta_time,
 	                            const Entity& black_hole);
@@ -302,11 +466,68 @@ protected:
 		assert(isInitialized());
 		assert(mass > 0.0);
 
-		m_mass = mass;
+		if(mp_bodies != nullptr)
+			mp_bodies->setMass(m_body, mass);
+		else
+			m_mass = mass;
 
 		assert(invariant());
 	}
 
+//
+//  setRotation
+//
+//  Purpose: To change the constant rotation of this Entity.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> rate: The rotation rate in radians per second
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> !isInBodies()
+//    <3> axis.isUnit()
+//    <4> rate >= 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is set to rotate around axis at
+//               rate radians per second.
+//
+	void setRotation (const ObjLibrary::Vector3& axis,
+	                  double rate);
+
+//
+//  setOrientation
+//
+//  Purpose: To change the orientation of this Entity.
+//  Parameter(s):
+//    <1> coords: A coordinate system with the new orientation
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: This Entity is turned to have the same forward,
+//               up, and right vectors as coords.  Its position
+//               is unchanged.
+//
+	void setOrientation (const CoordinateSystem& coords);
+
+//
+//  setBodyActive
+//
+//  Purpose: To change whether the body for this Entity is moved
+//           when its PhysicsBodies is updated.
+//  Parameter(s):
+//    <1> is_active: Whether the body should be moved
+//  Preconditions:
+//    <1> isInBodies()
+//  Returns: N/A
+//  Side Effect: The body for this Entity is marked as active
+//               or inactive.
+//
+	void setBodyActive (bool is_active)
+	{
+		assert(isInBodies());
+
+		mp_bodies->setActive(m_body, is_active);
+	}
+
 private:
 //
 //  invariant
@@ -320,6 +541,8 @@ private:
 	bool invariant () const;
 
 protected:
+	// not used after moveIntoBodies, so subclasses that access
+	//  these directly must never be moved into a PhysicsBodies
 	CoordinateSystem m_coords;
 	ObjLibrary::Vector3 m_velocity;
 
@@ -328,6 +551,10 @@ private:
 	double m_radius;
 	ObjLibrary::DisplayList m_display_list;
 	double m_scaling_factor;
+	ObjLibrary::Vector3 m_rotation_axis;
+	double m_rotation_rate;
+	PhysicsBodies* mp_bodies;
+	unsigned int m_body;
 };
 
 
@@ -0,0 +1,102 @@
+//
+//  Frustum.cpp
+//
+
+#include "Frustum.h"
+
+#include <cassert>
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace ObjLibrary;
+namespace
+{
+	const double NORMAL_TOLERANCE = 1.0e-6;
+}
+
+
+
+const unsigned int Frustum :: PLANE_COUNT;  // value is set in header file
+
+
+
+Frustum :: Frustum ()
+{
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+	{
+		ma_normals[p]   = Vector3::ZERO;
+		ma_distances[p] = 0.0;
+	}
+
+	assert(invariant());
+}
+
+Frustum :: Frustum (const double a_projection[16],
+                    const double a_model_view[16])
+{
+	assert(a_projection != nullptr);
+	assert(a_model_view != nullptr);
+
+	// combined matrix, column-major like OpenGL
+	double a_clip[16];
+	for(unsigned int column = 0; column < 4; column++)
+		for(unsigned int row = 0; row < 4; row++)
+		{
+			double sum = 0.0;
+			for(unsigned int k = 0; k < 4; k++)
+				sum += a_projection[k * 4 + row] * a_model_view[column * 4 + k];
+			a_clip[column * 4 + row] = sum;
+		}
+
+	//
+	//  Each plane is the last row of the matrix plus or minus
+	//    one of the other rows (Gribb and Hartmann):
+	//    left, right, bottom, top, near, and far.
+	//
+
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+	{
+		unsigned int row = p / 2;
+		double sign = (p % 2 == 0) ? 1.0 : -1.0;
+
+		Vector3 normal(a_clip[ 3] + sign * a_clip[     row],
+		               a_clip[ 7] + sign * a_clip[ 4 + row],
+		               a_clip[11] + sign * a_clip[ 8 + row]);
+		double distance = a_clip[15] + sign * a_clip[12 + row];
+
+		double length = normal.getNorm();
+		assert(length > 0.0);
+		ma_normals[p]   = normal / length;
+		ma_distances[p] = distance / length;
+	}
+
+	assert(invariant());
+}
+
+
+
+bool Frustum :: isSphereVisible (const ObjLibrary::Vector3& center,
+                                 double radius) const
+{
+	assert(radius >= 0.0);
+
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+	{
+		if(ma_normals[p].dotProduct(center) + ma_distances[p] < -radius)
+			return false;
+	}
+	return true;
+}
+
+
+
+bool Frustum :: invariant () const
+{
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+	{
+		double norm = ma_normals[p].getNorm();
+		if(norm != 0.0 && (norm < 1.0 - NORMAL_TOLERANCE || norm > 1.0 + NORMAL_TOLERANCE))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,105 @@
+//
+//  Frustum.h
+//
+//  A module to represent the volume of space a camera can see.
+//
+
+#pragma once
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  Frustum
+//
+//  A class to represent the volume of space that can be seen
+//    with a perspective camera.  The volume is bounded by 6
+//    planes (left, right, bottom, top, near, and far), which
+//    are found from the projection and model view matrices set
+//    up for the camera.  This is used to avoid drawing things
+//    that would not be seen anyway.
+//
+//  Class Invariant:
+//    <1> The normal of each plane is a unit vector or zero
+//
+class Frustum
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a Frustum that contains everything.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new Frustum is created.  All spheres are
+//               visible in it.
+//
+	Frustum ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a Frustum for the camera with the
+//           specified matrices.
+//  Parameter(s):
+//    <1> a_projection: The projection matrix
+//    <2> a_model_view: The model view matrix
+//  Preconditions:
+//    <1> a_projection and a_model_view each contain 16
+//        elements in column-major order, as returned by
+//        glGetDoublev
+//    <2> a_projection is a perspective projection
+//  Returns: N/A
+//  Side Effect: A new Frustum is created for the volume that
+//               is drawn with the specified matrices.  The
+//               Frustum is in world coordinates if a_model_view
+//               only contains the camera transformation.
+//
+	Frustum (const double a_projection[16],
+	         const double a_model_view[16]);
+
+	Frustum (const Frustum& to_copy) = default;
+	~Frustum () = default;
+	Frustum& operator= (const Frustum& to_copy) = default;
+
+//
+//  isSphereVisible
+//
+//  Purpose: To determine whether any part of the specified
+//           sphere may be inside this Frustum.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Preconditions:
+//    <1> radius >= 0.0
+//  Returns: Whether the sphere is not entirely outside one of
+//           the planes bounding this Frustum.  A sphere near a
+//           corner may be counted as visible even if it is not,
+//           but a sphere that is visible is never counted as
+//           not visible.
+//  Side Effect: N/A
+//
+	bool isSphereVisible (const ObjLibrary::Vector3& center,
+	                      double radius) const;
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	static const unsigned int PLANE_COUNT = 6;
+
+private:
+	ObjLibrary::Vector3 ma_normals[PLANE_COUNT];  // point inwards
+	double ma_distances[PLANE_COUNT];  // plane is normal * x + distance = 0
+};
@@ -7,12 +7,25 @@
 #include <cassert>
 #include <climits>
 #include <vector>
-#include <algorithm>  // for min/max
+#include <algorithm>  // for min/max/sort
+#include <utility>    // for pair
+#include <chrono>
+#include <iostream>
+
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+	#include "CubeSphere.h"
+#endif
 
-#include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
+#ifndef GAME_HEADLESS
+	#include "ObjLibrary/Material.h"
+	#include "ObjLibrary/MtlLibrary.h"
+	#include "ObjLibrary/IndexedMesh.h"
+#endif
 
 #include "Gravity.h"
 #include "CoordinateSystem.h"
@@ -21,17 +34,27 @@
 #include "Asteroid.h"
 #include "Crystal.h"
 #include "Spaceship.h"
+#include "PhysicsBodies.h"
+#include "GravityKernels.h"
 #include "Collisions.h"
+#include "SteeringBehaviours.h"
+#include "BroadPhase.h"
+#include "WorkerPool.h"
+#ifndef GAME_HEADLESS
+	#include "Frustum.h"
+	#include "RenderQueue.h"
+#endif
 
 using namespace std;
+using namespace chrono;
 using namespace ObjLibrary;
 
 namespace
 {
 	const double TWO_PI  = 6.283185307179586476925286766559;
 
-	const unsigned int ASTEROID_COUNT = 100;
-	const unsigned int DRONE_COUNT    = 5;
+	const unsigned int ASTEROID_COUNT      = 100;
+	const unsigned int DEFAULT_DRONE_COUNT = 5;
 
 	const double BLACK_HOLE_RADIUS  =    50.0;
 	const double DISK_RADIUS        = 10000.0;
@@ -39,6 +62,12 @@ namespace
 	const double DRONE_RADIUS       =     2.0;
 	const double DEBUG_MAX_DISTANCE =  2000.0;
 
+	const unsigned int PLAYER_PATH_POINT_COUNT = 1000;
+	const unsigned int DRONE_PATH_POINT_COUNT  =  100;
+
+	// about 17 KB per asteroid, within 1% of the largest radius
+	const unsigned int RADIUS_MAP_RESOLUTION = 64;
+
 	static const double BLACK_HOLE_MASS = 5.0e16;  // kg
 	static const double PLAYER_MASS     = 1000.0;  // kg
 	static const double DRONE_MASS      =  100.0;  // kg
@@ -47,21 +76,111 @@ namespace
 	DisplayList g_disk_display_list;
 	DisplayList g_crystal_display_list;
 	DisplayList g_player_display_list;
-	DisplayList ga_drone_display_lists[DRONE_COUNT];
+
+#ifndef GAME_HEADLESS
+	// the material groups of a model without their materials, for drawing with a RenderQueue
+	struct RenderModel
+	{
+		vector<const Material*> mvp_materials;
+		vector<DisplayList> mv_meshes;
+	};
+	RenderModel g_crystal_render_model;
+	RenderModel g_player_render_model;
+#endif
+
+	// drones cycle through the colours of the Grapple model
+	const unsigned int DRONE_VARIANT_COUNT = 7;
+	DisplayList ga_drone_display_lists[DRONE_VARIANT_COUNT];
+#ifndef GAME_HEADLESS
+	RenderModel ga_drone_render_models[DRONE_VARIANT_COUNT];
+	const string DRONE_MATERIAL[DRONE_VARIANT_COUNT] =
+	{
+		"grapple_body_red",
+		"grapple_body_orange",
+		"grapple_body_yellow",
+		"grapple_body_green",
+		"grapple_body_cyan",
+		"grapple_body_blue",
+		"grapple_body_purple",
+	};
+	const Vector3 DRONE_AI_COLOUR[DRONE_VARIANT_COUNT] =
+	{
+		Vector3(1.0, 0.0, 0.0),
+		Vector3(1.0, 0.5, 0.0),
+		Vector3(1.0, 1.0, 0.0),
+		Vector3(0.0, 1.0, 0.0),
+		Vector3(0.0, 1.0, 1.0),
+		Vector3(0.0, 0.0, 1.0),
+		Vector3(0.5, 0.0, 1.0),
+	};
+#endif
+
+	// escort positions are in rings around the player, with more in the outer rings
+	const Vector3 DRONE_OFFSET_BASE(0.0, 10.0, 0.0);
+	const unsigned int DRONE_ESCORT_RING_COUNT_BASE = 5;
 
 	static const unsigned int ASTEROID_MODEL_COUNT = 25;
-	ObjModel ga_asteroid_models[ASTEROID_MODEL_COUNT];
+	static const unsigned int ASTEROID_SUBDIVISIONS = 8;  // 768 triangles
+	DisplayList g_asteroid_display_list;  // placeholder
+#ifndef GAME_HEADLESS
+	// each level has half the subdivisions of the one before
+	const unsigned int ASTEROID_DETAIL_LEVEL_COUNT = 3;
+	ObjModel ga_asteroid_models[ASTEROID_DETAIL_LEVEL_COUNT][ASTEROID_MODEL_COUNT];
+	const Material* gap_asteroid_materials[ASTEROID_MODEL_COUNT];  // meshes have no materials
+	unsigned int ga_asteroid_triangle_counts[ASTEROID_DETAIL_LEVEL_COUNT];
+	bool g_is_asteroid_acmr_reported = false;  // only for the first game, not every restart
+
+	// projected radius in pixels needed to use each level but the last
+	const double ASTEROID_DETAIL_MIN_PIXELS[ASTEROID_DETAIL_LEVEL_COUNT - 1] =
+	{
+		100.0,
+		 25.0,
+	};
+	const double ASTEROID_DETAIL_HYSTERESIS = 0.2;  // fraction of the limit
+
+	// ACMR is reported for a first-in-first-out cache of a typical hardware size
+	const unsigned int ACMR_CACHE_SIZE = 16;
+#endif
 
 	const double CRYSTAL_KNOCK_OFF_RANGE = 200.0;
 	const unsigned int CRYSTAL_KNOCK_OFF_COUNT = 10;
 	const double CRYSTAL_KNOCK_OFF_SPEED = 10.0;
+	const double CRYSTAL_GRID_CELL_SIZE = 1000.0;  // about how far drones look for crystals
+	const unsigned int NO_DRONE = UINT_MAX;
+	const double ASTEROID_GRID_CELL_SIZE = 1000.0;  // about how far drones look for asteroids
+	const double ASTEROID_GRID_SEARCH_MARGIN = 1.0;  // for rounding errors
 
 	const double  CAMERA_BACK_DISTANCE  =   20.0;
 	const double  CAMERA_UP_DISTANCE    =    5.0;
 	const double  PLAYER_START_DISTANCE = 1000.0;
 	const Vector3 PLAYER_START_FORWARD(1.0, 0.0, 0.0);
 
+	const unsigned int COLLISION_GROUP_ASTEROID = 0;
+	const unsigned int COLLISION_GROUP_CRYSTAL  = 1;
+	const unsigned int COLLISION_GROUP_SHIP     = 2;  // player is 0, drone d is d + 1
+
+	// fewer than this is faster to do than to wake another thread for
+	const unsigned int MIN_PAIRS_PER_THREAD = 64;
+	const unsigned int MIN_ASTEROIDS_PER_THREAD = 4;
+	const unsigned int MIN_DRONES_PER_THREAD = 8;
+
+
+
 
+	double getSecondsSince (steady_clock::time_point& r_last_time)
+	{
+		steady_clock::time_point now = steady_clock::now();
+		duration<double> elapsed = now - r_last_time;
+		r_last_time = now;
+		return elapsed.count();
+	}
+
+	void moveEntity (Entity& r_entity, double delta_time)
+	{
+		// not setPosition if not moving, so orbits are not recalculated
+		if(delta_time != 0.0)
+			r_entity.setPosition(r_entity.getPosition() + r_entity.getVelocity() * delta_time);
+	}
 
 	double random01 ()
 	{
@@ -75,6 +194,154 @@ namespace
 		return min_value + random01() * (max_value - min_value);
 	}
 
+	Asteroid createAsteroid (const Vector3& position,
+	                         const Vector3& velocity,
+	                         double inner_radius,
+	                         double outer_radius)
+	{
+		// the real model is added later, see initAsteroids
+		assert(g_asteroid_display_list.isReady());
+		return Asteroid(position, velocity, inner_radius, outer_radius,
+		                g_asteroid_display_list);
+	}
+
+#ifndef GAME_HEADLESS
+	// how far each model reaches from its origin, for culling
+	double g_crystal_model_radius = 1.0;
+	double g_player_model_radius  = 1.0;
+	double g_drone_model_radius   = 1.0;
+
+	double calculateModelRadius (const ObjModel& model)
+	{
+		double radius = 0.0;
+		for(unsigned int v = 0; v < model.getVertexCount(); v++)
+		{
+			double distance = model.getVertexPosition(v).getNorm();
+			if(distance > radius)
+				radius = distance;
+		}
+		return radius;
+	}
+
+	bool isVisible (const Frustum& frustum,
+	                const Entity& entity,
+	                double model_radius,
+	                Game::DrawCounts& r_counts)
+	{
+		// the collision radius is larger for asteroids
+		double radius = entity.getScalingFactor() * model_radius;
+		if(radius < entity.getRadius())
+			radius = entity.getRadius();
+
+		if(frustum.isSphereVisible(entity.getPosition(), radius))
+		{
+			r_counts.m_drawn++;
+			return true;
+		}
+		else
+		{
+			r_counts.m_culled++;
+			return false;
+		}
+	}
+
+	// returns the ACMR before and after
+	pair<double, double> optimizeIndexedMesh (IndexedMesh& r_indexed)
+	{
+		double before = r_indexed.calculateAcmr(ACMR_CACHE_SIZE);
+		r_indexed.optimizeVertexCache();
+		r_indexed.optimizeVertexFetch();
+		return make_pair(before, r_indexed.calculateAcmr(ACMR_CACHE_SIZE));
+	}
+
+	RenderModel createRenderModel (const ObjModel& model)
+	{
+		IndexedMesh indexed(model);
+		pair<double, double> acmr = optimizeIndexedMesh(indexed);
+		cout << "Vertex cache ACMR for " << model.getFileName() << ": "
+		     << acmr.first << " -> " << acmr.second << endl;
+
+		RenderModel render_model;
+		for(unsigned int g = 0; g < indexed.getGroupCount(); g++)
+		{
+			render_model.mvp_materials.push_back(indexed.getGroupMaterial(g));
+			render_model.mv_meshes.push_back(indexed.getDisplayListGroupMaterialNone(g));
+		}
+		return render_model;
+	}
+
+	const Material* findMaterial (const ObjModel& model,
+	                              const string& name)
+	{
+		for(unsigned int i = 0; i < model.getMaterialLibraryCount(); i++)
+		{
+			const MtlLibrary* p_library = model.getMaterialLibrary(i);
+			if(p_library == nullptr)
+				continue;
+
+			unsigned int index = p_library->getMaterialIndex(name);
+			if(index != MtlLibrary::NO_SUCH_MATERIAL)
+				return p_library->getMaterial(index);
+		}
+		return nullptr;
+	}
+
+	void addToRenderQueue (RenderQueue& r_queue,
+	                       const RenderModel& render_model,
+	                       const Entity& entity)
+	{
+		for(unsigned int m = 0; m < render_model.mv_meshes.size(); m++)
+		{
+			r_queue.add(render_model.mvp_materials[m], render_model.mv_meshes[m],
+			            entity.getCoordinateSystem(), entity.getScalingFactor());
+		}
+	}
+
+	unsigned int chooseDetailLevel (unsigned int current,
+	                                double pixels,
+	                                unsigned int level_count)
+	{
+		assert(current < level_count);
+		assert(level_count <= ASTEROID_DETAIL_LEVEL_COUNT);
+
+		// only change when well past the limit, so it does not switch back and forth
+		unsigned int level = current;
+		while(level > 0 &&
+		      pixels > ASTEROID_DETAIL_MIN_PIXELS[level - 1] * (1.0 + ASTEROID_DETAIL_HYSTERESIS))
+		{
+			level--;
+		}
+		while(level + 1 < level_count &&
+		      pixels < ASTEROID_DETAIL_MIN_PIXELS[level] * (1.0 - ASTEROID_DETAIL_HYSTERESIS))
+		{
+			level++;
+		}
+		return level;
+	}
+#endif  // GAME_HEADLESS is not defined
+
+	Vector3 calculateEscortOffset (unsigned int drone,
+	                               unsigned int drone_count)
+	{
+		assert(drone < drone_count);
+
+		// ring r holds (r + 1) times as many drones and is (r + 1) times as far out
+		unsigned int ring       = 0;
+		unsigned int ring_first = 0;
+		unsigned int ring_count = DRONE_ESCORT_RING_COUNT_BASE;
+		while(drone >= ring_first + ring_count)
+		{
+			ring++;
+			ring_first += ring_count;
+			ring_count = DRONE_ESCORT_RING_COUNT_BASE * (ring + 1);
+		}
+		if(ring_first + ring_count > drone_count)
+			ring_count = drone_count - ring_first;  // outer ring is not full
+
+		double radians = (drone - ring_first) * TWO_PI / ring_count;
+		return (DRONE_OFFSET_BASE * (ring + 1.0)).getRotatedX(radians);
+	}
+
 }  // end of anonymous namespace
 
 
@@ -84,37 +351,89 @@ bool Game :: isModelsLoaded ()
 	return g_skybox_display_list.isReady();
 }
 
-void Game :: loadModels (const std::string& path)
+unsigned int Game :: getDefaultDroneCount ()
 {
-	assert(!isModelsLoaded());
+	return DEFAULT_DRONE_COUNT;
+}
 
-	assert(DRONE_COUNT == 5);
-	static const string DRONE_MATERIAL[DRONE_COUNT] =
-	{
-		"grapple_body_red",
-		"grapple_body_orange",
-		"grapple_body_yellow",
-		"grapple_body_green",
-		"grapple_body_cyan",
-	};
+void Game :: loadModels (const std::string& path)
+{
+	loadModels(path, ASTEROID_SUBDIVISIONS);
+}
 
+void Game :: loadModels (const std::string& path,
+                         unsigned int asteroid_subdivisions)
+{
+	assert(!isModelsLoaded());
+	assert(asteroid_subdivisions >= 1);
+
+#ifdef GAME_HEADLESS
+	// there are no models without OpenGL, so share a placeholder
+	(void)(path);
+	(void)(asteroid_subdivisions);
+	DisplayList placeholder;
+	placeholder.begin();
+	placeholder.end();
+
+	g_skybox_display_list   = placeholder;
+	g_disk_display_list     = placeholder;
+	g_crystal_display_list  = placeholder;
+	g_player_display_list   = placeholder;
+	g_asteroid_display_list = placeholder;
+	for(unsigned v = 0; v < DRONE_VARIANT_COUNT; v++)
+		ga_drone_display_lists[v] = placeholder;
+#else
 	g_skybox_display_list  = ObjModel(path + "Skybox.obj")     .getDisplayList();
 	g_disk_display_list    = ObjModel(path + "Disk.obj")       .getDisplayList();
-	g_crystal_display_list = ObjModel(path + "Crystal.obj")    .getDisplayList();
-	g_player_display_list  = ObjModel(path + "Sagittarius.obj").getDisplayList();
 
+	ObjModel crystal_model = ObjModel(path + "Crystal.obj");
+	g_crystal_display_list = crystal_model.getDisplayList();
+	g_crystal_model_radius = calculateModelRadius(crystal_model);
+	g_crystal_render_model = createRenderModel(crystal_model);
+
+	ObjModel player_model = ObjModel(path + "Sagittarius.obj");
+	g_player_display_list = player_model.getDisplayList();
+	g_player_model_radius = calculateModelRadius(player_model);
+	g_player_render_model = createRenderModel(player_model);
+
+	// generate the asteroid base spheres instead of loading them
 	assert(ASTEROID_MODEL_COUNT <= 26);  // only 26 letters to use
-	for(unsigned m = 0; m < ASTEROID_MODEL_COUNT; m++)
+	g_asteroid_display_list.begin();
+	g_asteroid_display_list.end();
+	for(unsigned int level = 0; level < ASTEROID_DETAIL_LEVEL_COUNT; level++)
 	{
-		string filename = "AsteroidA.obj";
-		assert(filename[8] == 'A');
-		filename[8] = 'A' + m;
-		ga_asteroid_models[m].load(path + filename);
+		unsigned int subdivisions = max(asteroid_subdivisions >> level, 1u);
+		ga_asteroid_triangle_counts[level] = CubeSphere::getTriangleCount(subdivisions);
+
+		ObjModel asteroid_sphere = CubeSphere::create(subdivisions);
+		asteroid_sphere.addMaterialLibrary(path + "Asteroid.mtl");
+		for(unsigned m = 0; m < ASTEROID_MODEL_COUNT; m++)
+		{
+			string material = "asteroidA";
+			assert(material[8] == 'A');
+			material[8] = 'A' + m;
+			ga_asteroid_models[level][m] = asteroid_sphere;
+			ga_asteroid_models[level][m].setMeshMaterial(0, material);
+		}
 	}
+	for(unsigned m = 0; m < ASTEROID_MODEL_COUNT; m++)
+		gap_asteroid_materials[m] = ga_asteroid_models[0][m].getMeshMaterial(0);
 
 	ObjModel drone_model = ObjModel(path + "Grapple.obj");
-	for(unsigned d = 0; d < DRONE_COUNT; d++)
-		ga_drone_display_lists[d] = drone_model.getDisplayListMaterial(DRONE_MATERIAL[d]);
+	for(unsigned v = 0; v < DRONE_VARIANT_COUNT; v++)
+		ga_drone_display_lists[v] = drone_model.getDisplayListMaterial(DRONE_MATERIAL[v]);
+	g_drone_model_radius = calculateModelRadius(drone_model);
+
+	// the variants share the meshes
+	RenderModel drone_render_model = createRenderModel(drone_model);
+	for(unsigned v = 0; v < DRONE_VARIANT_COUNT; v++)
+	{
+		ga_drone_render_models[v] = drone_render_model;
+		const Material* p_material = findMaterial(drone_model, DRONE_MATERIAL[v]);
+		for(unsigned int m = 0; m < drone_render_model.mvp_materials.size(); m++)
+			ga_drone_render_models[v].mvp_materials[m] = p_material;
+	}
+#endif
 
 	assert(isModelsLoaded());
 }
@@ -123,18 +442,63 @@ void Game :: loadModels (const std::string& path)
 
 
 Game :: Game ()
-		: m_black_hole(Vector3::ZERO, BLACK_HOLE_MASS,
+		: Game(1, DEFAULT_DRONE_COUNT)
+{
+}
+
+Game :: Game (unsigned int thread_count)
+		: Game(thread_count, DEFAULT_DRONE_COUNT)
+{
+}
+
+Game :: Game (unsigned int thread_count,
+              unsigned int drone_count)
+		: m_time(0.0)
+		, m_black_hole(Vector3::ZERO, BLACK_HOLE_MASS,
 		               BLACK_HOLE_RADIUS, DISK_RADIUS, g_disk_display_list)
+		, m_bodies()      // filled with asteroids and crystals
 		, mv_asteroids()  // initialized below
-		, mv_crystals()   // starts empty
+		, m_radius_map_resolution(RADIUS_MAP_RESOLUTION)
+		, mv_asteroid_detail_levels()
+		, m_asteroid_grid(ASTEROID_GRID_CELL_SIZE)
+		, m_asteroid_radius_max(0.0)
+		, m_asteroid_speed_max(0.0)
+		, m_crystals()    // starts empty
+		, mv_is_crystal_claimed()
+		, m_crystal_grid(CRYSTAL_GRID_CELL_SIZE)
+		, m_is_crystal_grid_current(false)
+		, mv_searching_drones()
+		, mv_crystal_requests()
+		, mv_crystal_winners()
+		, mv_crystal_winner_distances()
 		, m_player()      // initialized below
+		, m_drone_bodies()  // filled with drones
 		, mv_drones()     // initialized below
 		, m_crystals_collected(0)
+		, m_broad_phase()
+		, mv_is_pair_colliding()
+		, mv_pair_impact_times()
+		, mv_ship_hits()
+		, m_collision_count(0)
+		, m_is_continuous_collisions(true)
+		, m_worker_pool(thread_count)
+		, m_phase_times()
+		, m_draw_counts()
+#ifndef GAME_HEADLESS
+		, m_render_queue()
+#endif
 {
 	assert(isModelsLoaded());
+	assert(thread_count >= 1);
+
+	m_broad_phase.setGroupsInteract(COLLISION_GROUP_ASTEROID, COLLISION_GROUP_ASTEROID);
+	m_broad_phase.setGroupsInteract(COLLISION_GROUP_ASTEROID, COLLISION_GROUP_CRYSTAL);
+	m_broad_phase.setGroupsInteract(COLLISION_GROUP_ASTEROID, COLLISION_GROUP_SHIP);
+	m_broad_phase.setGroupsInteract(COLLISION_GROUP_CRYSTAL,  COLLISION_GROUP_SHIP);
 
 	initAsteroids();
-	initSpaceships();
+	initSpaceships(drone_count);
+	updateAsteroidGrid();
 }
 
 
@@ -146,41 +510,123 @@ const Asteroid& Game :: getAsteroid (unsigned int index) const
 	return mv_asteroids[index];
 }
 
-unsigned int Game :: getNonGoneCrystalCount () const
+void Game :: findAsteroidsToAvoid (const Spaceship& agent,
+                                   double max_acceleration,
+                                   std::vector<unsigned int>& r_asteroids) const
 {
-	unsigned int count = 0;
-	for(unsigned c = 0; c < mv_crystals.size(); c++)
-		if(!mv_crystals[c].isGone())
-			count++;
-	return count;
+	assert(max_acceleration > 0.0);
+
+	//
+	//  The grid finds the asteroids that could be close enough
+	//    for the fastest and largest asteroid, and then the
+	//    exact test is done for each of them.
+	//
+
+	r_asteroids.clear();
+	double search_distance = SteeringBehaviours::getAvoidDistanceMax(agent, m_asteroid_radius_max,
+	                                                                 m_asteroid_speed_max, max_acceleration);
+	m_asteroid_grid.findWithin(agent.getPosition(), search_distance + ASTEROID_GRID_SEARCH_MARGIN,
+	                           r_asteroids);
+
+	vector<pair<double, unsigned int> > v_times;
+	for(unsigned int i = 0; i < r_asteroids.size(); i++)
+	{
+		const Asteroid& asteroid = mv_asteroids[r_asteroids[i]];
+		if(SteeringBehaviours::isAvoid(agent, asteroid, max_acceleration))
+		{
+			double time = SteeringBehaviours::getClosestApproachTime(agent, asteroid);
+			v_times.push_back(make_pair(time, r_asteroids[i]));
+		}
+	}
+	sort(v_times.begin(), v_times.end());  // ties by index
+
+	r_asteroids.clear();
+	for(unsigned int i = 0; i < v_times.size(); i++)
+		r_asteroids.push_back(v_times[i].second);
+}
+
+void Game :: setGravityKernel (unsigned int kernel)
+{
+	assert(kernel < GravityKernels::COUNT);
+	assert(GravityKernels::isSupported(kernel));
+
+	m_bodies      .setGravityKernel(kernel);
+	m_drone_bodies.setGravityKernel(kernel);
+}
+
+void Game :: setRadiusMapResolution (unsigned int resolution)
+{
+	m_radius_map_resolution = resolution;
+	m_worker_pool.run(mv_asteroids.size(), MIN_ASTEROIDS_PER_THREAD,
+	                  [this, resolution] (unsigned int begin, unsigned int end)
+	{
+		for(unsigned int a = begin; a < end; a++)
+			mv_asteroids[a].setRadiusMapResolution(resolution);
+	});
+}
+
+unsigned int Game :: getRadiusMapMemorySize () const
+{
+	unsigned int total = 0;
+	for(unsigned a = 0; a < mv_asteroids.size(); a++)
+		total += mv_asteroids[a].getRadiusMapMemorySize();
+	return total;
 }
 
 const Crystal& Game :: getCrystal (unsigned int index) const
 {
 	assert(index < getTotalCrystalCount());
 
-	return mv_crystals[index];
+	return m_crystals.getCrystal(index);
 }
 
-Crystal& Game :: getCrystal (unsigned int index)
+bool Game :: isCrystalClaimed (unsigned int index) const
 {
 	assert(index < getTotalCrystalCount());
+	assert(mv_is_crystal_claimed.size() == getTotalCrystalCount());
 
-	return mv_crystals[index];
+	return mv_is_crystal_claimed[index] != 0;
 }
 
-bool Game :: isCrystalChased (unsigned int index)
+void Game :: updateCrystalGrid ()
 {
-	assert(index < getTotalCrystalCount());
+	m_crystal_grid.clear();
+	for(unsigned int n = 0; n < m_crystals.getLiveCount(); n++)
+	{
+		unsigned int c = m_crystals.getLiveSlot(n);
+		m_crystal_grid.addPoint(c, m_crystals.getCrystal(c).getPosition());
+	}
+	m_crystal_grid.build();
+	m_is_crystal_grid_current = true;
+}
 
-	for(unsigned int d = 0; d < mv_drones.size(); d++)
+unsigned int Game :: findNearestUnclaimedCrystal (const ObjLibrary::Vector3& position,
+                                                  double max_distance,
+                                                  std::vector<unsigned int>& r_crystals_near) const
+{
+	assert(max_distance >= 0.0);
+	assert(m_is_crystal_grid_current);
+
+	r_crystals_near.clear();
+	m_crystal_grid.findWithin(position, max_distance, r_crystals_near);
+
+	unsigned int closest_index    = Spaceship::NO_CRYSTAL;
+	double       closest_distance = max_distance;
+	for(unsigned int n = 0; n < r_crystals_near.size(); n++)
 	{
-		const Spaceship& drone = mv_drones[d];
-		if(drone.isAlive())
-			if(drone.getCrystalChased() == index)
-				return true;
+		unsigned int c = r_crystals_near[n];
+		if(isCrystalClaimed(c))
+			continue;
+
+		double distance = m_crystals.getCrystal(c).getPosition().getDistance(position);
+		if(distance < closest_distance ||
+		   (distance == closest_distance && closest_index != Spaceship::NO_CRYSTAL && c < closest_index))
+		{
+			closest_index    = c;
+			closest_distance = distance;
+		}
 	}
-	return false;
+	return closest_index;
 }
 
 unsigned int Game :: getLivingDroneCount () const
@@ -197,6 +643,7 @@ ObjLibrary::Vector3 Game :: getFollowCameraPosition () const
 	return m_player.getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
 }
 
+#ifndef GAME_HEADLESS
 void Game :: setupFollowCamera () const
 {
 	m_player.setupFollowCamera(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
@@ -206,70 +653,113 @@ void Game :: draw (bool is_show_debug) const
 {
 	static const Vector3 PLAYER_COLOUR(0.0, 0.0, 1.0);
 
-	assert(DRONE_COUNT == 5);
-	static const Vector3 DRONE_AI_COLOUR[DRONE_COUNT] =
-	{
-		Vector3(1.0, 0.0, 0.0),
-		Vector3(1.0, 0.5, 0.0),
-		Vector3(1.0, 1.0, 0.0),
-		Vector3(0.0, 1.0, 0.0),
-		Vector3(0.0, 1.0, 1.0),
-	};
-
 	setupFollowCamera();
+
+	// the model view matrix only has the camera in it now
+	double a_projection[16];
+	double a_model_view[16];
+	glGetDoublev(GL_PROJECTION_MATRIX, a_projection);
+	glGetDoublev(GL_MODELVIEW_MATRIX,  a_model_view);
+	Frustum frustum(a_projection, a_model_view);
+	m_draw_counts.m_drawn  = 0;
+	m_draw_counts.m_culled = 0;
+	m_draw_counts.m_asteroid_triangles = 0;
+	m_render_queue.clear();
+	m_debug_draw.clear();
+
+	// projected radius in pixels is radius * pixel_scale / distance
+	GLint a_viewport[4];
+	glGetIntegerv(GL_VIEWPORT, a_viewport);
+	double pixel_scale = a_projection[5] * a_viewport[3] * 0.5;
+	Vector3 camera_position = getFollowCameraPosition();
+
 	drawSkybox();  // has to be first
 
 	const Vector3& player_position = m_player.getPosition();
 	for(unsigned a = 0; a < mv_asteroids.size(); a++)
 	{
 		const Asteroid& asteroid = mv_asteroids[a];
-		asteroid.draw();
+		if(isVisible(frustum, asteroid, 1.0, m_draw_counts))
+		{
+			double distance = max(asteroid.getPosition().getDistance(camera_position), asteroid.getRadius());
+			double pixels   = asteroid.getRadius() * pixel_scale / distance;
+			unsigned int level = chooseDetailLevel(mv_asteroid_detail_levels[a], pixels,
+			                                       asteroid.getDetailLevelCount());
+			mv_asteroid_detail_levels[a] = level;
+
+			m_render_queue.add(gap_asteroid_materials[a % ASTEROID_MODEL_COUNT],
+			                   asteroid.getDetailDisplayList(level),
+			                   asteroid.getCoordinateSystem(), asteroid.getScalingFactor());
+			m_draw_counts.m_asteroid_triangles += ga_asteroid_triangle_counts[level];
+		}
 
 		if(is_show_debug)
 		{
-			asteroid.drawAxes(asteroid.getRadius() + 50.0);
+			asteroid.drawAxes(m_debug_draw, asteroid.getRadius() + 50.0);
 			if(asteroid.getPosition().isDistanceLessThan(player_position, DEBUG_MAX_DISTANCE))
-				asteroid.drawSurfaceEquators();
+				asteroid.drawSurfaceEquators(m_debug_draw);
 		}
 	}
 
-	for(unsigned c = 0; c < mv_crystals.size(); c++)
+	for(unsigned int n = 0; n < m_crystals.getLiveCount(); n++)
 	{
-		const Crystal& crystal = mv_crystals[c];
-		if(!crystal.isGone())
-			crystal.draw();
+		const Crystal& crystal = m_crystals.getCrystal(m_crystals.getLiveSlot(n));
+		if(isVisible(frustum, crystal, g_crystal_model_radius, m_draw_counts))
+			addToRenderQueue(m_render_queue, g_crystal_render_model, crystal);
 	}
 
+	// paths are drawn even if the ship is not, because they can still be seen
 	if(m_player.isAlive())
 	{
-		m_player.draw();
-		m_player.drawPath(m_black_hole, 1000, PLAYER_COLOUR);
+		if(isVisible(frustum, m_player, g_player_model_radius, m_draw_counts))
+			addToRenderQueue(m_render_queue, g_player_render_model, m_player);
+		m_player.drawPath(m_debug_draw, m_black_hole, m_time, PLAYER_COLOUR);
 	}
 
 	for(unsigned int d = 0; d < mv_drones.size(); d++)
 	{
-		assert(d < DRONE_COUNT);
-
 		const Spaceship& drone = mv_drones[d];
 		if(drone.isAlive())
 		{
-			drone.draw();
-			drone.drawPath(m_black_hole, 100, DRONE_AI_COLOUR[d]);
+			const Vector3& colour = DRONE_AI_COLOUR[d % DRONE_VARIANT_COUNT];
+			if(isVisible(frustum, drone, g_drone_model_radius, m_draw_counts))
+				addToRenderQueue(m_render_queue, ga_drone_render_models[d % DRONE_VARIANT_COUNT], drone);
+			drone.drawPath(m_debug_draw, m_black_hole, m_time, colour);
 			if(is_show_debug)
-				drone.drawAI(*this, DRONE_AI_COLOUR[d]);
+				drone.drawAI(m_debug_draw, *this, colour);
 		}
 	}
 
+	// each material is only activated once
+	m_render_queue.sort();
+	m_draw_counts.m_meshes          = m_render_queue.getItemCount();
+	m_draw_counts.m_material_groups = m_render_queue.getGroupCount();
+	m_render_queue.draw();
+
+	// all the lines and markers at once
+	m_draw_counts.m_debug_lines   = m_debug_draw.getLineCount();
+	m_draw_counts.m_debug_markers = m_debug_draw.getMarkerCount();
+	m_debug_draw.draw();
+
 	m_black_hole.draw();  // must be last
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
 void Game :: update (double delta_time)
 {
+	steady_clock::time_point last_time = steady_clock::now();
 	updateAI(delta_time);
+	m_phase_times.m_ai = getSecondsSince(last_time);
 	updatePhysics(delta_time);
-	handleCollisions();
+	m_phase_times.m_physics = getSecondsSince(last_time);
+	handleCollisions(delta_time);  // sets its own times
+	m_time += delta_time;
+	m_is_crystal_grid_current = false;  // crystals have moved
+
+	// for the drones next update and for drawing
+	updateAsteroidGrid();
 }
 
 void Game :: knockOffCrystals ()
@@ -325,15 +815,12 @@ void Game :: initAsteroids ()
 	double collider_inner_radius1 = OUTER_RADIUS_MAX * INNER_FRACTION_MIN;
 	double collider_inner_radius2 = OUTER_RADIUS_MIN * INNER_FRACTION_MAX;
 
-	assert(1 < ASTEROID_MODEL_COUNT);
-	assert(!ga_asteroid_models[0].isEmpty());
-	assert(!ga_asteroid_models[1].isEmpty());
-	mv_asteroids.push_back(Asteroid(COLLISION_POSITION_1, collider_velocity1,
-	                                collider_inner_radius1, OUTER_RADIUS_MAX,
-	                                ga_asteroid_models[0]));
-	mv_asteroids.push_back(Asteroid(COLLISION_POSITION_2, collider_velocity2,
-	                                collider_inner_radius2, OUTER_RADIUS_MIN,
-	                                ga_asteroid_models[1]));
+	mv_asteroids.push_back(createAsteroid(COLLISION_POSITION_1, collider_velocity1,
+	                                      collider_inner_radius1, OUTER_RADIUS_MAX));
+	mv_asteroids.back().moveIntoBodies(m_bodies);
+	mv_asteroids.push_back(createAsteroid(COLLISION_POSITION_2, collider_velocity2,
+	                                      collider_inner_radius2, OUTER_RADIUS_MIN));
+	mv_asteroids.back().moveIntoBodies(m_bodies);
 
 	// create remaining asteroids
 	for(unsigned a = 2; a < ASTEROID_COUNT; a++)
@@ -357,18 +844,81 @@ void Game :: initAsteroids ()
 		double inner_fraction = random2(INNER_FRACTION_MIN, INNER_FRACTION_MAX);
 		double inner_radius   = outer_radius * inner_fraction;
 
-		unsigned int model_index = a % ASTEROID_MODEL_COUNT;
-		assert(model_index < ASTEROID_MODEL_COUNT);
-		assert(!ga_asteroid_models[model_index].isEmpty());
-
-		mv_asteroids.push_back(Asteroid(position, velocity,
-		                                inner_radius, outer_radius,
-		                                ga_asteroid_models[model_index]));
+		mv_asteroids.push_back(createAsteroid(position, velocity,
+		                                      inner_radius, outer_radius));
+		mv_asteroids.back().moveIntoBodies(m_bodies);
 	}
 	assert(mv_asteroids.size() == ASTEROID_COUNT);
+
+	//
+	//  The radius tables and meshes take most of the time, and
+	//    each asteroid's are independent, so calculate them on
+	//    the worker threads.  The random numbers were all chosen
+	//    above, so the results do not depend on the thread count.
+	//    OpenGL can only be used on this thread, so the indexed
+	//    meshes are turned into DisplayLists afterwards.
+	//
+
+#ifndef GAME_HEADLESS
+	assert(1 < ASTEROID_MODEL_COUNT);
+	vector<IndexedMesh> v_meshes(mv_asteroids.size() * ASTEROID_DETAIL_LEVEL_COUNT);
+	vector<pair<double, double>> v_acmrs(v_meshes.size());
+#endif
+	m_worker_pool.run(mv_asteroids.size(), MIN_ASTEROIDS_PER_THREAD,
+	                  [&] (unsigned int begin, unsigned int end)
+	{
+		for(unsigned int a = begin; a < end; a++)
+		{
+			Asteroid& asteroid = mv_asteroids[a];
+			asteroid.setRadiusMapResolution(m_radius_map_resolution);
+#ifndef GAME_HEADLESS
+			// same noise at every level, so the shape does not change
+			for(unsigned int level = 0; level < ASTEROID_DETAIL_LEVEL_COUNT; level++)
+			{
+				const ObjModel& base_model = ga_asteroid_models[level][a % ASTEROID_MODEL_COUNT];
+				assert(!base_model.isEmpty());
+				ObjModel model = Asteroid::createModel(base_model,
+				                                       asteroid.getInnerRadius(),
+				                                       asteroid.getRadius(),
+				                                       asteroid.getNoiseOffset());
+				unsigned int index = a * ASTEROID_DETAIL_LEVEL_COUNT + level;
+				v_meshes[index] = IndexedMesh(model);
+				v_acmrs[index] = optimizeIndexedMesh(v_meshes[index]);
+			}
+#endif
+		}
+	});
+
+#ifndef GAME_HEADLESS
+	for(unsigned int a = 0; a < mv_asteroids.size(); a++)
+	{
+		// the material is chosen when drawing, see gap_asteroid_materials
+		const IndexedMesh* a_asteroid_meshes = &v_meshes[a * ASTEROID_DETAIL_LEVEL_COUNT];
+		mv_asteroids[a].setDisplayList(a_asteroid_meshes[0].getDisplayListMaterialNone());
+		for(unsigned int level = 1; level < ASTEROID_DETAIL_LEVEL_COUNT; level++)
+			mv_asteroids[a].addLowerDetailDisplayList(a_asteroid_meshes[level].getDisplayListMaterialNone());
+	}
+
+	if(!g_is_asteroid_acmr_reported)
+	{
+		for(unsigned int level = 0; level < ASTEROID_DETAIL_LEVEL_COUNT; level++)
+		{
+			pair<double, double> sum(0.0, 0.0);
+			for(unsigned int a = 0; a < mv_asteroids.size(); a++)
+			{
+				sum.first  += v_acmrs[a * ASTEROID_DETAIL_LEVEL_COUNT + level].first;
+				sum.second += v_acmrs[a * ASTEROID_DETAIL_LEVEL_COUNT + level].second;
+			}
+			cout << "Vertex cache ACMR for asteroid detail level " << level << ": "
+			     << sum.first / mv_asteroids.size() << " -> " << sum.second / mv_asteroids.size() << endl;
+		}
+		g_is_asteroid_acmr_reported = true;
+	}
+#endif
+	mv_asteroid_detail_levels.assign(mv_asteroids.size(), 0);
 }
 
-void Game :: initSpaceships ()
+void Game :: initSpaceships (unsigned int drone_count)
 {
 	const double PLAYER_FORWARD_POWER  = 500.0;  // m/s^2
 	const double PLAYER_MANEUVER_POWER =  50.0;  // m/s^2
@@ -377,7 +927,6 @@ void Game :: initSpaceships ()
 	const double DRONE_FORWARD_POWER  = 250.0;  // m/s^2
 	const double DRONE_MANEUVER_POWER =  25.0;  // m/s^2
 	const double DRONE_ROTATION_RATE  =   1.0;  // radians / second
-	static const Vector3 DRONE_OFFSET_BASE(0.0, 10.0, 0.0);
 
 	double  player_speed    = getCircularOrbitSpeed(PLAYER_START_DISTANCE);
 	Vector3 player_position(0.0, PLAYER_START_DISTANCE, 0.0);
@@ -388,18 +937,24 @@ void Game :: initSpaceships ()
 	                     PLAYER_MASS, PLAYER_RADIUS,
 	                     PLAYER_FORWARD_POWER, PLAYER_MANEUVER_POWER, PLAYER_ROTATION_RATE,
 	                     g_player_display_list, Vector3::ZERO);
+	m_player.setPathPointCount(PLAYER_PATH_POINT_COUNT);
 
-	for(unsigned int d = 0; d < DRONE_COUNT; d++)
+	// drones change their velocity almost every time step, so orbits would not help
+	m_drone_bodies.setKeplerOrbits(false);
+	mv_drones.reserve(drone_count);
+	for(unsigned int d = 0; d < drone_count; d++)
 	{
-		double radians = d * TWO_PI / DRONE_COUNT;
-		Vector3 drone_offset = DRONE_OFFSET_BASE.getRotatedX(radians);
+		Vector3 drone_offset = calculateEscortOffset(d, drone_count);
 		Vector3 drone_position = player_position + drone_offset;
 
-		assert(ga_drone_display_lists[d].isReady());
+		const DisplayList& display_list = ga_drone_display_lists[d % DRONE_VARIANT_COUNT];
+		assert(display_list.isReady());
 		mv_drones.push_back(Spaceship(drone_position, player_velocity,
 		                              DRONE_MASS, DRONE_RADIUS,
 		                              DRONE_FORWARD_POWER, DRONE_MANEUVER_POWER, DRONE_ROTATION_RATE,
-		                              ga_drone_display_lists[d], drone_offset));
+		                              display_list, drone_offset));
+		mv_drones.back().setPathPointCount(DRONE_PATH_POINT_COUNT);
+		mv_drones.back().moveIntoBodies(m_drone_bodies);
 	}
 }
 
@@ -410,8 +965,24 @@ double Game :: getCircularOrbitSpeed (double distance)
 	return sqrt(GRAVITY * m_black_hole.getMass() / distance);
 }
 
+void Game :: updateAsteroidGrid ()
+{
+	m_asteroid_grid.clear();
+	m_asteroid_radius_max = 0.0;
+	m_asteroid_speed_max  = 0.0;
+	for(unsigned int a = 0; a < mv_asteroids.size(); a++)
+	{
+		const Asteroid& asteroid = mv_asteroids[a];
+		m_asteroid_grid.addPoint(a, asteroid.getPosition());
+		m_asteroid_radius_max = max(m_asteroid_radius_max, asteroid.getRadius());
+		m_asteroid_speed_max  = max(m_asteroid_speed_max,  asteroid.getVelocity().getNorm());
+	}
+	m_asteroid_grid.build();
+}
+
 
 
+#ifndef GAME_HEADLESS
 void Game :: drawSkybox () const
 {
 	glPushMatrix();
@@ -425,40 +996,136 @@ void Game :: drawSkybox () const
 		glDepthMask(GL_TRUE);
 	glPopMatrix();
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
 void Game :: updateAI (double delta_time)
 {
+	updateCrystalsChased();
+
+	// each drone only changes itself, so they can all steer at once
+	m_worker_pool.run(mv_drones.size(), MIN_DRONES_PER_THREAD,
+	                  [this, delta_time] (unsigned int begin, unsigned int end)
+	{
+		for(unsigned int d = begin; d < end; d++)
+		{
+			Spaceship& drone = mv_drones[d];
+			if(drone.isAlive())
+				drone.updateSteering(delta_time, *this);
+		}
+	});
+}
+
+void Game :: updateCrystalsChased ()
+{
+	//
+	//  The drones choose crystals in rounds.  In each round,
+	//    every drone that is looking finds the nearest crystal
+	//    that was unclaimed when the round started.  The
+	//    searches only read the game, so they are split between
+	//    the threads.  Then each crystal chosen goes to the
+	//    nearest drone that chose it, with ties going to the
+	//    lower drone index, and the other drones look again in
+	//    the next round.  The result does not depend on the
+	//    number of threads.
+	//
+
+	// crystals chased from earlier updates stay claimed
+	mv_is_crystal_claimed.assign(m_crystals.getSlotCount(), 0);
+	mv_searching_drones.clear();
 	for(unsigned int d = 0; d < mv_drones.size(); d++)
 	{
 		Spaceship& drone = mv_drones[d];
-		if(drone.isAlive())
-			drone.updateAI(delta_time, *this);
+		if(!drone.isAlive())
+			continue;
+
+		drone.abandonGoneCrystal(*this);
+		if(drone.getCrystalChased() == Spaceship::NO_CRYSTAL)
+			mv_searching_drones.push_back(d);
+		else
+			mv_is_crystal_claimed[drone.getCrystalChased()] = 1;
+	}
+
+	// most updates have no drones looking, so only build when needed
+	if(mv_searching_drones.empty())
+		return;
+	updateCrystalGrid();
+
+	// a crystal won is claimed, so it is never chosen again
+	mv_crystal_winners.assign(m_crystals.getSlotCount(), NO_DRONE);
+	mv_crystal_winner_distances.assign(m_crystals.getSlotCount(), 0.0);
+
+	while(!mv_searching_drones.empty())
+	{
+		mv_crystal_requests.resize(mv_searching_drones.size());
+		m_worker_pool.run(mv_searching_drones.size(), MIN_DRONES_PER_THREAD,
+		                  [this] (unsigned int begin, unsigned int end)
+		{
+			vector<unsigned int> v_crystals_near;
+			for(unsigned int s = begin; s < end; s++)
+			{
+				const Spaceship& drone = mv_drones[mv_searching_drones[s]];
+				mv_crystal_requests[s] = drone.findCrystalToChase(*this, v_crystals_near);
+			}
+		});
+
+		// drones are in index order, so the first of a tie wins
+		for(unsigned int s = 0; s < mv_searching_drones.size(); s++)
+		{
+			unsigned int c = mv_crystal_requests[s];
+			if(c == Spaceship::NO_CRYSTAL)
+				continue;
+
+			unsigned int d = mv_searching_drones[s];
+			double distance = m_crystals.getCrystal(c).getPosition().getDistance(mv_drones[d].getPosition());
+			if(mv_crystal_winners[c] == NO_DRONE || distance < mv_crystal_winner_distances[c])
+			{
+				mv_crystal_winners[c]          = d;
+				mv_crystal_winner_distances[c] = distance;
+			}
+		}
+
+		// drones that found nothing stop looking until next update
+		unsigned int loser_count = 0;
+		for(unsigned int s = 0; s < mv_searching_drones.size(); s++)
+		{
+			unsigned int c = mv_crystal_requests[s];
+			if(c == Spaceship::NO_CRYSTAL)
+				continue;
+
+			unsigned int d = mv_searching_drones[s];
+			if(mv_crystal_winners[c] == d)
+			{
+				mv_drones[d].chaseCrystal(c);
+				mv_is_crystal_claimed[c] = 1;
+			}
+			else
+			{
+				assert(loser_count <= s);
+				mv_searching_drones[loser_count] = d;
+				loser_count++;
+			}
+		}
+		mv_searching_drones.resize(loser_count);
 	}
 }
 
 void Game :: updatePhysics (double delta_time)
 {
-	for(unsigned a = 0; a < mv_asteroids.size(); a++)
-		mv_asteroids[a].updatePhysics(delta_time, m_black_hole);
-
-	for(unsigned c = 0; c < mv_crystals.size(); c++)
-		if(!mv_crystals[c].isGone())
-			mv_crystals[c].updatePhysics(delta_time, m_black_hole);
+	// asteroids and live crystals (gone crystals are inactive)
+	m_bodies.updatePhysics(delta_time, m_black_hole.getPosition(), m_black_hole.getMass(),
+	                       m_worker_pool);
 
 	if(m_player.isAlive())
 		m_player.updatePhysics(delta_time, m_black_hole);
 
-	for(unsigned int d = 0; d < mv_drones.size(); d++)
-	{
-		Spaceship& drone = mv_drones[d];
-		if(drone.isAlive())
-			drone.updatePhysics(delta_time, m_black_hole);
-	}
+	// living drones (dead drones are inactive), without Kepler orbits
+	m_drone_bodies.updatePhysics(delta_time, m_black_hole.getPosition(), m_black_hole.getMass(),
+	                             m_worker_pool);
 }
 
-void Game :: handleCollisions ()
+void Game :: handleCollisions (double delta_time)
 {
 /*
 	if(Collisions::isCollision(m_player, m_black_hole))
@@ -470,87 +1137,229 @@ void Game :: handleCollisions ()
 			drone.markDead();
 	}
 */
-	for(unsigned c = 0; c < mv_crystals.size(); c++)
+	//
+	//  Only the pairs found by the broad phase are checked.  The
+	//    exact tests are all run first (on several threads),
+	//    using where everything was at the end of the time step.
+	//    The collisions are then handled on this thread in the
+	//    order the pairs are sorted in, which is the same order
+	//    as checking every pair would.  The results therefore
+	//    do not depend on the number of threads.
+	//
+	//  Handling a collision can change the velocity of a crystal
+	//    or asteroid, and moves them back to where they touched
+	//    and forward again.  A later pair with the same crystal
+	//    or asteroid was tested before that, so its result may
+	//    be stale.  This is accepted because such pairs are
+	//    rare (a crystal or asteroid hitting two things in one
+	//    step), and the stale pair is still checked again next
+	//    step.  The end position only changes by the change in
+	//    velocity over part of one step.  Ships that hit
+	//    asteroids are only moved back after all the pairs are
+	//    handled, once each, to their earliest impact.
+	//
+	//  With continuous collisions, the tests also find when
+	//    during the time step each pair first touched, assuming
+	//    everything moved in a straight line.  Each collision is
+	//    then handled at that time, so fast objects cannot pass
+	//    through each other between steps.
+	//
+
+	steady_clock::time_point last_time = steady_clock::now();
+	updateBroadPhase(delta_time);
+	m_phase_times.m_broad_phase = getSecondsSince(last_time);
+	updateNarrowPhase(delta_time);
+	m_phase_times.m_narrow_phase = getSecondsSince(last_time);
+	resolveCollisions(delta_time);
+	m_phase_times.m_resolution = getSecondsSince(last_time);
+}
+
+void Game :: updateBroadPhase (double delta_time)
+{
+	m_broad_phase.clear();
+	for(unsigned a = 0; a < mv_asteroids.size(); a++)
+		addToBroadPhase(COLLISION_GROUP_ASTEROID, a, mv_asteroids[a], delta_time);
+	for(unsigned int n = 0; n < m_crystals.getLiveCount(); n++)
 	{
-		Crystal& crystal = mv_crystals[c];
-		if(!crystal.isGone())
+		unsigned int c = m_crystals.getLiveSlot(n);
+		addToBroadPhase(COLLISION_GROUP_CRYSTAL, c, m_crystals.getCrystal(c), delta_time);
+	}
+
+	// wrecks do not collide, so they stay where they hit
+	if(m_player.isAlive())
+		addToBroadPhase(COLLISION_GROUP_SHIP, 0, m_player, delta_time);
+	for(unsigned int d = 0; d < mv_drones.size(); d++)
+		if(mv_drones[d].isAlive())
+			addToBroadPhase(COLLISION_GROUP_SHIP, d + 1, mv_drones[d], delta_time);
+	m_broad_phase.findPairs();
+}
+
+void Game :: addToBroadPhase (unsigned int group,
+                              unsigned int index,
+                              const Entity& entity,
+                              double delta_time)
+{
+	if(m_is_continuous_collisions)
+	{
+		Vector3 start = entity.getPosition() - entity.getVelocity() * delta_time;
+		m_broad_phase.addSweptSphere(group, index, start, entity.getPosition(), entity.getRadius());
+	}
+	else
+		m_broad_phase.addSphere(group, index, entity.getPosition(), entity.getRadius());
+}
+
+void Game :: updateNarrowPhase (double delta_time)
+{
+	unsigned int pair_count = m_broad_phase.getPairCount();
+	mv_is_pair_colliding.resize(pair_count);
+	mv_pair_impact_times.resize(pair_count);
+
+	// each thread only writes the results for its own pairs
+	m_worker_pool.run(pair_count, MIN_PAIRS_PER_THREAD,
+	                  [this, delta_time] (unsigned int begin, unsigned int end)
+	                  {
+	                      for(unsigned int p = begin; p < end; p++)
+	                          mv_is_pair_colliding[p] = isPairColliding(m_broad_phase.getPair(p), delta_time,
+	                                                                    mv_pair_impact_times[p]);
+	                  });
+}
+
+bool Game :: isPairColliding (const BroadPhase::Pair& pair,
+                              double delta_time,
+                              double& r_impact_time) const
+{
+	r_impact_time = delta_time;  // if only checked at end of step
+
+	if(pair.m_group1 == COLLISION_GROUP_CRYSTAL)
+	{
+		assert(pair.m_group2 == COLLISION_GROUP_SHIP);
+		const Crystal&   crystal = m_crystals.getCrystal(pair.m_index1);
+		const Spaceship& ship    = (pair.m_index2 == 0) ? m_player : mv_drones[pair.m_index2 - 1];
+		if(m_is_continuous_collisions)
+			return Collisions::isCollisionDuring(ship, crystal, delta_time, r_impact_time);
+		return Collisions::isCollision(ship, crystal);
+	}
+
+	assert(pair.m_group1 == COLLISION_GROUP_ASTEROID);
+	const Asteroid& asteroid = mv_asteroids[pair.m_index1];
+	switch(pair.m_group2)
+	{
+	case COLLISION_GROUP_ASTEROID:
+		// asteroids move much less than their size each step
+		return Collisions::isCollision(asteroid, mv_asteroids[pair.m_index2]);
+	case COLLISION_GROUP_CRYSTAL:
+		if(m_is_continuous_collisions)
+			return Collisions::isCollisionDuring(asteroid, m_crystals.getCrystal(pair.m_index2), delta_time, r_impact_time);
+		return Collisions::isCollision(m_crystals.getCrystal(pair.m_index2), asteroid);
+	case COLLISION_GROUP_SHIP:
 		{
-			//if(Collisions::isCollision(m_black_hole, crystal))
-			//	crystal.markGone();
-			//else
-			if(Collisions::isCollision(m_player, crystal))
-			{
-				assert(!crystal.isGone());
-				crystal.markGone();
-				m_crystals_collected++;
-			}
-			else
-			{
-				for(unsigned int d = 0; d < mv_drones.size(); d++)
-					if(Collisions::isCollision(mv_drones[d], crystal))
-					{
-						assert(!crystal.isGone());
-						crystal.markGone();
-						m_crystals_collected++;
-						break;  // don't check any more drones
-					}
-			}
+			const Spaceship& ship = (pair.m_index2 == 0) ? m_player : mv_drones[pair.m_index2 - 1];
+			if(m_is_continuous_collisions)
+				return Collisions::isCollisionDuring(asteroid, ship, delta_time, r_impact_time);
+			return Collisions::isCollision(ship, asteroid);
 		}
 	}
 
-	for(unsigned a = 0; a < mv_asteroids.size(); a++)
-	{
-		Asteroid& asteroid = mv_asteroids[a];
+	assert(false);  // invalid group
+	return false;
+}
+
+void Game :: resolveCollisions (double delta_time)
+{
+	assert(mv_is_pair_colliding.size() == m_broad_phase.getPairCount());
+	assert(mv_pair_impact_times.size() == m_broad_phase.getPairCount());
+
+	m_collision_count = 0;
+	mv_ship_hits.clear();
 
-		for(unsigned a2 = a + 1; a2 < mv_asteroids.size(); a2++)
+	// collect crystals first
+	for(unsigned int p = 0; p < m_broad_phase.getPairCount(); p++)
+	{
+		const BroadPhase::Pair& pair = m_broad_phase.getPair(p);
+		if(pair.m_group1 != COLLISION_GROUP_CRYSTAL)
+			continue;
+		assert(pair.m_group2 == COLLISION_GROUP_SHIP);
+
+		if(!m_crystals.isLive(pair.m_index1))
+			continue;  // already collected by an earlier ship
+
+		//if(Collisions::isCollision(m_black_hole, m_crystals.getCrystal(pair.m_index1)))
+		//	m_crystals.remove(pair.m_index1);
+		//else
+		if(mv_is_pair_colliding[p])
 		{
-			Asteroid& asteroid2 = mv_asteroids[a2];
-			if(Collisions::isCollision(asteroid, asteroid2))
-				Collisions::elastic(asteroid, asteroid2);
+			m_crystals.remove(pair.m_index1);
+			m_crystals_collected++;
+			m_collision_count++;
 		}
+	}
 
-		for(unsigned c = 0; c < mv_crystals.size(); c++)
+	// then handle everything hitting asteroids
+	for(unsigned int p = 0; p < m_broad_phase.getPairCount(); p++)
+	{
+		const BroadPhase::Pair& pair = m_broad_phase.getPair(p);
+		if(pair.m_group1 != COLLISION_GROUP_ASTEROID)
+			continue;
+		if(!mv_is_pair_colliding[p])
+			continue;
+
+		Asteroid& asteroid = mv_asteroids[pair.m_index1];
+		double time_after_impact = delta_time - mv_pair_impact_times[p];
+		switch(pair.m_group2)
 		{
-			Crystal& crystal = mv_crystals[c];
-			if(!crystal.isGone())
-				if(Collisions::isCollision(crystal, asteroid))
+		case COLLISION_GROUP_ASTEROID:
+			Collisions::elastic(asteroid, mv_asteroids[pair.m_index2]);
+			m_collision_count++;
+			break;
+
+		case COLLISION_GROUP_CRYSTAL:
+			{
+				if(m_crystals.isLive(pair.m_index2))
 				{
+					Crystal& crystal = m_crystals.getCrystal(pair.m_index2);
+
+					// bounce where they touched, then finish the step
+					moveEntity(crystal,  -time_after_impact);
+					moveEntity(asteroid, -time_after_impact);
 					Collisions::elastic(crystal, asteroid);
+					moveEntity(crystal,  time_after_impact);
+					moveEntity(asteroid, time_after_impact);
 					//Collisions::bounceOff(crystal, asteroid);  // does about the same thing
+					m_collision_count++;
 				}
-		}
+			}
+			break;
 
-		if(Collisions::isCollision(m_player, asteroid))
-			m_player.markDead();
-		for(unsigned int d = 0; d < mv_drones.size(); d++)
-		{
-			Spaceship& drone = mv_drones[d];
-			if(Collisions::isCollision(drone, asteroid))
-				drone.markDead();
+		case COLLISION_GROUP_SHIP:
+			// ships are handled below, in case one hit several asteroids
+			mv_ship_hits.push_back(make_pair(pair.m_index2, mv_pair_impact_times[p]));
+			m_collision_count++;
+			break;
 		}
 	}
+
+	// each ship becomes a wreck where it first hit an asteroid
+	sort(mv_ship_hits.begin(), mv_ship_hits.end());
+	for(unsigned int h = 0; h < mv_ship_hits.size(); h++)
+	{
+		if(h > 0 && mv_ship_hits[h].first == mv_ship_hits[h - 1].first)
+			continue;  // a later impact for the same ship
+
+		unsigned int index = mv_ship_hits[h].first;
+		Spaceship& ship = (index == 0) ? m_player : mv_drones[index - 1];
+		assert(ship.isAlive());
+		moveEntity(ship, -(delta_time - mv_ship_hits[h].second));
+		ship.markDead();
+	}
 }
 
 void Game :: addCrystal (const ObjLibrary::Vector3& position,
                          const ObjLibrary::Vector3& asteroid_velocity)
 {
-	static const unsigned int EXPAND_VECTOR = UINT_MAX;
-
 	Vector3 crystal_velocity = asteroid_velocity + Vector3::getRandomUnitVector() * CRYSTAL_KNOCK_OFF_SPEED;
 
-	// look for an existing already-gone crystal to replace
-	//  -> this will speed up searching the list elsewhere
-	unsigned int index = EXPAND_VECTOR;
-	for(unsigned c = 0; c < mv_crystals.size(); c++)
-		if(mv_crystals[c].isGone())
-		{
-			index = c;
-			break;
-		}
-
+	// reuses the slot and body of a gone crystal if there is one
 	assert(g_crystal_display_list.isReady());
-	if(index == EXPAND_VECTOR)
-		mv_crystals.push_back(Crystal(position, crystal_velocity, g_crystal_display_list));
-	else
-		mv_crystals[index] =  Crystal(position, crystal_velocity, g_crystal_display_list);
+	m_crystals.add(Crystal(position, crystal_velocity, g_crystal_display_list), m_bodies);
+	m_is_crystal_grid_current = false;
 }
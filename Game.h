@@ -8,15 +8,26 @@
 
 #include <string>
 #include <vector>
+#include <utility>  // for pair
 
 #include "ObjLibrary/Vector3.h"
 
+#include "GameSettings.h"
 #include "CoordinateSystem.h"
 #include "Entity.h"
 #include "BlackHole.h"
 #include "Asteroid.h"
 #include "Crystal.h"
+#include "CrystalPool.h"
 #include "Spaceship.h"
+#include "PhysicsBodies.h"
+#include "BroadPhase.h"
+#include "PointGrid.h"
+#include "WorkerPool.h"
+#ifndef GAME_HEADLESS
+	#include "RenderQueue.h"
+	#include "DebugDraw.h"
+#endif
 
 
 
@@ -27,41 +38,132 @@
 //
 class Game
 {
+public:
+	// how long each part of the last update took, in seconds
+	struct PhaseTimes
+	{
+		double m_ai;
+		double m_physics;
+		double m_broad_phase;
+		double m_narrow_phase;
+		double m_resolution;
+	};
+
+	// how many entities the last draw drew and skipped
+	struct DrawCounts
+	{
+		unsigned int m_drawn;
+		unsigned int m_culled;
+		unsigned int m_asteroid_triangles;
+		unsigned int m_meshes;
+		unsigned int m_material_groups;  // times a material was activated
+		unsigned int m_debug_lines;
+		unsigned int m_debug_markers;
+	};
+
 public:
 	static bool isModelsLoaded ();
+	static unsigned int getDefaultDroneCount ();
 	static void loadModels (const std::string& path);
+	static void loadModels (const std::string& path,
+	                        unsigned int asteroid_subdivisions);
 
 public:
 	Game ();
+	Game (unsigned int thread_count);
+	Game (unsigned int thread_count,
+	      unsigned int drone_count);
 
-	Game (const Game& game) = default;
+	// the asteroids, crystals, and drones refer to PhysicsBodies, so no copying
+	Game (const Game& game) = delete;
 	~Game () = default;
-	Game& operator= (const Game& game) = default;
+	Game& operator= (const Game& game) = delete;
 
 	bool isOver () const
 	{  return !m_player.isAlive();  }
 
+	// simulated seconds since the game started
+	double getTime () const
+	{  return m_time;  }
+
 	unsigned int getAsteroidCount () const
 	{  return mv_asteroids.size();  }
 	const Asteroid& getAsteroid (unsigned int index) const;
 
+	// nearest first, by time to closest approach
+	void findAsteroidsToAvoid (const Spaceship& agent,
+	                           double max_acceleration,
+	                           std::vector<unsigned int>& r_asteroids) const;
+
+	// crystal indexes do not change while the crystal is in play
 	unsigned int getTotalCrystalCount () const
-	{  return mv_crystals.size();  }
-	unsigned int getNonGoneCrystalCount () const;
+	{  return m_crystals.getSlotCount();  }
+	unsigned int getNonGoneCrystalCount () const
+	{  return m_crystals.getLiveCount();  }
+	unsigned int getNonGoneCrystalIndex (unsigned int non_gone) const
+	{  return m_crystals.getLiveSlot(non_gone);  }
 	const Crystal& getCrystal (unsigned int index) const;
-	Crystal& getCrystal (unsigned int index);
-	bool isCrystalChased (unsigned int index);
+
+	// a drone claims the crystal it chases, so no two drones chase the same one
+	bool isCrystalClaimed (unsigned int index) const;
+	// needed before searching again after crystals move or are added
+	void updateCrystalGrid ();
+	unsigned int findNearestUnclaimedCrystal (const ObjLibrary::Vector3& position,
+	                                          double max_distance,
+	                                          std::vector<unsigned int>& r_crystals_near) const;
 
 	const Spaceship& getPlayer () const
 	{  return m_player;  }
+	unsigned int getDroneCount () const
+	{  return mv_drones.size();  }
 	unsigned int getLivingDroneCount () const;
 
 	unsigned int getCrystalsCollected () const
 	{  return m_crystals_collected;  }
 
+	const BroadPhase& getBroadPhase () const
+	{  return m_broad_phase;  }
+	unsigned int getCollisionCount () const
+	{  return m_collision_count;  }
+
+	unsigned int getGravityKernel () const
+	{  return m_bodies.getGravityKernel();  }
+	void setGravityKernel (unsigned int kernel);
+
+	// only for asteroids and crystals, because the drones thrust too often
+	bool isKeplerOrbits () const
+	{  return m_bodies.isKeplerOrbits();  }
+	void setKeplerOrbits (bool is_kepler_orbits)
+	{  m_bodies.setKeplerOrbits(is_kepler_orbits);  }
+
+	// otherwise, collisions are only checked at the end of each time step
+	bool isContinuousCollisions () const
+	{  return m_is_continuous_collisions;  }
+	void setContinuousCollisions (bool is_continuous_collisions)
+	{  m_is_continuous_collisions = is_continuous_collisions;  }
+
+	// 0 calculates the asteroid surface noise for every direction
+	unsigned int getRadiusMapResolution () const
+	{  return m_radius_map_resolution;  }
+	void setRadiusMapResolution (unsigned int resolution);
+	unsigned int getRadiusMapMemorySize () const;
+
+	// the results are the same for any number of threads
+	unsigned int getThreadCount () const
+	{  return m_worker_pool.getThreadCount();  }
+	void setThreadCount (unsigned int thread_count)
+	{  m_worker_pool.setThreadCount(thread_count);  }
+
+	const PhaseTimes& getPhaseTimes () const
+	{  return m_phase_times;  }
+	const DrawCounts& getDrawCounts () const
+	{  return m_draw_counts;  }
+
 	ObjLibrary::Vector3 getFollowCameraPosition () const;
+#ifndef GAME_HEADLESS
 	void setupFollowCamera () const;
 	void draw (bool is_show_debug) const;
+#endif  // GAME_HEADLESS is not defined
 
 	void update (double delta_time);
 	void knockOffCrystals ();
@@ -97,23 +199,72 @@ public:
 
 private:
 	void initAsteroids ();
-	void initSpaceships ();
+	void initSpaceships (unsigned int drone_count);
+	void updateAsteroidGrid ();
 	double getCircularOrbitSpeed (double distance);
 
+#ifndef GAME_HEADLESS
 	void drawSkybox () const;
+#endif  // GAME_HEADLESS is not defined
 
 	void updateAI (double delta_time);
+	void updateCrystalsChased ();
 	void updatePhysics (double delta_time);
-	void handleCollisions ();
+	void handleCollisions (double delta_time);
+	void updateBroadPhase (double delta_time);
+	void addToBroadPhase (unsigned int group,
+	                      unsigned int index,
+	                      const Entity& entity,
+	                      double delta_time);
+	void updateNarrowPhase (double delta_time);
+	bool isPairColliding (const BroadPhase::Pair& pair,
+	                      double delta_time,
+	                      double& r_impact_time) const;
+	void resolveCollisions (double delta_time);
 
 	void addCrystal (const ObjLibrary::Vector3& position,
 	                 const ObjLibrary::Vector3& asteroid_velocity);
 
 private:
+	double m_time;
 	BlackHole m_black_hole;
+	PhysicsBodies m_bodies;  // for asteroids and crystals
 	std::vector<Asteroid> mv_asteroids;
-	std::vector<Crystal> mv_crystals;
+	unsigned int m_radius_map_resolution;
+	mutable std::vector<unsigned int> mv_asteroid_detail_levels;  // from last draw
+
+	// for drones avoiding asteroids, updated after every update
+	PointGrid m_asteroid_grid;
+	double m_asteroid_radius_max;
+	double m_asteroid_speed_max;
+	CrystalPool m_crystals;
+
+	// for drones choosing crystals, updated every AI update
+	std::vector<unsigned char> mv_is_crystal_claimed;
+	PointGrid m_crystal_grid;  // live crystals, built when first needed
+	bool m_is_crystal_grid_current;
+	std::vector<unsigned int> mv_searching_drones;
+	std::vector<unsigned int> mv_crystal_requests;  // by position in mv_searching_drones
+	std::vector<unsigned int> mv_crystal_winners;   // by crystal, drone index or NO_DRONE
+	std::vector<double> mv_crystal_winner_distances;
 	Spaceship m_player;
+	PhysicsBodies m_drone_bodies;  // body d is drone d
 	std::vector<Spaceship> mv_drones;
 	unsigned int m_crystals_collected;
+
+	// for collisions, updated every time step
+	BroadPhase m_broad_phase;
+	std::vector<unsigned char> mv_is_pair_colliding;  // not vector<bool>, so threads can write at once
+	std::vector<double> mv_pair_impact_times;  // since start of step
+	std::vector<std::pair<unsigned int, double> > mv_ship_hits;  // ship index and impact time
+	unsigned int m_collision_count;
+	bool m_is_continuous_collisions;
+
+	WorkerPool m_worker_pool;
+	PhaseTimes m_phase_times;
+	mutable DrawCounts m_draw_counts;  // drawing does not change the game
+#ifndef GAME_HEADLESS
+	mutable RenderQueue m_render_queue;
+	mutable DebugDraw m_debug_draw;  // also has the paths
+#endif
 };
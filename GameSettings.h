@@ -0,0 +1,35 @@
+//
+//  GameSettings.h
+//
+//  A module to encapsulate the build settings for the game.
+//
+
+#pragma once
+
+#include "ObjLibrary/ObjSettings.h"
+
+
+
+//
+//  The game normally displays the world with OpenGL and GLUT.
+//    It is also possible to build just the simulation, with no
+//    window and no dependency on OpenGL at all.  This is used
+//    to run and profile Game::update on machines with no
+//    display.  In this mode, all drawing functions are removed
+//    and the models are replaced with placeholder
+//    DisplayLists.
+//
+//  The headless simulation requires the ObjLibrary to be built
+//    without OpenGL as well (see ObjSettings.h).
+//
+//  To build the headless simulation, define the macro
+//    GAME_HEADLESS.  This is normally done by the build system
+//    for the headless targets rather than here.
+//
+//#define GAME_HEADLESS
+
+#ifdef GAME_HEADLESS
+	#ifndef OBJ_LIBRARY_HEADLESS
+		#error "GAME_HEADLESS requires OBJ_LIBRARY_HEADLESS"
+	#endif
+#endif
@@ -0,0 +1,348 @@
+//
+//  GravityKernels.cpp
+//
+
+#include "GravityKernels.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Gravity.h"
+
+// the SIMD kernels are only built for x86 compilers we know how to check
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+	#define GRAVITY_KERNELS_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define GRAVITY_KERNELS_TARGET(name)
+	#else
+		#define GRAVITY_KERNELS_TARGET(name) __attribute__((target(name)))
+	#endif
+#endif
+
+using namespace ObjLibrary;
+namespace
+{
+	const char* A_NAMES[GravityKernels::COUNT] =
+	{
+		"scalar",
+		"sse2",
+		"avx",
+	};
+
+	void advanceScalar (unsigned int count,
+	                    double delta_time,
+	                    const Vector3& black_hole_position,
+	                    double black_hole_mass,
+	                    Vector3 a_positions[],
+	                    Vector3 a_velocities[])
+	{
+		for(unsigned int b = 0; b < count; b++)
+		{
+			Vector3  old_position = a_positions[b];
+			Vector3& r_velocity   = a_velocities[b];
+
+			// apply black hole gravity
+			Vector3 vector_to_black_hole = black_hole_position - old_position;
+			if(!vector_to_black_hole.isZero())
+			{
+				double distance_squared = old_position.getDistanceSquared(black_hole_position);
+				assert(distance_squared > 0.0);
+
+				double magnitude = GRAVITY * black_hole_mass / distance_squared;
+				Vector3 acceleration = vector_to_black_hole.getCopyWithNorm(magnitude);
+				r_velocity += acceleration * delta_time;
+			}
+
+			// move according to velocity
+			a_positions[b] = old_position + r_velocity * delta_time;
+		}
+	}
+
+#ifdef GRAVITY_KERNELS_X86
+	//
+	//  The SIMD kernels treat the arrays of Vector3s as arrays of
+	//    doubles, 3 per body, and rearrange them into one
+	//    register per component.  Every operation matches one in
+	//    advanceScalar, in the same order, so that the results
+	//    are identical:
+	//      to_black_hole = black_hole - position
+	//      if any |to_black_hole component| > tolerance
+	//        distance_squared = (tx * tx + ty * ty) + tz * tz
+	//        magnitude        = (GRAVITY * mass) / distance_squared
+	//        ratio            = magnitude / sqrt(distance_squared)
+	//        velocity        += (to_black_hole * ratio) * delta_time
+	//      position += velocity * delta_time
+	//
+	static_assert(sizeof(Vector3) == 3 * sizeof(double),
+	              "Vector3 must be 3 packed doubles");
+
+	GRAVITY_KERNELS_TARGET("sse2")
+	void advanceSse2 (unsigned int count,
+	                  double delta_time,
+	                  const Vector3& black_hole_position,
+	                  double black_hole_mass,
+	                  Vector3 a_positions[],
+	                  Vector3 a_velocities[])
+	{
+		const __m128d BLACK_HOLE_X = _mm_set1_pd(black_hole_position.x);
+		const __m128d BLACK_HOLE_Y = _mm_set1_pd(black_hole_position.y);
+		const __m128d BLACK_HOLE_Z = _mm_set1_pd(black_hole_position.z);
+		const __m128d GM           = _mm_set1_pd(GRAVITY * black_hole_mass);
+		const __m128d DELTA_TIME   = _mm_set1_pd(delta_time);
+		const __m128d TOLERANCE    = _mm_set1_pd(VECTOR3_ZERO_TOLERENCE);
+		const __m128d SIGN_BIT     = _mm_set1_pd(-0.0);
+
+		unsigned int b = 0;
+		for( ; b + 2 <= count; b += 2)
+		{
+			double* p_position = &(a_positions [b].x);
+			double* p_velocity = &(a_velocities[b].x);
+
+			// [x0 y0] [z0 x1] [y1 z1] -> [x0 x1] [y0 y1] [z0 z1]
+			__m128d p0 = _mm_loadu_pd(p_position + 0);
+			__m128d p1 = _mm_loadu_pd(p_position + 2);
+			__m128d p2 = _mm_loadu_pd(p_position + 4);
+			__m128d px = _mm_shuffle_pd(p0, p1, 2);
+			__m128d py = _mm_shuffle_pd(p0, p2, 1);
+			__m128d pz = _mm_shuffle_pd(p1, p2, 2);
+			__m128d v0 = _mm_loadu_pd(p_velocity + 0);
+			__m128d v1 = _mm_loadu_pd(p_velocity + 2);
+			__m128d v2 = _mm_loadu_pd(p_velocity + 4);
+			__m128d vx = _mm_shuffle_pd(v0, v1, 2);
+			__m128d vy = _mm_shuffle_pd(v0, v2, 1);
+			__m128d vz = _mm_shuffle_pd(v1, v2, 2);
+
+			__m128d tx = _mm_sub_pd(BLACK_HOLE_X, px);
+			__m128d ty = _mm_sub_pd(BLACK_HOLE_Y, py);
+			__m128d tz = _mm_sub_pd(BLACK_HOLE_Z, pz);
+			__m128d is_not_zero = _mm_or_pd(_mm_or_pd(
+			        _mm_cmpgt_pd(_mm_andnot_pd(SIGN_BIT, tx), TOLERANCE),
+			        _mm_cmpgt_pd(_mm_andnot_pd(SIGN_BIT, ty), TOLERANCE)),
+			        _mm_cmpgt_pd(_mm_andnot_pd(SIGN_BIT, tz), TOLERANCE));
+
+			__m128d distance_squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(tx, tx),
+			                                                 _mm_mul_pd(ty, ty)),
+			                                                 _mm_mul_pd(tz, tz));
+			__m128d magnitude = _mm_div_pd(GM, distance_squared);
+			__m128d ratio     = _mm_div_pd(magnitude, _mm_sqrt_pd(distance_squared));
+
+			__m128d new_vx = _mm_add_pd(vx, _mm_mul_pd(_mm_mul_pd(tx, ratio), DELTA_TIME));
+			__m128d new_vy = _mm_add_pd(vy, _mm_mul_pd(_mm_mul_pd(ty, ratio), DELTA_TIME));
+			__m128d new_vz = _mm_add_pd(vz, _mm_mul_pd(_mm_mul_pd(tz, ratio), DELTA_TIME));
+			vx = _mm_or_pd(_mm_and_pd(is_not_zero, new_vx), _mm_andnot_pd(is_not_zero, vx));
+			vy = _mm_or_pd(_mm_and_pd(is_not_zero, new_vy), _mm_andnot_pd(is_not_zero, vy));
+			vz = _mm_or_pd(_mm_and_pd(is_not_zero, new_vz), _mm_andnot_pd(is_not_zero, vz));
+
+			px = _mm_add_pd(px, _mm_mul_pd(vx, DELTA_TIME));
+			py = _mm_add_pd(py, _mm_mul_pd(vy, DELTA_TIME));
+			pz = _mm_add_pd(pz, _mm_mul_pd(vz, DELTA_TIME));
+
+			// [x0 x1] [y0 y1] [z0 z1] -> [x0 y0] [z0 x1] [y1 z1]
+			_mm_storeu_pd(p_position + 0, _mm_unpacklo_pd(px, py));
+			_mm_storeu_pd(p_position + 2, _mm_shuffle_pd(pz, px, 2));
+			_mm_storeu_pd(p_position + 4, _mm_unpackhi_pd(py, pz));
+			_mm_storeu_pd(p_velocity + 0, _mm_unpacklo_pd(vx, vy));
+			_mm_storeu_pd(p_velocity + 2, _mm_shuffle_pd(vz, vx, 2));
+			_mm_storeu_pd(p_velocity + 4, _mm_unpackhi_pd(vy, vz));
+		}
+
+		advanceScalar(count - b, delta_time, black_hole_position, black_hole_mass,
+		              a_positions + b, a_velocities + b);
+	}
+
+	GRAVITY_KERNELS_TARGET("avx")
+	void advanceAvx (unsigned int count,
+	                 double delta_time,
+	                 const Vector3& black_hole_position,
+	                 double black_hole_mass,
+	                 Vector3 a_positions[],
+	                 Vector3 a_velocities[])
+	{
+		const __m256d BLACK_HOLE_X = _mm256_set1_pd(black_hole_position.x);
+		const __m256d BLACK_HOLE_Y = _mm256_set1_pd(black_hole_position.y);
+		const __m256d BLACK_HOLE_Z = _mm256_set1_pd(black_hole_position.z);
+		const __m256d GM           = _mm256_set1_pd(GRAVITY * black_hole_mass);
+		const __m256d DELTA_TIME   = _mm256_set1_pd(delta_time);
+		const __m256d TOLERANCE    = _mm256_set1_pd(VECTOR3_ZERO_TOLERENCE);
+		const __m256d SIGN_BIT     = _mm256_set1_pd(-0.0);
+
+		unsigned int b = 0;
+		for( ; b + 4 <= count; b += 4)
+		{
+			double* p_position = &(a_positions [b].x);
+			double* p_velocity = &(a_velocities[b].x);
+
+			// bodies 0 and 2 in low/high halves, then 1 and 3
+			__m256d p02 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p_position + 0)),
+			                                   _mm_loadu_pd(p_position + 6), 1);
+			__m256d p13 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p_position + 3)),
+			                                   _mm_loadu_pd(p_position + 9), 1);
+			__m256d px = _mm256_unpacklo_pd(p02, p13);
+			__m256d py = _mm256_unpackhi_pd(p02, p13);
+			__m256d pz = _mm256_insertf128_pd(_mm256_castpd128_pd256(
+			                     _mm_loadh_pd(_mm_load_sd(p_position + 2), p_position + 5)),
+			                     _mm_loadh_pd(_mm_load_sd(p_position + 8), p_position + 11), 1);
+			__m256d v02 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p_velocity + 0)),
+			                                   _mm_loadu_pd(p_velocity + 6), 1);
+			__m256d v13 = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(p_velocity + 3)),
+			                                   _mm_loadu_pd(p_velocity + 9), 1);
+			__m256d vx = _mm256_unpacklo_pd(v02, v13);
+			__m256d vy = _mm256_unpackhi_pd(v02, v13);
+			__m256d vz = _mm256_insertf128_pd(_mm256_castpd128_pd256(
+			                     _mm_loadh_pd(_mm_load_sd(p_velocity + 2), p_velocity + 5)),
+			                     _mm_loadh_pd(_mm_load_sd(p_velocity + 8), p_velocity + 11), 1);
+
+			__m256d tx = _mm256_sub_pd(BLACK_HOLE_X, px);
+			__m256d ty = _mm256_sub_pd(BLACK_HOLE_Y, py);
+			__m256d tz = _mm256_sub_pd(BLACK_HOLE_Z, pz);
+			__m256d is_not_zero = _mm256_or_pd(_mm256_or_pd(
+			        _mm256_cmp_pd(_mm256_andnot_pd(SIGN_BIT, tx), TOLERANCE, _CMP_GT_OQ),
+			        _mm256_cmp_pd(_mm256_andnot_pd(SIGN_BIT, ty), TOLERANCE, _CMP_GT_OQ)),
+			        _mm256_cmp_pd(_mm256_andnot_pd(SIGN_BIT, tz), TOLERANCE, _CMP_GT_OQ));
+
+			__m256d distance_squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(tx, tx),
+			                                                       _mm256_mul_pd(ty, ty)),
+			                                                       _mm256_mul_pd(tz, tz));
+			__m256d magnitude = _mm256_div_pd(GM, distance_squared);
+			__m256d ratio     = _mm256_div_pd(magnitude, _mm256_sqrt_pd(distance_squared));
+
+			vx = _mm256_blendv_pd(vx, _mm256_add_pd(vx, _mm256_mul_pd(_mm256_mul_pd(tx, ratio), DELTA_TIME)), is_not_zero);
+			vy = _mm256_blendv_pd(vy, _mm256_add_pd(vy, _mm256_mul_pd(_mm256_mul_pd(ty, ratio), DELTA_TIME)), is_not_zero);
+			vz = _mm256_blendv_pd(vz, _mm256_add_pd(vz, _mm256_mul_pd(_mm256_mul_pd(tz, ratio), DELTA_TIME)), is_not_zero);
+
+			px = _mm256_add_pd(px, _mm256_mul_pd(vx, DELTA_TIME));
+			py = _mm256_add_pd(py, _mm256_mul_pd(vy, DELTA_TIME));
+			pz = _mm256_add_pd(pz, _mm256_mul_pd(vz, DELTA_TIME));
+
+			// reverse the rearrangement above
+			p02 = _mm256_unpacklo_pd(px, py);
+			p13 = _mm256_unpackhi_pd(px, py);
+			_mm_storeu_pd(p_position + 0, _mm256_castpd256_pd128(p02));
+			_mm_storeu_pd(p_position + 6, _mm256_extractf128_pd(p02, 1));
+			_mm_storeu_pd(p_position + 3, _mm256_castpd256_pd128(p13));
+			_mm_storeu_pd(p_position + 9, _mm256_extractf128_pd(p13, 1));
+			_mm_storel_pd(p_position +  2, _mm256_castpd256_pd128(pz));
+			_mm_storeh_pd(p_position +  5, _mm256_castpd256_pd128(pz));
+			_mm_storel_pd(p_position +  8, _mm256_extractf128_pd(pz, 1));
+			_mm_storeh_pd(p_position + 11, _mm256_extractf128_pd(pz, 1));
+			v02 = _mm256_unpacklo_pd(vx, vy);
+			v13 = _mm256_unpackhi_pd(vx, vy);
+			_mm_storeu_pd(p_velocity + 0, _mm256_castpd256_pd128(v02));
+			_mm_storeu_pd(p_velocity + 6, _mm256_extractf128_pd(v02, 1));
+			_mm_storeu_pd(p_velocity + 3, _mm256_castpd256_pd128(v13));
+			_mm_storeu_pd(p_velocity + 9, _mm256_extractf128_pd(v13, 1));
+			_mm_storel_pd(p_velocity +  2, _mm256_castpd256_pd128(vz));
+			_mm_storeh_pd(p_velocity +  5, _mm256_castpd256_pd128(vz));
+			_mm_storel_pd(p_velocity +  8, _mm256_extractf128_pd(vz, 1));
+			_mm_storeh_pd(p_velocity + 11, _mm256_extractf128_pd(vz, 1));
+		}
+
+		advanceScalar(count - b, delta_time, black_hole_position, black_hole_mass,
+		              a_positions + b, a_velocities + b);
+	}
+
+	bool isCpuSse2 ()
+	{
+	#if defined(_M_X64) || defined(__x86_64__)
+		return true;  // part of x86-64
+	#elif defined(_MSC_VER)
+		int a_registers[4];
+		__cpuid(a_registers, 1);
+		return (a_registers[3] & (1 << 26)) != 0;
+	#else
+		return __builtin_cpu_supports("sse2") != 0;
+	#endif
+	}
+
+	bool isCpuAvx ()
+	{
+	#ifdef _MSC_VER
+		// the processor and the operating system must both support it
+		int a_registers[4];
+		__cpuid(a_registers, 1);
+		bool is_osxsave = (a_registers[2] & (1 << 27)) != 0;
+		bool is_avx     = (a_registers[2] & (1 << 28)) != 0;
+		if(!is_osxsave || !is_avx)
+			return false;
+		return (_xgetbv(0) & 6) == 6;
+	#else
+		return __builtin_cpu_supports("avx") != 0;
+	#endif
+	}
+#endif  // GRAVITY_KERNELS_X86
+
+}  // end of anonymous namespace
+
+
+
+const char* GravityKernels :: getName (unsigned int kernel)
+{
+	assert(kernel < COUNT);
+
+	return A_NAMES[kernel];
+}
+
+bool GravityKernels :: isSupported (unsigned int kernel)
+{
+	assert(kernel < COUNT);
+
+	switch(kernel)
+	{
+	case SCALAR:
+		return true;
+#ifdef GRAVITY_KERNELS_X86
+	case SSE2:
+		return isCpuSse2();
+	case AVX:
+		return isCpuAvx();
+#endif
+	default:
+		return false;
+	}
+}
+
+unsigned int GravityKernels :: getBest ()
+{
+	static const unsigned int BEST = isSupported(AVX)  ? AVX  :
+	                                 isSupported(SSE2) ? SSE2 : SCALAR;
+	return BEST;
+}
+
+void GravityKernels :: advance (unsigned int kernel,
+                                unsigned int count,
+                                double delta_time,
+                                const ObjLibrary::Vector3& black_hole_position,
+                                double black_hole_mass,
+                                ObjLibrary::Vector3 a_positions[],
+                                ObjLibrary::Vector3 a_velocities[])
+{
+	assert(kernel < COUNT);
+	assert(isSupported(kernel));
+	assert(delta_time > 0.0);
+	assert(black_hole_mass > 0.0);
+	assert(a_positions  != nullptr || count == 0);
+	assert(a_velocities != nullptr || count == 0);
+
+	switch(kernel)
+	{
+#ifdef GRAVITY_KERNELS_X86
+	case SSE2:
+		advanceSse2(count, delta_time, black_hole_position, black_hole_mass,
+		            a_positions, a_velocities);
+		break;
+	case AVX:
+		advanceAvx(count, delta_time, black_hole_position, black_hole_mass,
+		           a_positions, a_velocities);
+		break;
+#endif
+	default:
+		advanceScalar(count, delta_time, black_hole_position, black_hole_mass,
+		              a_positions, a_velocities);
+		break;
+	}
+}
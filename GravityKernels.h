@@ -0,0 +1,133 @@
+//
+//  GravityKernels.h
+//
+//  A module to move many bodies under the gravity of the black
+//    hole at once.
+//
+
+#pragma once
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  GravityKernels
+//
+//  A namespace to accelerate arrays of bodies towards the black
+//    hole and move them for one time step.  There is a plain C++
+//    kernel that works everywhere and kernels that use SSE2 (2
+//    bodies at a time) and AVX (4 bodies at a time) on x86
+//    processors.  Which kernels can be used is checked when the
+//    program is running, so the same executable works on any
+//    x86 processor.
+//
+//  Tolerance: All kernels perform the same IEEE floating-point
+//    operations in the same order as Entity::updatePhysics.
+//    Square roots and divisions are correctly rounded in the
+//    SIMD instructions as well, and no fused multiply-adds are
+//    used, so all kernels give bit-for-bit identical results.
+//    The only exception is if the rest of the program is
+//    compiled to allow floating-point contraction with FMA
+//    instructions (e.g. -march=native with GCC).  The scalar
+//    code can then round some operations differently, so the
+//    kernels only agree to within rounding error (a relative
+//    difference of about 1.0e-15 per time step).
+//
+namespace GravityKernels
+{
+//
+//  SCALAR
+//  SSE2
+//  AVX
+//
+//  Identifiers for the kernels.  SCALAR is always supported.
+//
+const unsigned int SCALAR = 0;
+const unsigned int SSE2   = 1;
+const unsigned int AVX    = 2;
+
+//
+//  COUNT
+//
+//  The number of kernels.
+//
+const unsigned int COUNT = 3;
+
+//
+//  getName
+//
+//  Purpose: To determine the name of the specified kernel.
+//  Parameter(s):
+//    <1> kernel: Which kernel
+//  Preconditions:
+//    <1> kernel < COUNT
+//  Returns: The name of kernel kernel, in lowercase.
+//  Side Effect: N/A
+//
+const char* getName (unsigned int kernel);
+
+//
+//  isSupported
+//
+//  Purpose: To determine whether the specified kernel can be
+//           used on this computer.
+//  Parameter(s):
+//    <1> kernel: Which kernel
+//  Preconditions:
+//    <1> kernel < COUNT
+//  Returns: Whether this program was compiled with kernel
+//           kernel and the processor supports the instructions
+//           it needs.
+//  Side Effect: N/A
+//
+bool isSupported (unsigned int kernel);
+
+//
+//  getBest
+//
+//  Purpose: To determine the fastest kernel that can be used on
+//           this computer.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The supported kernel that processes the most bodies
+//           at a time.
+//  Side Effect: N/A
+//
+unsigned int getBest ();
+
+//
+//  advance
+//
+//  Purpose: To update the specified bodies for one time step.
+//  Parameter(s):
+//    <1> kernel: Which kernel to use
+//    <2> count: The number of bodies
+//    <3> delta_time: The length of the time step in seconds
+//    <4> black_hole_position: The position of the black hole
+//    <5> black_hole_mass: The mass of the black hole
+//    <6> a_positions: The body positions
+//    <7> a_velocities: The body velocities
+//  Preconditions:
+//    <1> kernel < COUNT
+//    <2> isSupported(kernel)
+//    <3> delta_time > 0.0
+//    <4> black_hole_mass > 0.0
+//    <5> a_positions  != nullptr || count == 0
+//    <6> a_velocities != nullptr || count == 0
+//  Returns: N/A
+//  Side Effect: Each of the count bodies is accelerated
+//               according to the gravity of the black hole and
+//               then moved according to its updated velocity.
+//               A body exactly at the black hole is not
+//               accelerated.
+//
+void advance (unsigned int kernel,
+              unsigned int count,
+              double delta_time,
+              const ObjLibrary::Vector3& black_hole_position,
+              double black_hole_mass,
+              ObjLibrary::Vector3 a_positions[],
+              ObjLibrary::Vector3 a_velocities[]);
+
+}  // end of namespace GravityKernels
@@ -0,0 +1,197 @@
+//
+//  HeadlessMain.cpp
+//
+//  A program to run the game simulation without a display.  It
+//    performs a fixed number of updates as fast as possible and
+//    reports how many updates were performed per second.
+//
+//  Usage: headless [tick_count [delta_time [gravity_kernel [thread_count [orbits [collisions [radius_map [drone_count]]]]]]]]
+//
+
+#include <cassert>
+#include <cstdlib>  // for strtoul/strtod
+#include <cstring>  // for strcmp
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+
+#include "GameSettings.h"
+#include "BroadPhase.h"
+#include "GravityKernels.h"
+#include "Game.h"
+
+using namespace std;
+using namespace chrono;
+
+namespace
+{
+	const unsigned int DEFAULT_TICK_COUNT = 10000;
+	const double DEFAULT_DELTA_TIME = 1.0 / 60.0;  // same as main.cpp
+	const unsigned int DEFAULT_THREAD_COUNT = 1;
+	const unsigned int RADIUS_MAP_NONE = 0;
+
+	const char* ORBITS_KEPLER  = "kepler";
+	const char* ORBITS_NUMERIC = "numeric";
+
+	const char* COLLISIONS_CONTINUOUS = "continuous";
+	const char* COLLISIONS_DISCRETE   = "discrete";
+
+	void printUsage (const char* program)
+	{
+		cerr << "Usage: " << program << " [tick_count [delta_time [gravity_kernel [thread_count [orbits [collisions [radius_map [drone_count]]]]]]]]" << endl;
+		cerr << "    tick_count: The number of updates to run (default " << DEFAULT_TICK_COUNT << ")" << endl;
+		cerr << "    delta_time: The seconds per update (default " << DEFAULT_DELTA_TIME << ")" << endl;
+		cerr << "    gravity_kernel: One of";
+		for(unsigned int k = 0; k < GravityKernels::COUNT; k++)
+			cerr << " " << GravityKernels::getName(k);
+		cerr << " (default " << GravityKernels::getName(GravityKernels::getBest()) << ")" << endl;
+		cerr << "    thread_count: The number of threads to use (default " << DEFAULT_THREAD_COUNT << ")" << endl;
+		cerr << "    orbits: " << ORBITS_KEPLER << " or " << ORBITS_NUMERIC
+		     << " (default " << ORBITS_KEPLER << ")" << endl;
+		cerr << "    collisions: " << COLLISIONS_CONTINUOUS << " or " << COLLISIONS_DISCRETE
+		     << " (default " << COLLISIONS_CONTINUOUS << ")" << endl;
+		cerr << "    radius_map: The asteroid surface table resolution, or "
+		     << RADIUS_MAP_NONE << " for none (default from Game)" << endl;
+		cerr << "    drone_count: The number of AI drones (default " << Game::getDefaultDroneCount() << ")" << endl;
+	}
+
+	unsigned int findGravityKernel (const char* name)
+	{
+		for(unsigned int k = 0; k < GravityKernels::COUNT; k++)
+			if(strcmp(name, GravityKernels::getName(k)) == 0)
+				return k;
+		return GravityKernels::COUNT;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main (int argc, char* argv[])
+{
+	unsigned int tick_count     = DEFAULT_TICK_COUNT;
+	double       delta_time     = DEFAULT_DELTA_TIME;
+	unsigned int gravity_kernel = GravityKernels::getBest();
+	unsigned int thread_count   = DEFAULT_THREAD_COUNT;
+	bool         is_kepler      = true;
+	bool         is_continuous  = true;
+	bool         is_radius_map_set = false;
+	unsigned int radius_map     = RADIUS_MAP_NONE;
+	unsigned int drone_count    = Game::getDefaultDroneCount();
+	bool         is_valid       = true;
+
+	if(argc > 9)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(argc > 1)
+		tick_count = strtoul(argv[1], nullptr, 10);
+	if(argc > 2)
+		delta_time = strtod(argv[2], nullptr);
+	if(argc > 3)
+		gravity_kernel = findGravityKernel(argv[3]);
+	if(argc > 4)
+		thread_count = strtoul(argv[4], nullptr, 10);
+	if(argc > 5)
+	{
+		if(strcmp(argv[5], ORBITS_NUMERIC) == 0)
+			is_kepler = false;
+		else if(strcmp(argv[5], ORBITS_KEPLER) != 0)
+			is_valid = false;
+	}
+	if(argc > 6)
+	{
+		if(strcmp(argv[6], COLLISIONS_DISCRETE) == 0)
+			is_continuous = false;
+		else if(strcmp(argv[6], COLLISIONS_CONTINUOUS) != 0)
+			is_valid = false;
+	}
+	if(argc > 7)
+	{
+		radius_map = strtoul(argv[7], nullptr, 10);
+		is_radius_map_set = true;
+	}
+	if(argc > 8)
+		drone_count = strtoul(argv[8], nullptr, 10);
+	if(tick_count == 0 || !(delta_time > 0.0) || gravity_kernel >= GravityKernels::COUNT ||
+	   thread_count == 0 || !is_valid)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(!GravityKernels::isSupported(gravity_kernel))
+	{
+		cerr << "Gravity kernel " << GravityKernels::getName(gravity_kernel)
+		     << " is not supported on this computer" << endl;
+		return 1;
+	}
+
+	Game::loadModels("Models/");
+	Game game(thread_count, drone_count);
+	game.setGravityKernel(gravity_kernel);
+	game.setKeplerOrbits(is_kepler);
+	game.setContinuousCollisions(is_continuous);
+	if(is_radius_map_set)
+		game.setRadiusMapResolution(radius_map);
+
+	unsigned long long total_possible_pairs  = 0;
+	unsigned long long total_candidate_pairs = 0;
+	unsigned long long total_collisions      = 0;
+	Game::PhaseTimes total_times = {};
+
+	steady_clock::time_point start_time = steady_clock::now();
+	for(unsigned int t = 0; t < tick_count; t++)
+	{
+		game.update(delta_time);
+
+		const BroadPhase& broad_phase = game.getBroadPhase();
+		total_possible_pairs  += broad_phase.getPossiblePairCount();
+		total_candidate_pairs += broad_phase.getPairCount();
+		total_collisions      += game.getCollisionCount();
+
+		const Game::PhaseTimes& times = game.getPhaseTimes();
+		total_times.m_ai           += times.m_ai;
+		total_times.m_physics      += times.m_physics;
+		total_times.m_broad_phase  += times.m_broad_phase;
+		total_times.m_narrow_phase += times.m_narrow_phase;
+		total_times.m_resolution   += times.m_resolution;
+	}
+	duration<double> elapsed = steady_clock::now() - start_time;
+
+	double seconds = elapsed.count();
+	cout << fixed << setprecision(3);
+	cout << "Ticks:\t\t\t"            << tick_count << endl;
+	cout << "Simulated seconds:\t"   << tick_count * delta_time << endl;
+	cout << "Wall seconds:\t\t"      << seconds << endl;
+	if(seconds > 0.0)
+		cout << "Ticks per second:\t" << (tick_count / seconds) << endl;
+	cout << "Microseconds per tick:\t" << (seconds * 1.0e6 / tick_count) << endl;
+	cout << "Gravity kernel:\t\t" << GravityKernels::getName(game.getGravityKernel()) << endl;
+	cout << "Threads:\t\t" << game.getThreadCount() << endl;
+	cout << "Orbits:\t\t\t" << (game.isKeplerOrbits() ? ORBITS_KEPLER : ORBITS_NUMERIC) << endl;
+	cout << "Collisions:\t\t" << (game.isContinuousCollisions() ? COLLISIONS_CONTINUOUS : COLLISIONS_DISCRETE) << endl;
+	cout << "Radius maps:\t\t" << game.getRadiusMapResolution()
+	     << " (" << (game.getRadiusMapMemorySize() / 1024.0) << " KiB)" << endl;
+	cout << endl;
+	double micro_per_tick = 1.0e6 / tick_count;
+	cout << "Microseconds per tick by phase" << endl;
+	cout << "  AI:\t\t\t"         << (total_times.m_ai           * micro_per_tick) << endl;
+	cout << "  Physics:\t\t"       << (total_times.m_physics      * micro_per_tick) << endl;
+	cout << "  Broad phase:\t\t"   << (total_times.m_broad_phase  * micro_per_tick) << endl;
+	cout << "  Narrow phase:\t\t"  << (total_times.m_narrow_phase * micro_per_tick) << endl;
+	cout << "  Resolution:\t\t"    << (total_times.m_resolution   * micro_per_tick) << endl;
+	cout << endl;
+	cout << "Collision pairs per tick" << endl;
+	cout << "  All pairs:\t\t"  << ((double)(total_possible_pairs)  / tick_count) << endl;
+	cout << "  Broad phase:\t\t" << ((double)(total_candidate_pairs) / tick_count) << endl;
+	cout << "  Colliding:\t\t"   << ((double)(total_collisions)      / tick_count) << endl;
+	cout << endl;
+	cout << "Drifting crystals:\t"  << game.getNonGoneCrystalCount() << endl;
+	cout << "Collected crystals:\t" << game.getCrystalsCollected() << endl;
+	cout << "Living drones:\t\t"    << game.getLivingDroneCount() << " of " << game.getDroneCount() << endl;
+	cout << "Player alive:\t\t"     << (game.isOver() ? "no" : "yes") << endl;
+
+	return 0;
+}
@@ -0,0 +1,293 @@
+//
+//  KeplerOrbit.cpp
+//
+
+#include "KeplerOrbit.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Gravity.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double TWO_PI = 6.283185307179586476925286766559;
+
+	// closer to 0 than this, the Stumpff functions use their series
+	const double STUMPFF_SERIES_MAX = 1.0;
+	const unsigned int STUMPFF_SERIES_TERMS = 10;
+
+	const unsigned int SOLVE_ITERATIONS_MAX = 100;
+	const double SOLVE_TOLERANCE = 4.0 * numeric_limits<double>::epsilon();
+
+}  // end of anonymous namespace
+
+
+
+bool KeplerOrbit :: isPossible (const ObjLibrary::Vector3& center,
+                                const ObjLibrary::Vector3& position)
+{
+	// same test as GravityKernels uses to skip gravity
+	return !(center - position).isZero();
+}
+
+
+
+KeplerOrbit :: KeplerOrbit ()
+		: KeplerOrbit(Vector3::ZERO, 1.0, Vector3(1.0, 0.0, 0.0), Vector3::ZERO)
+{
+	assert(invariant());
+}
+
+KeplerOrbit :: KeplerOrbit (const ObjLibrary::Vector3& center,
+                            double center_mass,
+                            const ObjLibrary::Vector3& position,
+                            const ObjLibrary::Vector3& velocity)
+		: m_center(center)
+		, m_center_mass(center_mass)
+		, m_sqrt_mu(sqrt(GRAVITY * center_mass))
+		, m_start_offset(position - center)
+		, m_start_velocity(velocity)
+		, m_start_distance(position.getDistance(center))
+		, m_start_sigma(0.0)   // set below
+		, m_alpha(0.0)         // set below
+		, m_period(0.0)        // set below
+		, m_time(0.0)
+		, m_anomaly(0.0)
+		, m_current_distance(m_start_distance)
+		, m_current_radial_speed(0.0)  // set below
+{
+	assert(center_mass > 0.0);
+	assert(isPossible(center, position));
+
+	double mu = m_sqrt_mu * m_sqrt_mu;
+	m_start_sigma = m_start_offset.dotProduct(velocity) / m_sqrt_mu;
+	m_current_radial_speed = m_start_sigma * m_sqrt_mu / m_start_distance;
+	m_alpha = 2.0 / m_start_distance - velocity.getNormSquared() / mu;
+	if(m_alpha > 0.0)
+		m_period = TWO_PI / (m_sqrt_mu * m_alpha * sqrt(m_alpha));
+
+	assert(invariant());
+}
+
+
+
+double KeplerOrbit :: getPeriod () const
+{
+	assert(isBound());
+
+	return m_period;
+}
+
+void KeplerOrbit :: calculateState (double delta_time,
+                                    ObjLibrary::Vector3& r_position,
+                                    ObjLibrary::Vector3& r_velocity) const
+{
+	double time = m_time + delta_time;
+	double guess = guessAnomaly(delta_time);
+
+	if(m_period > 0.0)
+	{
+		// stay within a period of the start, as advance does
+		double periods = floor(time / m_period);
+		time  -= periods * m_period;
+		guess -= periods * TWO_PI / sqrt(m_alpha);
+	}
+
+	double anomaly = solveAnomaly(time, guess);
+	calculateStateAtAnomaly(time, anomaly, r_position, r_velocity);
+}
+
+void KeplerOrbit :: advance (double delta_time,
+                             ObjLibrary::Vector3& r_position,
+                             ObjLibrary::Vector3& r_velocity)
+{
+	assert(delta_time >= 0.0);
+
+	double guess = guessAnomaly(delta_time);
+	m_time += delta_time;
+
+	if(m_period > 0.0 && m_time >= m_period)
+	{
+		// the anomaly increases by 2 * pi * sqrt(a) each period
+		double periods = floor(m_time / m_period);
+		m_time -= periods * m_period;
+		guess  -= periods * TWO_PI / sqrt(m_alpha);
+		if(m_time >= m_period)  // rounding error
+			m_time = 0.0;
+	}
+
+	m_anomaly = solveAnomaly(m_time, guess);
+	m_current_distance = calculateStateAtAnomaly(m_time, m_anomaly, r_position, r_velocity);
+	m_current_radial_speed = (r_position - m_center).dotProduct(r_velocity) / m_current_distance;
+
+	assert(invariant());
+}
+
+
+
+double KeplerOrbit :: guessAnomaly (double delta_time) const
+{
+	// the rate of change of the anomaly is sqrt(mu) / distance
+	double rate        = m_sqrt_mu / m_current_distance;
+	double rate_change = -rate * m_current_radial_speed / m_current_distance;
+	return m_anomaly + delta_time * (rate + 0.5 * delta_time * rate_change);
+}
+
+
+
+double KeplerOrbit :: solveAnomaly (double time, double guess) const
+{
+	//
+	//  Kepler's equation in universal variables is
+	//
+	//    F(x) = sigma0 * x^2 * C(z) + (1 - alpha * r0) * x^3 * S(z)
+	//           + r0 * x - sqrt(mu) * t = 0
+	//
+	//    where z = alpha * x^2.  The derivative F'(x) is the
+	//    distance from the point mass, which is always
+	//    positive, so there is exactly one solution, and it has
+	//    the same sign as t.  We use Newton's method, falling
+	//    back to bisection if a step would leave the range the
+	//    solution is known to be in or is not getting smaller
+	//    fast enough.  Newton's method alone is very slow on
+	//    hyperbolic orbits if the guess is too large, because
+	//    F(x) grows exponentially there.
+	//
+
+	static const double INFINITY_DOUBLE = numeric_limits<double>::infinity();
+
+	double target = m_sqrt_mu * time;
+	double ar_factor = 1.0 - m_alpha * m_start_distance;
+
+	double low  = (time >= 0.0) ? 0.0 : -INFINITY_DOUBLE;
+	double high = (time <= 0.0) ? 0.0 :  INFINITY_DOUBLE;
+	double step = sqrt(m_start_distance);  // for growing the range, same units as x
+	double last_change = INFINITY_DOUBLE;
+	double x = guess;
+	if(!(x > low && x < high))
+		x = (time >= 0.0) ? step : -step;
+
+	for(unsigned int i = 0; i < SOLVE_ITERATIONS_MAX; i++)
+	{
+		double x2 = x * x;
+		double z  = m_alpha * x2;
+		double c;
+		double s;
+		calculateStumpff(z, c, s);
+
+		double f = m_start_sigma * x2 * c + ar_factor * x2 * x * s + m_start_distance * x - target;
+		double f_prime = m_start_sigma * x * (1.0 - z * s) + ar_factor * x2 * c + m_start_distance;
+		double f_prime2 = m_start_sigma * (1.0 - z * c) + ar_factor * x * (1.0 - z * s);
+		if(f == 0.0)
+			return x;
+		if(f < 0.0)
+			low = x;
+		else
+			high = x;
+
+		double next = x - f / f_prime;
+		bool is_slow = fabs(next - x) * 2.0 > last_change;
+		if(!(next > low && next < high) || is_slow)
+		{
+			if(low == -INFINITY_DOUBLE)
+				next = high - step;
+			else if(high == INFINITY_DOUBLE)
+				next = low + step;
+			else
+				next = 0.5 * (low + high);
+			step *= 2.0;
+		}
+
+		// the error after a Newton step is about F'' / (2 * F') * change^2
+		double change = fabs(next - x);
+		if(!is_slow && change * change * fabs(f_prime2) <= SOLVE_TOLERANCE * fabs(next) * 2.0 * f_prime)
+			return next;
+		if(change <= SOLVE_TOLERANCE * fabs(x))
+			return next;
+		last_change = change;
+		x = next;
+	}
+
+	// only loses a little precision
+	return x;
+}
+
+double KeplerOrbit :: calculateStateAtAnomaly (double time,
+                                               double anomaly,
+                                               ObjLibrary::Vector3& r_position,
+                                               ObjLibrary::Vector3& r_velocity) const
+{
+	double x2 = anomaly * anomaly;
+	double z  = m_alpha * x2;
+	double c;
+	double s;
+	calculateStumpff(z, c, s);
+
+	// Lagrange coefficients
+	double f = 1.0 - x2 * c / m_start_distance;
+	double g = time - x2 * anomaly * s / m_sqrt_mu;
+	Vector3 offset = m_start_offset * f + m_start_velocity * g;
+	double distance = offset.getNorm();
+	assert(distance > 0.0);
+
+	double f_dot = m_sqrt_mu / (distance * m_start_distance) * anomaly * (z * s - 1.0);
+	double g_dot = 1.0 - x2 * c / distance;
+
+	r_position = m_center + offset;
+	r_velocity = m_start_offset * f_dot + m_start_velocity * g_dot;
+	return distance;
+}
+
+void KeplerOrbit :: calculateStumpff (double z,
+                                      double& r_c,
+                                      double& r_s)
+{
+	if(fabs(z) < STUMPFF_SERIES_MAX)
+	{
+		// C(z) = sum of (-z)^k / (2k + 2)!, S(z) = sum of (-z)^k / (2k + 3)!
+		double term_c = 0.5;
+		double term_s = 1.0 / 6.0;
+		r_c = term_c;
+		r_s = term_s;
+		for(unsigned int k = 1; k < STUMPFF_SERIES_TERMS; k++)
+		{
+			term_c *= -z / ((2 * k + 1) * (2 * k + 2));
+			term_s *= -z / ((2 * k + 2) * (2 * k + 3));
+			r_c += term_c;
+			r_s += term_s;
+		}
+	}
+	else if(z > 0.0)
+	{
+		double root = sqrt(z);
+		double half_sin = sin(root * 0.5);
+		double half_cos = cos(root * 0.5);  // compilers combine these
+		r_c = 2.0 * half_sin * half_sin / z;  // 1 - cos(x) without cancellation
+		r_s = (root - 2.0 * half_sin * half_cos) / (z * root);
+	}
+	else
+	{
+		double root = sqrt(-z);
+		double half_sinh = sinh(root * 0.5);
+		r_c = 2.0 * half_sinh * half_sinh / -z;
+		r_s = (sinh(root) - root) / (-z * root);
+	}
+}
+
+
+
+bool KeplerOrbit :: invariant () const
+{
+	if(m_center_mass <= 0.0) return false;
+	if(!(m_start_distance > 0.0)) return false;
+	if(!(m_current_distance > 0.0)) return false;
+	if(m_period < 0.0) return false;
+	if(m_period != 0.0 && m_time >= m_period) return false;
+	return true;
+}
@@ -0,0 +1,309 @@
+//
+//  KeplerOrbit.h
+//
+//  A module to calculate exactly where a body moving under the
+//    gravity of a single point mass will be.
+//
+
+#pragma once
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  KeplerOrbit
+//
+//  A class to represent the path of a body that is only
+//    affected by the gravity of a point mass, such as the black
+//    hole.  The orbit is calculated from the position and
+//    velocity of the body at a starting time, and can then give
+//    the position and velocity of the body at any later (or
+//    earlier) time at the same cost, no matter how far apart
+//    the times are.  Unlike stepping the body forward with
+//    numerical integration, no error builds up over time.
+//
+//  The calculations use the universal variable formulation of
+//    Kepler's equation, so they work for circular, elliptical,
+//    parabolic, and hyperbolic orbits alike.
+//
+//  A KeplerOrbit also stores a current time, which is moved
+//    forward with advance.  For elliptical orbits, this is
+//    kept within one period of the starting time, so precision
+//    does not get worse as the body goes around many times.
+//
+//  Class Invariant:
+//    <1> m_center_mass > 0.0
+//    <2> m_start_distance > 0.0
+//    <3> m_current_distance > 0.0
+//    <4> m_period >= 0.0
+//    <5> m_period == 0.0 || m_time < m_period
+//
+class KeplerOrbit
+{
+public:
+//
+//  isPossible
+//
+//  Purpose: To determine whether a KeplerOrbit can be
+//           calculated for a body at the specified position.
+//  Parameter(s):
+//    <1> center: The position of the point mass
+//    <2> position: The position of the body
+//  Preconditions: N/A
+//  Returns: Whether position is far enough from center.  A body
+//           at the point mass does not feel any gravity from it
+//           (see GravityKernels), so it has no orbit.
+//  Side Effect: N/A
+//
+	static bool isPossible (const ObjLibrary::Vector3& center,
+	                        const ObjLibrary::Vector3& position);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a placeholder KeplerOrbit.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new KeplerOrbit is created for a body at rest
+//               at (1, 0, 0) around a mass of 1 kg at the
+//               origin.
+//
+	KeplerOrbit ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a KeplerOrbit for a body with the
+//           specified position and velocity.
+//  Parameter(s):
+//    <1> center: The position of the point mass
+//    <2> center_mass: The mass of the point mass
+//    <3> position: The position of the body
+//    <4> velocity: The velocity of the body
+//  Preconditions:
+//    <1> center_mass > 0.0
+//    <2> isPossible(center, position)
+//  Returns: N/A
+//  Side Effect: A new KeplerOrbit is created for a body with
+//               position position and velocity velocity at
+//               the current time.
+//
+	KeplerOrbit (const ObjLibrary::Vector3& center,
+	             double center_mass,
+	             const ObjLibrary::Vector3& position,
+	             const ObjLibrary::Vector3& velocity);
+
+	KeplerOrbit (const KeplerOrbit& to_copy) = default;
+	~KeplerOrbit () = default;
+	KeplerOrbit& operator= (const KeplerOrbit& to_copy) = default;
+
+//
+//  isAround
+//
+//  Purpose: To determine whether this KeplerOrbit is around the
+//           specified point mass.
+//  Parameter(s):
+//    <1> center: The position of the point mass
+//    <2> center_mass: The mass of the point mass
+//  Preconditions: N/A
+//  Returns: Whether this KeplerOrbit was calculated for a point
+//           mass of mass center_mass at position center.
+//  Side Effect: N/A
+//
+	bool isAround (const ObjLibrary::Vector3& center,
+	               double center_mass) const
+	{  return center == m_center && center_mass == m_center_mass;  }
+
+//
+//  isBound
+//
+//  Purpose: To determine whether the body will keep going
+//           around the point mass.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this KeplerOrbit is a circle or an ellipse.
+//           If not, it is a parabola or hyperbola and the body
+//           will escape.
+//  Side Effect: N/A
+//
+	bool isBound () const
+	{  return m_period > 0.0;  }
+
+//
+//  getPeriod
+//
+//  Purpose: To determine how long the body takes to go around
+//           the point mass once.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isBound()
+//  Returns: The orbital period in seconds.
+//  Side Effect: N/A
+//
+	double getPeriod () const;
+
+//
+//  getSemimajorAxis
+//
+//  Purpose: To determine the size of this KeplerOrbit.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The semimajor axis.  This is negative for a
+//           hyperbolic orbit and infinite for a parabolic
+//           orbit.
+//  Side Effect: N/A
+//
+	double getSemimajorAxis () const
+	{  return 1.0 / m_alpha;  }
+
+//
+//  calculateState
+//
+//  Purpose: To calculate where the body will be after the
+//           specified time.
+//  Parameter(s):
+//    <1> delta_time: The time from the current time, in
+//                    seconds
+//    <2> r_position: A reference to a Vector3 to store the
+//                    position in
+//    <3> r_velocity: A reference to a Vector3 to store the
+//                    velocity in
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: r_position and r_velocity are set to the
+//               position and velocity of the body delta_time
+//               seconds after the current time.  If delta_time
+//               is negative, this is before the current time.
+//
+	void calculateState (double delta_time,
+	                     ObjLibrary::Vector3& r_position,
+	                     ObjLibrary::Vector3& r_velocity) const;
+
+//
+//  advance
+//
+//  Purpose: To move the current time forward.
+//  Parameter(s):
+//    <1> delta_time: The time to move forward by, in seconds
+//    <2> r_position: A reference to a Vector3 to store the new
+//                    position in
+//    <3> r_velocity: A reference to a Vector3 to store the new
+//                    velocity in
+//  Preconditions:
+//    <1> delta_time >= 0.0
+//  Returns: N/A
+//  Side Effect: The current time is moved forward by
+//               delta_time.  r_position and r_velocity are set
+//               to the position and velocity of the body at the
+//               new current time.
+//
+	void advance (double delta_time,
+	              ObjLibrary::Vector3& r_position,
+	              ObjLibrary::Vector3& r_velocity);
+
+private:
+//
+//  guessAnomaly
+//
+//  Purpose: To estimate the universal anomaly after the
+//           specified time.
+//  Parameter(s):
+//    <1> delta_time: The time from the current time, in
+//                    seconds
+//  Preconditions: N/A
+//  Returns: An estimate of the universal anomaly delta_time
+//           seconds after the current time, ignoring periods.
+//           This is very close for short times.
+//  Side Effect: N/A
+//
+	double guessAnomaly (double delta_time) const;
+
+//
+//  solveAnomaly
+//
+//  Purpose: To solve Kepler's equation for the universal
+//           anomaly at the specified time.
+//  Parameter(s):
+//    <1> time: The time since the starting time
+//    <2> guess: An estimate of the universal anomaly
+//  Preconditions: N/A
+//  Returns: The universal anomaly at time time.
+//  Side Effect: N/A
+//
+	double solveAnomaly (double time, double guess) const;
+
+//
+//  calculateStateAtAnomaly
+//
+//  Purpose: To calculate the position and velocity of the body
+//           for the specified universal anomaly.
+//  Parameter(s):
+//    <1> time: The time since the starting time
+//    <2> anomaly: The universal anomaly at time time
+//    <3> r_position: A reference to a Vector3 to store the
+//                    position in
+//    <4> r_velocity: A reference to a Vector3 to store the
+//                    velocity in
+//  Preconditions:
+//    <1> anomaly == solveAnomaly(time, ...)
+//  Returns: The distance from the point mass.
+//  Side Effect: r_position and r_velocity are set to the
+//               position and velocity of the body at time time.
+//
+	double calculateStateAtAnomaly (double time,
+	                                double anomaly,
+	                                ObjLibrary::Vector3& r_position,
+	                                ObjLibrary::Vector3& r_velocity) const;
+
+//
+//  Class Function: calculateStumpff
+//
+//  Purpose: To calculate the Stumpff functions C(z) and S(z).
+//  Parameter(s):
+//    <1> z: The value to calculate them for
+//    <2> r_c: A reference to a double to store C(z) in
+//    <3> r_s: A reference to a double to store S(z) in
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: r_c and r_s are set to C(z) and S(z).  Values
+//               of z near 0 use the Taylor series, which is
+//               more precise there.
+//
+	static void calculateStumpff (double z,
+	                              double& r_c,
+	                              double& r_s);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	ObjLibrary::Vector3 m_center;
+	double m_center_mass;
+	double m_sqrt_mu;  // square root of gravitational parameter
+
+	// state at the starting time, relative to the center
+	ObjLibrary::Vector3 m_start_offset;
+	ObjLibrary::Vector3 m_start_velocity;
+	double m_start_distance;
+	double m_start_sigma;  // offset dot velocity / m_sqrt_mu
+
+	double m_alpha;   // 1 / semimajor axis
+	double m_period;  // 0.0 if not bound
+
+	// current state
+	double m_time;
+	double m_anomaly;
+	double m_current_distance;
+	double m_current_radial_speed;
+};
@@ -0,0 +1,131 @@
+//
+//  NoiseBenchmark.cpp
+//
+//  A program to measure how fast PerlinNoiseField3 calculates
+//    noise.  Value noise and Perlin noise are timed with the
+//    lattice values found by hashing and from tables, and Perlin
+//    noise is also timed with each supported batch kernel.
+//
+//  Usage: noise_benchmark [sample_count]
+//
+
+#include <cassert>
+#include <cstdlib>  // for strtoul
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "PerlinNoiseField3.h"
+
+using namespace std;
+using namespace chrono;
+
+namespace
+{
+	const unsigned int DEFAULT_SAMPLE_COUNT = 1000000;
+	const float GRID_SIZE = 0.6f;  // same as Asteroid
+	const float POSITION_MAX = 1.0e4f;
+
+	void printUsage (const char* program)
+	{
+		cerr << "Usage: " << program << " [sample_count]" << endl;
+		cerr << "    sample_count: The number of points to calculate the noise at (default "
+		     << DEFAULT_SAMPLE_COUNT << ")" << endl;
+	}
+
+	float randomPosition ()
+	{
+		return (rand() / (float)(RAND_MAX) * 2.0f - 1.0f) * POSITION_MAX;
+	}
+
+	void printResult (const char* name,
+	                  duration<double> elapsed,
+	                  unsigned int sample_count,
+	                  double sum)
+	{
+		assert(sample_count > 0);
+
+		// the sum is printed so that the work cannot be skipped
+		cout << "  " << left << setw(24) << name << right
+		     << setw(10) << (elapsed.count() * 1.0e9 / sample_count) << " ns"
+		     << "\t(sum " << sum << ")" << endl;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main (int argc, char* argv[])
+{
+	unsigned int sample_count = DEFAULT_SAMPLE_COUNT;
+
+	if(argc > 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(argc > 1)
+		sample_count = strtoul(argv[1], nullptr, 10);
+	if(sample_count == 0)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	vector<float> v_x(sample_count);
+	vector<float> v_y(sample_count);
+	vector<float> v_z(sample_count);
+	vector<float> v_noise(sample_count);
+	for(unsigned int i = 0; i < sample_count; i++)
+	{
+		v_x[i] = randomPosition();
+		v_y[i] = randomPosition();
+		v_z[i] = randomPosition();
+	}
+
+	cout << fixed << setprecision(3);
+	cout << "Samples:\t" << sample_count << endl;
+	cout << endl;
+	cout << "Nanoseconds per sample" << endl;
+
+	for(unsigned int mode = 0; mode < PerlinNoiseField3::MODE_COUNT; mode++)
+	{
+		PerlinNoiseField3 noise(GRID_SIZE, 1.0f);
+		noise.setMode(mode);
+		string mode_name = PerlinNoiseField3::getModeName(mode);
+
+		double value_sum = 0.0;
+		steady_clock::time_point start_time = steady_clock::now();
+		for(unsigned int i = 0; i < sample_count; i++)
+			value_sum += noise.valueNoise(v_x[i], v_y[i], v_z[i]);
+		printResult((mode_name + " value").c_str(), steady_clock::now() - start_time,
+		            sample_count, value_sum);
+
+		double perlin_sum = 0.0;
+		start_time = steady_clock::now();
+		for(unsigned int i = 0; i < sample_count; i++)
+			perlin_sum += noise.perlinNoise(v_x[i], v_y[i], v_z[i]);
+		printResult((mode_name + " Perlin").c_str(), steady_clock::now() - start_time,
+		            sample_count, perlin_sum);
+
+		for(unsigned int k = 0; k < PerlinNoiseField3::KERNEL_COUNT; k++)
+		{
+			if(!PerlinNoiseField3::isKernelSupported(k))
+				continue;
+
+			start_time = steady_clock::now();
+			noise.perlinNoise(k, sample_count, v_x.data(), v_y.data(), v_z.data(), v_noise.data());
+			duration<double> elapsed = steady_clock::now() - start_time;
+
+			double batch_sum = 0.0;
+			for(unsigned int i = 0; i < sample_count; i++)
+				batch_sum += v_noise[i];
+			printResult((mode_name + " Perlin " + PerlinNoiseField3::getKernelName(k)).c_str(),
+			            elapsed, sample_count, batch_sum);
+		}
+	}
+
+	return 0;
+}
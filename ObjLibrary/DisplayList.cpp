@@ -20,7 +20,12 @@
 #include <cassert>
 #include <cstddef>	// for NULL
 
-#include "../GetGlut.h"
+#include "ObjSettings.h"
+
+#ifndef OBJ_LIBRARY_HEADLESS
+	#include "../GetGlut.h"
+#endif
+
 #include "DisplayList.h"
 
 using namespace ObjLibrary;
@@ -120,7 +125,9 @@ void DisplayList :: draw () const
 	assert(!isDisabledForExit());
 	assert(isReady());
 
+#ifndef OBJ_LIBRARY_HEADLESS
 	glCallList(mp_data->m_list_id);
+#endif
 }
 
 
@@ -137,8 +144,10 @@ void DisplayList :: makeEmpty ()
 		mp_data->m_usages--;
 		if(mp_data->m_usages == 0)
 		{
+#ifndef OBJ_LIBRARY_HEADLESS
 			if(!isDisabledForExit())
 				glDeleteLists(mp_data->m_list_id, 1);
+#endif
 			delete mp_data;
 		}
 		mp_data = NULL;
@@ -161,9 +170,13 @@ void DisplayList :: begin ()
 
 	mp_data = new InnerData();
 	mp_data->m_usages = 0;
+#ifdef OBJ_LIBRARY_HEADLESS
+	mp_data->m_list_id = 0;  // no OpenGL, so no real display list
+#else
 	mp_data->m_list_id = glGenLists(1);
 
 	glNewList(mp_data->m_list_id, GL_COMPILE);
+#endif
 
 	assert(getState() == PARTIAL);
 }
@@ -174,7 +187,9 @@ void DisplayList :: end ()
 	assert(!isDisabledForExit());
 	assert(isPartial());
 
+#ifndef OBJ_LIBRARY_HEADLESS
 	glEndList();
+#endif
 
 	assert(mp_data->m_usages == 0);
 	mp_data->m_usages = 1;
@@ -61,6 +61,10 @@ namespace ObjLibrary
 //      <5> Call dl.draw() whenever you want to execute those
 //          commands.
 //
+//  If OBJ_LIBRARY_HEADLESS is defined, no OpenGL display list
+//    is ever created.  A DisplayList still moves through the
+//    same states, but drawing it does nothing.
+//
 class DisplayList
 {
 public:
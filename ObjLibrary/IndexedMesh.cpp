@@ -0,0 +1,716 @@
+//
+//  IndexedMesh.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for NULL
+#include <climits>	// for UINT_MAX
+#include <cmath>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjSettings.h"
+
+#if !defined(OBJ_LIBRARY_HEADLESS) && !defined(OBJ_LIBRARY_SHADER_DISPLAY)
+	#include "../GetGlut.h"
+#endif
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include "DisplayList.h"
+#include "Material.h"
+#include "ObjModel.h"
+#include "IndexedMesh.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const Vector2 FALLBACK_TEXTURE_COORDINATE(0.0, 0.0);
+	const Vector3 FALLBACK_NORMAL(0.0, 0.0, 1.0);
+
+	//
+	//  FaceVertexKey
+	//
+	//  The indexes that make a face vertex in an ObjModel.  Face
+	//    vertexes with the same key become the same vertex.
+	//
+	struct FaceVertexKey
+	{
+		unsigned int m_vertex;
+		unsigned int m_texture_coordinates;
+		unsigned int m_normal;
+
+		bool operator== (const FaceVertexKey& other) const
+		{
+			return m_vertex              == other.m_vertex &&
+			       m_texture_coordinates == other.m_texture_coordinates &&
+			       m_normal              == other.m_normal;
+		}
+	};
+
+	struct FaceVertexKeyHash
+	{
+		size_t operator() (const FaceVertexKey& key) const
+		{
+			size_t hash = key.m_vertex;
+			hash = hash * 1000003 ^ key.m_texture_coordinates;
+			hash = hash * 1000003 ^ key.m_normal;
+			return hash;
+		}
+	};
+
+	const unsigned int NO_VERTEX = UINT_MAX;
+
+	//
+	//  The vertex scoring for the vertex cache optimisation,
+	//    using the values from Tom Forsyth's "Linear-Speed
+	//    Vertex Cache Optimisation" (2006).
+	//
+	const int   NOT_IN_CACHE        = -1;
+	const float CACHE_DECAY_POWER   = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.0f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	float calculateVertexScore (int cache_position,
+	                            unsigned int remaining_triangles)
+	{
+		if(remaining_triangles == 0)
+			return -1.0f;  // never needed again
+
+		float score = 0.0f;  // if not in the cache
+		if(cache_position != NOT_IN_CACHE && cache_position < 3)
+		{
+			// the last triangle's vertexes all score the same,
+			//   or it would not matter which of them was reused
+			score = LAST_TRIANGLE_SCORE;
+		}
+		else if(cache_position != NOT_IN_CACHE)
+		{
+			assert(cache_position < (int)(IndexedMesh::VERTEX_CACHE_SIZE));
+			float scaler = 1.0f / (IndexedMesh::VERTEX_CACHE_SIZE - 3);
+			score = pow(1.0f - (cache_position - 3) * scaler, CACHE_DECAY_POWER);
+		}
+
+		// prefer vertexes with few triangles left, so they are finished off
+		score += VALENCE_BOOST_SCALE * pow((float)(remaining_triangles), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+	// scores are looked up for vertexes with fewer triangles left than this
+	const unsigned int SCORE_TABLE_REMAINING_COUNT = 32;
+
+	vector<float> createVertexScoreTable ()
+	{
+		vector<float> v_table((IndexedMesh::VERTEX_CACHE_SIZE + 1) * SCORE_TABLE_REMAINING_COUNT);
+		for(unsigned int p = 0; p <= IndexedMesh::VERTEX_CACHE_SIZE; p++)
+			for(unsigned int r = 0; r < SCORE_TABLE_REMAINING_COUNT; r++)
+				v_table[p * SCORE_TABLE_REMAINING_COUNT + r] = calculateVertexScore((int)(p) - 1, r);
+		return v_table;
+	}
+
+	float getVertexScore (const vector<float>& v_table,
+	                      int cache_position,
+	                      unsigned int remaining_triangles)
+	{
+		assert(v_table.size() == (IndexedMesh::VERTEX_CACHE_SIZE + 1) * SCORE_TABLE_REMAINING_COUNT);
+
+		if(remaining_triangles < SCORE_TABLE_REMAINING_COUNT)
+			return v_table[(cache_position + 1) * SCORE_TABLE_REMAINING_COUNT + remaining_triangles];
+		else
+			return calculateVertexScore(cache_position, remaining_triangles);
+	}
+
+	//
+	//  optimizeTriangleOrder
+	//
+	//  Purpose: To reorder a range of triangles for the vertex
+	//           cache.
+	//  Parameter(s):
+	//    <1> r_indexes: The indexes
+	//    <2> first_index: The first index in the range
+	//    <3> index_count: The number of indexes in the range
+	//    <4> vertex_count: The number of vertexes indexed
+	//  Precondition(s):
+	//    <1> first_index + index_count <= r_indexes.size()
+	//    <2> index_count % 3 == 0
+	//    <3> Every element of r_indexes < vertex_count
+	//  Returns: N/A
+	//  Side Effect: The triangles in the range are reordered.
+	//               Each triangle keeps its vertexes in the
+	//               same order.
+	//
+	void optimizeTriangleOrder (vector<unsigned int>& r_indexes,
+	                            unsigned int first_index,
+	                            unsigned int index_count,
+	                            unsigned int vertex_count)
+	{
+		assert(first_index + index_count <= r_indexes.size());
+		assert(index_count % 3 == 0);
+
+		const unsigned int* a_indexes = r_indexes.data() + first_index;
+		unsigned int triangle_count = index_count / 3;
+		if(triangle_count == 0)
+			return;
+
+		// the triangles using each vertex, with the ones not added yet first
+		vector<unsigned int> v_remaining(vertex_count, 0);
+		for(unsigned int i = 0; i < index_count; i++)
+		{
+			assert(a_indexes[i] < vertex_count);
+			v_remaining[a_indexes[i]]++;
+		}
+		vector<unsigned int> v_adjacency_start(vertex_count + 1, 0);
+		for(unsigned int v = 0; v < vertex_count; v++)
+			v_adjacency_start[v + 1] = v_adjacency_start[v] + v_remaining[v];
+		vector<unsigned int> v_adjacency(index_count);
+		vector<unsigned int> v_adjacency_filled(v_adjacency_start.begin(), v_adjacency_start.end() - 1);
+		for(unsigned int i = 0; i < index_count; i++)
+		{
+			unsigned int v = a_indexes[i];
+			v_adjacency[v_adjacency_filled[v]] = i / 3;
+			v_adjacency_filled[v]++;
+		}
+
+		static const vector<float> v_score_table = createVertexScoreTable();  // thread-safe initialization
+		vector<int>   v_cache_position(vertex_count, NOT_IN_CACHE);
+		vector<float> v_vertex_score(vertex_count);
+		for(unsigned int v = 0; v < vertex_count; v++)
+			v_vertex_score[v] = getVertexScore(v_score_table, NOT_IN_CACHE, v_remaining[v]);
+
+		vector<float> v_triangle_score(triangle_count);
+		vector<char>  v_is_added(triangle_count, 0);
+		unsigned int best = 0;
+		for(unsigned int t = 0; t < triangle_count; t++)
+		{
+			v_triangle_score[t] = v_vertex_score[a_indexes[t * 3 + 0]] +
+			                      v_vertex_score[a_indexes[t * 3 + 1]] +
+			                      v_vertex_score[a_indexes[t * 3 + 2]];
+			if(v_triangle_score[t] > v_triangle_score[best])
+				best = t;
+		}
+
+		vector<unsigned int> v_cache;
+		vector<unsigned int> v_new_cache;
+		vector<unsigned int> v_output;
+		v_output.reserve(index_count);
+		unsigned int next_unadded = 0;
+		while(v_output.size() < index_count)
+		{
+			assert(best < triangle_count);
+			assert(!v_is_added[best]);
+			v_is_added[best] = 1;
+
+			// the new triangle goes at the front of the cache
+			v_new_cache.clear();
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int v = a_indexes[best * 3 + c];
+				v_output.push_back(v);
+				v_new_cache.push_back(v);
+
+				// move the triangle to the end of the ones not added
+				unsigned int start = v_adjacency_start[v];
+				unsigned int last  = start + v_remaining[v] - 1;
+				unsigned int a = start;
+				while(v_adjacency[a] != best)
+					a++;
+				assert(a <= last);
+				v_adjacency[a]    = v_adjacency[last];
+				v_adjacency[last] = best;
+				v_remaining[v]--;
+			}
+			for(unsigned int c = 0; c < v_cache.size(); c++)
+			{
+				unsigned int v = v_cache[c];
+				if(v != v_new_cache[0] && v != v_new_cache[1] && v != v_new_cache[2])
+					v_new_cache.push_back(v);
+			}
+
+			// update vertexes that moved or fell out
+			for(unsigned int c = 0; c < v_new_cache.size(); c++)
+			{
+				unsigned int v = v_new_cache[c];
+				if(c < IndexedMesh::VERTEX_CACHE_SIZE)
+					v_cache_position[v] = c;
+				else
+					v_cache_position[v] = NOT_IN_CACHE;
+				v_vertex_score[v] = getVertexScore(v_score_table, v_cache_position[v], v_remaining[v]);
+			}
+
+			// the next triangle is the best one using a vertex that changed
+			best = triangle_count;
+			float best_score = -1.0f;
+			for(unsigned int c = 0; c < v_new_cache.size(); c++)
+			{
+				unsigned int v = v_new_cache[c];
+				for(unsigned int a = v_adjacency_start[v]; a < v_adjacency_start[v] + v_remaining[v]; a++)
+				{
+					unsigned int t = v_adjacency[a];
+					v_triangle_score[t] = v_vertex_score[a_indexes[t * 3 + 0]] +
+					                      v_vertex_score[a_indexes[t * 3 + 1]] +
+					                      v_vertex_score[a_indexes[t * 3 + 2]];
+					if(v_triangle_score[t] > best_score)
+					{
+						best = t;
+						best_score = v_triangle_score[t];
+					}
+				}
+			}
+
+			if(v_new_cache.size() > IndexedMesh::VERTEX_CACHE_SIZE)
+				v_new_cache.resize(IndexedMesh::VERTEX_CACHE_SIZE);
+			v_cache.swap(v_new_cache);
+
+			// if nothing in the cache is any use, start somewhere new
+			if(best == triangle_count && v_output.size() < index_count)
+			{
+				while(v_is_added[next_unadded])
+					next_unadded++;
+				best = next_unadded;
+			}
+		}
+
+		for(unsigned int i = 0; i < index_count; i++)
+			r_indexes[first_index + i] = v_output[i];
+	}
+}
+
+
+
+const unsigned int IndexedMesh :: MAX_16_BIT_VERTEX_COUNT;  // value is set in header file
+const unsigned int IndexedMesh :: VERTEX_CACHE_SIZE;  // value is set in header file
+
+
+
+IndexedMesh :: IndexedMesh ()
+		: m_is_texture_coordinates(false)
+		, m_is_normals(false)
+		, mv_vertex_data()
+		, mv_indexes_16()
+		, mv_indexes_32()
+		, mvp_group_materials()
+		, mv_group_first_indexes()
+		, mv_group_index_counts()
+{
+	assert(isEmpty());
+	assert(invariant());
+}
+
+IndexedMesh :: IndexedMesh (const ObjModel& model)
+		: m_is_texture_coordinates(false)
+		, m_is_normals(false)
+		, mv_vertex_data()
+		, mv_indexes_16()
+		, mv_indexes_32()
+		, mvp_group_materials()
+		, mv_group_first_indexes()
+		, mv_group_index_counts()
+{
+	assert(model.isValid());
+
+	init(model, 0, model.getMeshCount());
+
+	assert(invariant());
+}
+
+IndexedMesh :: IndexedMesh (const ObjModel& model,
+                            unsigned int mesh)
+		: m_is_texture_coordinates(false)
+		, m_is_normals(false)
+		, mv_vertex_data()
+		, mv_indexes_16()
+		, mv_indexes_32()
+		, mvp_group_materials()
+		, mv_group_first_indexes()
+		, mv_group_index_counts()
+{
+	assert(model.isValid());
+	assert(mesh < model.getMeshCount());
+
+	init(model, mesh, mesh + 1);
+
+	assert(invariant());
+}
+
+
+
+unsigned int IndexedMesh :: getFloatsPerVertex () const
+{
+	unsigned int floats = 3;
+	if(m_is_texture_coordinates)
+		floats += 2;
+	if(m_is_normals)
+		floats += 3;
+	return floats;
+}
+
+const unsigned short* IndexedMesh :: getIndexes16 () const
+{
+	assert(isIndexes16Bit());
+
+	return mv_indexes_16.data();
+}
+
+const unsigned int* IndexedMesh :: getIndexes32 () const
+{
+	assert(!isIndexes16Bit());
+
+	return mv_indexes_32.data();
+}
+
+const Material* IndexedMesh :: getGroupMaterial (unsigned int group) const
+{
+	assert(group < getGroupCount());
+
+	return mvp_group_materials[group];
+}
+
+unsigned int IndexedMesh :: getGroupFirstIndex (unsigned int group) const
+{
+	assert(group < getGroupCount());
+
+	return mv_group_first_indexes[group];
+}
+
+unsigned int IndexedMesh :: getGroupIndexCount (unsigned int group) const
+{
+	assert(group < getGroupCount());
+
+	return mv_group_index_counts[group];
+}
+
+double IndexedMesh :: calculateAcmr (unsigned int cache_size) const
+{
+	assert(cache_size >= 3);
+
+	if(isEmpty())
+		return 0.0;
+
+	// a vertex is still in a FIFO cache if fewer than cache_size misses came after it
+	vector<unsigned int> v_indexes = getIndexes();
+	vector<unsigned int> v_miss_when_added(getVertexCount(), NO_VERTEX);
+	unsigned int miss_count = 0;
+	for(unsigned int i = 0; i < v_indexes.size(); i++)
+	{
+		unsigned int added = v_miss_when_added[v_indexes[i]];
+		if(added == NO_VERTEX || miss_count - added >= cache_size)
+		{
+			v_miss_when_added[v_indexes[i]] = miss_count;
+			miss_count++;
+		}
+	}
+
+	return (double)(miss_count) / (v_indexes.size() / 3);
+}
+
+
+
+#if !defined(OBJ_LIBRARY_HEADLESS) && !defined(OBJ_LIBRARY_SHADER_DISPLAY)
+
+void IndexedMesh :: draw () const
+{
+	assert(!Material::isMaterialActive());
+
+	for(unsigned int g = 0; g < getGroupCount(); g++)
+	{
+		const Material* p_material = mvp_group_materials[g];
+		if(p_material == NULL)
+			drawGroupMaterialNone(g);
+		else
+		{
+			p_material->activate();
+			drawGroupMaterialNone(g);
+			Material::deactivate();
+
+			if(p_material->isSeperateSpecular())
+			{
+				p_material->activateSeperateSpecular();
+				drawGroupMaterialNone(g);
+				Material::deactivate();
+			}
+		}
+	}
+
+	assert(!Material::isMaterialActive());
+}
+
+void IndexedMesh :: drawMaterialNone () const
+{
+	drawIndexes(0, getIndexCount());
+}
+
+void IndexedMesh :: drawGroupMaterialNone (unsigned int group) const
+{
+	assert(group < getGroupCount());
+
+	drawIndexes(mv_group_first_indexes[group], mv_group_index_counts[group]);
+}
+
+DisplayList IndexedMesh :: getDisplayList () const
+{
+	assert(!Material::isMaterialActive());
+
+	DisplayList list;
+
+	list.begin();
+		draw();
+	list.end();
+
+	return list;
+}
+
+DisplayList IndexedMesh :: getDisplayListMaterialNone () const
+{
+	DisplayList list;
+
+	list.begin();
+		drawMaterialNone();
+	list.end();
+
+	return list;
+}
+
+DisplayList IndexedMesh :: getDisplayListGroupMaterialNone (unsigned int group) const
+{
+	assert(group < getGroupCount());
+
+	DisplayList list;
+
+	list.begin();
+		drawGroupMaterialNone(group);
+	list.end();
+
+	return list;
+}
+
+#endif  // not headless and OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+
+
+void IndexedMesh :: optimizeVertexCache ()
+{
+	vector<unsigned int> v_indexes = getIndexes();
+	for(unsigned int g = 0; g < getGroupCount(); g++)
+	{
+		optimizeTriangleOrder(v_indexes, mv_group_first_indexes[g],
+		                      mv_group_index_counts[g], getVertexCount());
+	}
+	setIndexes(v_indexes);
+
+	assert(invariant());
+}
+
+void IndexedMesh :: optimizeVertexFetch ()
+{
+	unsigned int floats_per_vertex = getFloatsPerVertex();
+	vector<unsigned int> v_indexes = getIndexes();
+	vector<unsigned int> v_new_vertexes(getVertexCount(), NO_VERTEX);
+	vector<float> v_vertex_data;
+	v_vertex_data.reserve(mv_vertex_data.size());
+
+	for(unsigned int i = 0; i < v_indexes.size(); i++)
+	{
+		unsigned int old_vertex = v_indexes[i];
+		if(v_new_vertexes[old_vertex] == NO_VERTEX)
+		{
+			v_new_vertexes[old_vertex] = v_vertex_data.size() / floats_per_vertex;
+			v_vertex_data.insert(v_vertex_data.end(),
+			                     mv_vertex_data.begin() +  old_vertex      * floats_per_vertex,
+			                     mv_vertex_data.begin() + (old_vertex + 1) * floats_per_vertex);
+		}
+		v_indexes[i] = v_new_vertexes[old_vertex];
+	}
+
+	// unused vertexes were dropped, so the index size may change
+	mv_vertex_data.swap(v_vertex_data);
+	setIndexes(v_indexes);
+
+	assert(invariant());
+}
+
+
+
+void IndexedMesh :: init (const ObjModel& model,
+                          unsigned int first_mesh,
+                          unsigned int end_mesh)
+{
+	assert(model.isValid());
+	assert(first_mesh <= end_mesh);
+	assert(end_mesh <= model.getMeshCount());
+	assert(isEmpty());
+
+	// the vertex format has to be known before any vertexes are added
+	for(unsigned int m = first_mesh; m < end_mesh; m++)
+	{
+		if(model.isMeshTextureCoordinatesAny(m))
+			m_is_texture_coordinates = true;
+		if(model.isMeshNormalAny(m))
+			m_is_normals = true;
+	}
+
+	// meshes with the same material go in the same group
+	vector<unsigned int> v_mesh_groups;
+	for(unsigned int m = first_mesh; m < end_mesh; m++)
+	{
+		const Material* p_material = NULL;
+		if(model.isMeshMaterial(m))
+			p_material = model.getMeshMaterial(m);
+
+		unsigned int group = 0;
+		while(group < mvp_group_materials.size() && mvp_group_materials[group] != p_material)
+			group++;
+		if(group == mvp_group_materials.size())
+			mvp_group_materials.push_back(p_material);
+		v_mesh_groups.push_back(group);
+	}
+
+	unordered_map<FaceVertexKey, unsigned int, FaceVertexKeyHash> vertex_indexes;
+	vector<unsigned int> v_indexes;
+	vector<unsigned int> v_face_indexes;
+	for(unsigned int g = 0; g < mvp_group_materials.size(); g++)
+	{
+		mv_group_first_indexes.push_back(v_indexes.size());
+
+		for(unsigned int m = first_mesh; m < end_mesh; m++)
+		{
+			if(v_mesh_groups[m - first_mesh] != g)
+				continue;
+
+			for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+			{
+				v_face_indexes.clear();
+				for(unsigned int v = 0; v < model.getFaceVertexCount(m, f); v++)
+				{
+					FaceVertexKey key;
+					key.m_vertex              = model.getFaceVertexIndex(m, f, v);
+					key.m_texture_coordinates = model.getFaceVertexTextureCoordinates(m, f, v);
+					key.m_normal              = model.getFaceVertexNormal(m, f, v);
+
+					unsigned int index = mv_vertex_data.size() / getFloatsPerVertex();
+					pair<unordered_map<FaceVertexKey, unsigned int, FaceVertexKeyHash>::iterator, bool> inserted =
+					        vertex_indexes.insert(make_pair(key, index));
+					if(inserted.second)
+					{
+						// same order as glInterleavedArrays
+						if(m_is_texture_coordinates)
+						{
+							Vector2 texture_coordinates = FALLBACK_TEXTURE_COORDINATE;
+							if(key.m_texture_coordinates != ObjModel::NO_TEXTURE_COORDINATES)
+								texture_coordinates = model.getTextureCoordinate(key.m_texture_coordinates);
+
+							// flip texture coordinates to match Maya <|>
+							mv_vertex_data.push_back((float)(      texture_coordinates.x));
+							mv_vertex_data.push_back((float)(1.0 - texture_coordinates.y));
+						}
+						if(m_is_normals)
+						{
+							Vector3 normal = FALLBACK_NORMAL;
+							if(key.m_normal != ObjModel::NO_NORMAL)
+								normal = model.getNormalVector(key.m_normal);
+							mv_vertex_data.push_back((float)(normal.x));
+							mv_vertex_data.push_back((float)(normal.y));
+							mv_vertex_data.push_back((float)(normal.z));
+						}
+						const Vector3& position = model.getVertexPosition(key.m_vertex);
+						mv_vertex_data.push_back((float)(position.x));
+						mv_vertex_data.push_back((float)(position.y));
+						mv_vertex_data.push_back((float)(position.z));
+					}
+					v_face_indexes.push_back(inserted.first->second);
+				}
+
+				// split into a triangle fan, like ObjModel::drawFaces
+				for(unsigned int v = 2; v < v_face_indexes.size(); v++)
+				{
+					v_indexes.push_back(v_face_indexes[0]);
+					v_indexes.push_back(v_face_indexes[v - 1]);
+					v_indexes.push_back(v_face_indexes[v]);
+				}
+			}
+		}
+
+		mv_group_index_counts.push_back(v_indexes.size() - mv_group_first_indexes[g]);
+	}
+
+	setIndexes(v_indexes);
+
+	assert(invariant());
+}
+
+vector<unsigned int> IndexedMesh :: getIndexes () const
+{
+	if(isIndexes16Bit())
+		return vector<unsigned int>(mv_indexes_16.begin(), mv_indexes_16.end());
+	else
+		return mv_indexes_32;
+}
+
+void IndexedMesh :: setIndexes (const vector<unsigned int>& v_indexes)
+{
+	assert(v_indexes.size() % 3 == 0);
+
+	mv_indexes_16.clear();
+	mv_indexes_32.clear();
+	if(isIndexes16Bit())
+		mv_indexes_16.assign(v_indexes.begin(), v_indexes.end());
+	else
+		mv_indexes_32 = v_indexes;
+}
+
+#if !defined(OBJ_LIBRARY_HEADLESS) && !defined(OBJ_LIBRARY_SHADER_DISPLAY)
+
+void IndexedMesh :: drawIndexes (unsigned int first_index,
+                                 unsigned int index_count) const
+{
+	assert(first_index + index_count <= getIndexCount());
+
+	if(index_count == 0)
+		return;
+
+	GLenum format = GL_V3F;
+	if(m_is_texture_coordinates && m_is_normals)
+		format = GL_T2F_N3F_V3F;
+	else if(m_is_texture_coordinates)
+		format = GL_T2F_V3F;
+	else if(m_is_normals)
+		format = GL_N3F_V3F;
+
+	// the arrays are read when the call runs, so this also works in a display list
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+		glInterleavedArrays(format, 0, mv_vertex_data.data());
+		if(isIndexes16Bit())
+			glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_SHORT, mv_indexes_16.data() + first_index);
+		else
+			glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT,   mv_indexes_32.data() + first_index);
+	glPopClientAttrib();
+}
+
+#endif  // not headless and OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+bool IndexedMesh :: invariant () const
+{
+	if(mv_vertex_data.size() % getFloatsPerVertex() != 0) return false;
+	if(!mv_indexes_16.empty() && !mv_indexes_32.empty()) return false;
+	if(getIndexCount() % 3 != 0) return false;
+	if(mvp_group_materials.size() != mv_group_first_indexes.size()) return false;
+	if(mvp_group_materials.size() != mv_group_index_counts.size()) return false;
+	return true;
+}
@@ -0,0 +1,595 @@
+//
+//  IndexedMesh.h
+//
+//  A module to store the faces of an ObjModel as indexed
+//    vertex arrays.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_INDEXED_MESH_H
+#define OBJ_LIBRARY_INDEXED_MESH_H
+
+#include <vector>
+
+#include "ObjSettings.h"
+#include "DisplayList.h"
+
+
+
+namespace ObjLibrary
+{
+
+class Material;
+class ObjModel;
+
+
+
+//
+//  IndexedMesh
+//
+//  A class to store the faces of an ObjModel as an array of
+//    vertexes and an array of triangle indexes into it.  Each
+//    face vertex in the ObjModel is a combination of a
+//    position, texture coordinates, and a normal.  Every
+//    different combination becomes one vertex in the array, so
+//    a vertex shared by several faces is only stored once.
+//    Faces with more than 3 vertexes are split into triangle
+//    fans, the same way ObjModel draws them.
+//
+//  The vertex data is stored in floats, interleaved in the
+//    order used by glInterleavedArrays: texture coordinates (if
+//    any), then the normal (if any), and then the position.
+//    The texture coordinates are flipped vertically in the same
+//    way as when an ObjModel is drawn.  A vertex without
+//    texture coordinates or a normal in a mesh where other
+//    vertexes have them is given (0, 0) or (0, 0, 1).
+//
+//  The indexes are stored as 16-bit numbers if there are few
+//    enough vertexes, and as 32-bit numbers otherwise.  They
+//    are divided into groups, one for each different material.
+//    Meshes in the ObjModel with the same material are combined
+//    into the same group.
+//
+//  Creating an IndexedMesh does not use OpenGL, so it can be
+//    done on any thread.  Only the drawing functions need
+//    OpenGL.  Point sets and polylines are not included.
+//
+//  The triangles are stored in the order they are in the
+//    ObjModel, which may make poor use of the cache of
+//    transformed vertexes on the graphics card.  They can be
+//    reordered with optimizeVertexCache, and the vertexes
+//    can then be put in the order they are used with
+//    optimizeVertexFetch.  The average cache miss ratio (ACMR)
+//    can be found with calculateAcmr.
+//
+//  Class Invariant:
+//    <1> mv_vertex_data.size() % getFloatsPerVertex() == 0
+//    <2> mv_indexes_16.empty() || mv_indexes_32.empty()
+//    <3> getIndexCount() % 3 == 0
+//    <4> mvp_group_materials.size() ==
+//                                  mv_group_first_indexes.size()
+//    <5> mvp_group_materials.size() ==
+//                                  mv_group_index_counts.size()
+//
+class IndexedMesh
+{
+public:
+//
+//  MAX_16_BIT_VERTEX_COUNT
+//
+//  The most vertexes that can be indexed with 16-bit indexes.
+//
+	static const unsigned int MAX_16_BIT_VERTEX_COUNT = 65536;
+
+//
+//  VERTEX_CACHE_SIZE
+//
+//  The number of vertexes in the cache modelled by
+//    optimizeVertexCache.  Real caches are often smaller, but
+//    the order is still good for them.
+//
+	static const unsigned int VERTEX_CACHE_SIZE = 32;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new IndexedMesh with no faces.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new empty IndexedMesh is created.
+//
+	IndexedMesh ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new IndexedMesh for the faces in the
+//           specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//  Precondition(s):
+//    <1> model.isValid()
+//  Returns: N/A
+//  Side Effect: A new IndexedMesh is created containing the
+//               faces in all meshes of model.  There is one
+//               group for each different material, in the order
+//               they are first used.
+//
+	IndexedMesh (const ObjModel& model);
+
+//
+//  Constructor
+//
+//  Purpose: To create a new IndexedMesh for the faces in the
+//           specified mesh of the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> mesh: Which mesh
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> mesh < model.getMeshCount()
+//  Returns: N/A
+//  Side Effect: A new IndexedMesh is created containing the
+//               faces in mesh mesh of model.  There is a single
+//               group.
+//
+	IndexedMesh (const ObjModel& model,
+	             unsigned int mesh);
+
+	IndexedMesh (const IndexedMesh& original) = default;
+	~IndexedMesh () = default;
+	IndexedMesh& operator= (const IndexedMesh& original) = default;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this IndexedMesh contains any
+//           triangles.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this IndexedMesh contains no triangles.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{	return getIndexCount() == 0;	}
+
+//
+//  isTextureCoordinates
+//
+//  Purpose: To determine if the vertexes in this IndexedMesh
+//           include texture coordinates.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether texture coordinates are included.
+//  Side Effect: N/A
+//
+	bool isTextureCoordinates () const
+	{	return m_is_texture_coordinates;	}
+
+//
+//  isNormals
+//
+//  Purpose: To determine if the vertexes in this IndexedMesh
+//           include normal vectors.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether normals are included.
+//  Side Effect: N/A
+//
+	bool isNormals () const
+	{	return m_is_normals;	}
+
+//
+//  getFloatsPerVertex
+//
+//  Purpose: To determine how many floats are stored for each
+//           vertex in this IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of floats for each vertex.  This is 3,
+//           plus 2 if there are texture coordinates, plus 3 if
+//           there are normals.
+//  Side Effect: N/A
+//
+	unsigned int getFloatsPerVertex () const;
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine how many different vertexes are in
+//           this IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertexes.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const
+	{	return mv_vertex_data.size() / getFloatsPerVertex();	}
+
+//
+//  getVertexData
+//
+//  Purpose: To retrieve the interleaved vertex data for this
+//           IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to an array of getVertexCount() *
+//           getFloatsPerVertex() floats.  If this IndexedMesh
+//           contains no vertexes, NULL may be returned.
+//  Side Effect: N/A
+//
+	const float* getVertexData () const
+	{	return mv_vertex_data.data();	}
+
+//
+//  getIndexCount
+//
+//  Purpose: To determine how many indexes are in this
+//           IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of indexes.  This is 3 times the number
+//           of triangles.
+//  Side Effect: N/A
+//
+	unsigned int getIndexCount () const
+	{	return mv_indexes_16.size() + mv_indexes_32.size();	}
+
+//
+//  isIndexes16Bit
+//
+//  Purpose: To determine if the indexes in this IndexedMesh are
+//           stored as 16-bit numbers.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the indexes are 16-bit.  If not, they are
+//           32-bit.
+//  Side Effect: N/A
+//
+	bool isIndexes16Bit () const
+	{	return getVertexCount() <= MAX_16_BIT_VERTEX_COUNT;	}
+
+//
+//  getIndexes16
+//
+//  Purpose: To retrieve the 16-bit indexes for this
+//           IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isIndexes16Bit()
+//  Returns: A pointer to an array of getIndexCount() indexes.
+//           If this IndexedMesh contains no indexes, NULL may
+//           be returned.
+//  Side Effect: N/A
+//
+	const unsigned short* getIndexes16 () const;
+
+//
+//  getIndexes32
+//
+//  Purpose: To retrieve the 32-bit indexes for this
+//           IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isIndexes16Bit()
+//  Returns: A pointer to an array of getIndexCount() indexes.
+//  Side Effect: N/A
+//
+	const unsigned int* getIndexes32 () const;
+
+//
+//  getGroupCount
+//
+//  Purpose: To determine how many material groups are in this
+//           IndexedMesh.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of groups.
+//  Side Effect: N/A
+//
+	unsigned int getGroupCount () const
+	{	return mvp_group_materials.size();	}
+
+//
+//  getGroupMaterial
+//
+//  Purpose: To retrieve the material for the specified group in
+//           this IndexedMesh.
+//  Parameter(s):
+//    <1> group: Which group
+//  Precondition(s):
+//    <1> group < getGroupCount()
+//  Returns: A pointer to the material for group group.  If the
+//           group has no material, NULL is returned.
+//  Side Effect: N/A
+//
+	const Material* getGroupMaterial (unsigned int group) const;
+
+//
+//  getGroupFirstIndex
+//
+//  Purpose: To determine where the indexes for the specified
+//           group in this IndexedMesh start.
+//  Parameter(s):
+//    <1> group: Which group
+//  Precondition(s):
+//    <1> group < getGroupCount()
+//  Returns: The position of the first index for group group.
+//  Side Effect: N/A
+//
+	unsigned int getGroupFirstIndex (unsigned int group) const;
+
+//
+//  getGroupIndexCount
+//
+//  Purpose: To determine how many indexes are in the specified
+//           group in this IndexedMesh.
+//  Parameter(s):
+//    <1> group: Which group
+//  Precondition(s):
+//    <1> group < getGroupCount()
+//  Returns: The number of indexes in group group.
+//  Side Effect: N/A
+//
+	unsigned int getGroupIndexCount (unsigned int group) const;
+
+//
+//  calculateAcmr
+//
+//  Purpose: To determine the average cache miss ratio (ACMR)
+//           for drawing this IndexedMesh.
+//  Parameter(s):
+//    <1> cache_size: The number of vertexes in the cache
+//  Precondition(s):
+//    <1> cache_size >= 3
+//  Returns: The average number of vertexes that must be
+//           transformed for each triangle, if the transformed
+//           vertexes are kept in a first-in-first-out cache
+//           of size cache_size.  This ranges from 3.0 (no
+//           reuse) down to about 0.5 for a large regular grid.
+//           If this IndexedMesh is empty, 0.0 is returned.
+//  Side Effect: N/A
+//
+	double calculateAcmr (unsigned int cache_size) const;
+
+#if !defined(OBJ_LIBRARY_HEADLESS) && !defined(OBJ_LIBRARY_SHADER_DISPLAY)
+//
+//  draw
+//
+//  Purpose: To display this IndexedMesh with the materials for
+//           its groups.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: This IndexedMesh is displayed.  Each group is
+//               drawn with a single glDrawElements call for
+//               each time its material is activated.
+//
+	void draw () const;
+
+//
+//  drawMaterialNone
+//
+//  Purpose: To display this IndexedMesh without materials.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All groups in this IndexedMesh are displayed
+//               with a single glDrawElements call using the
+//               current OpenGL state.
+//
+	void drawMaterialNone () const;
+
+//
+//  drawGroupMaterialNone
+//
+//  Purpose: To display the specified group in this IndexedMesh
+//           without its material.
+//  Parameter(s):
+//    <1> group: Which group
+//  Precondition(s):
+//    <1> group < getGroupCount()
+//  Returns: N/A
+//  Side Effect: Group group in this IndexedMesh is displayed
+//               with a single glDrawElements call using the
+//               current OpenGL state.
+//
+	void drawGroupMaterialNone (unsigned int group) const;
+
+//
+//  getDisplayList
+//
+//  Purpose: To generate a DisplayList for this IndexedMesh with
+//           its materials.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !Material::isMaterialActive()
+//  Returns: A DisplayList that draws this IndexedMesh.  The
+//           vertex data is copied into the DisplayList, so this
+//           IndexedMesh can be destroyed afterwards.
+//  Side Effect: N/A
+//
+	DisplayList getDisplayList () const;
+
+//
+//  getDisplayListMaterialNone
+//
+//  Purpose: To generate a DisplayList for this IndexedMesh
+//           without materials.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A DisplayList that draws this IndexedMesh using
+//           the current OpenGL state.  The vertex data is
+//           copied into the DisplayList.
+//  Side Effect: N/A
+//
+	DisplayList getDisplayListMaterialNone () const;
+
+//
+//  getDisplayListGroupMaterialNone
+//
+//  Purpose: To generate a DisplayList for the specified group
+//           in this IndexedMesh without its material.
+//  Parameter(s):
+//    <1> group: Which group
+//  Precondition(s):
+//    <1> group < getGroupCount()
+//  Returns: A DisplayList that draws group group using the
+//           current OpenGL state.  The vertex data is copied
+//           into the DisplayList.
+//  Side Effect: N/A
+//
+	DisplayList getDisplayListGroupMaterialNone (
+	                                  unsigned int group) const;
+#endif  // not headless and OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+//
+//  optimizeVertexCache
+//
+//  Purpose: To reorder the triangles in this IndexedMesh so
+//           that they make better use of the vertex cache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The triangles in each group of this IndexedMesh
+//               are reordered using Tom Forsyth's linear-speed
+//               vertex cache optimisation, modelling a cache of
+//               VERTEX_CACHE_SIZE vertexes.  The triangles stay
+//               in the same group and keep their winding.
+//
+	void optimizeVertexCache ();
+
+//
+//  optimizeVertexFetch
+//
+//  Purpose: To reorder the vertexes in this IndexedMesh into
+//           the order they are first used.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The vertexes in this IndexedMesh are renumbered
+//               in the order they are first used by the
+//               triangles, so that the vertex data is read in
+//               order when drawing.  Vertexes not used by any
+//               triangle are removed.  The triangles are not
+//               changed.
+//
+	void optimizeVertexFetch ();
+
+private:
+//
+//  init
+//
+//  Purpose: To fill in this IndexedMesh from the specified
+//           meshes of the specified ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> first_mesh: The first mesh to include
+//    <3> end_mesh: The mesh after the last one to include
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> first_mesh <= end_mesh
+//    <3> end_mesh <= model.getMeshCount()
+//    <4> isEmpty()
+//  Returns: N/A
+//  Side Effect: The faces in meshes first_mesh to end_mesh of
+//               model are added to this IndexedMesh.
+//
+	void init (const ObjModel& model,
+	           unsigned int first_mesh,
+	           unsigned int end_mesh);
+
+//
+//  getIndexes
+//
+//  Purpose: To retrieve a copy of the indexes in this
+//           IndexedMesh as 32-bit numbers.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The indexes, whichever size they are stored as.
+//  Side Effect: N/A
+//
+	std::vector<unsigned int> getIndexes () const;
+
+//
+//  setIndexes
+//
+//  Purpose: To replace the indexes in this IndexedMesh.
+//  Parameter(s):
+//    <1> v_indexes: The new indexes
+//  Precondition(s):
+//    <1> v_indexes.size() % 3 == 0
+//    <2> Every element of v_indexes < getVertexCount()
+//  Returns: N/A
+//  Side Effect: The indexes in this IndexedMesh are set to
+//               v_indexes, stored as 16-bit numbers if
+//               isIndexes16Bit() and as 32-bit numbers
+//               otherwise.  The groups are not changed.
+//
+	void setIndexes (const std::vector<unsigned int>& v_indexes);
+
+#if !defined(OBJ_LIBRARY_HEADLESS) && !defined(OBJ_LIBRARY_SHADER_DISPLAY)
+//
+//  drawIndexes
+//
+//  Purpose: To display a range of indexes in this IndexedMesh.
+//  Parameter(s):
+//    <1> first_index: The position of the first index
+//    <2> index_count: The number of indexes
+//  Precondition(s):
+//    <1> first_index + index_count <= getIndexCount()
+//  Returns: N/A
+//  Side Effect: The triangles for the specified indexes are
+//               displayed with the current OpenGL state.  The
+//               OpenGL vertex array state is left unchanged.
+//
+	void drawIndexes (unsigned int first_index,
+	                  unsigned int index_count) const;
+#endif  // not headless and OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	bool m_is_texture_coordinates;
+	bool m_is_normals;
+	std::vector<float> mv_vertex_data;
+	std::vector<unsigned short> mv_indexes_16;
+	std::vector<unsigned int>   mv_indexes_32;
+
+	// by group
+	std::vector<const Material*> mvp_group_materials;
+	std::vector<unsigned int> mv_group_first_indexes;
+	std::vector<unsigned int> mv_group_index_counts;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
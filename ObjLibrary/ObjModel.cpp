@@ -1528,6 +1528,20 @@ DisplayList ObjModel :: getDisplayListMaterialNone () const
 	return list;
 }
 
+DisplayList ObjModel :: getDisplayListMeshMaterialNone (unsigned int mesh) const
+{
+	assert(isValid());
+	assert(mesh < getMeshCount());
+
+	DisplayList list;
+
+	list.begin();
+		drawMesh(mesh);
+	list.end();
+
+	return list;
+}
+
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 
@@ -2021,10 +2035,10 @@ void ObjModel :: setVertexCount (unsigned int count)
 	if(count < getVertexCount())
 	{
 		m_valid = false;
-		mv_vertexes.resize(count);
+		mv_vertexes.edit().resize(count);
 	}
 	else if(count > getVertexCount())
-		mv_vertexes.resize(count, Vector3::ZERO);
+		mv_vertexes.edit().resize(count, Vector3::ZERO);
 
 	assert(invariant());
 }
@@ -2033,7 +2047,7 @@ void ObjModel :: setVertexX (unsigned int vertex, double x)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].x = x;
+	mv_vertexes.edit()[vertex].x = x;
 
 	assert(invariant());
 }
@@ -2042,7 +2056,7 @@ void ObjModel :: setVertexY (unsigned int vertex, double y)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].y = y;
+	mv_vertexes.edit()[vertex].y = y;
 
 	assert(invariant());
 }
@@ -2051,7 +2065,7 @@ void ObjModel :: setVertexZ (unsigned int vertex, double z)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].z = z;
+	mv_vertexes.edit()[vertex].z = z;
 
 	assert(invariant());
 }
@@ -2060,7 +2074,7 @@ void ObjModel :: setVertexPosition (unsigned int vertex, double x, double y, dou
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].set(x, y, z);
+	mv_vertexes.edit()[vertex].set(x, y, z);
 
 	assert(invariant());
 }
@@ -2069,7 +2083,7 @@ void ObjModel :: setVertexPosition (unsigned int vertex, const Vector3& position
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex] = position;
+	mv_vertexes.edit()[vertex] = position;
 
 	assert(invariant());
 }
@@ -2079,10 +2093,10 @@ void ObjModel :: setTextureCoordinateCount (unsigned int count)
 	if(count < getTextureCoordinateCount())
 	{
 		m_valid = false;
-		mv_texture_coordinates.resize(count);
+		mv_texture_coordinates.edit().resize(count);
 	}
 	else if(count > getTextureCoordinateCount())
-		mv_texture_coordinates.resize(count, Vector2::ZERO);
+		mv_texture_coordinates.edit().resize(count, Vector2::ZERO);
 
 	assert(invariant());
 }
@@ -2091,7 +2105,7 @@ void ObjModel :: setTextureCoordinateU (unsigned int texture_coordinate, double
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
+	mv_texture_coordinates.edit()[texture_coordinate].x = u;
 
 	assert(invariant());
 }
@@ -2099,7 +2113,7 @@ void ObjModel :: setTextureCoordinateV (unsigned int texture_coordinate, double
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].y = v;
+	mv_texture_coordinates.edit()[texture_coordinate].y = v;
 
 	assert(invariant());
 }
@@ -2108,8 +2122,8 @@ void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, double u
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
-	mv_texture_coordinates[texture_coordinate].y = v;
+	mv_texture_coordinates.edit()[texture_coordinate].x = u;
+	mv_texture_coordinates.edit()[texture_coordinate].y = v;
 
 	assert(invariant());
 }
@@ -2118,7 +2132,7 @@ void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, const Ve
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate] = coordinates;
+	mv_texture_coordinates.edit()[texture_coordinate] = coordinates;
 
 	assert(invariant());
 }
@@ -2128,10 +2142,10 @@ void ObjModel :: setNormalCount (unsigned int count)
 	if(count < getNormalCount())
 	{
 		m_valid = false;
-		mv_normals.resize(count);
+		mv_normals.edit().resize(count);
 	}
 	else if(count > getNormalCount())
-		mv_normals.resize(count, Vector3::UNIT_Z_PLUS);
+		mv_normals.edit().resize(count, Vector3::UNIT_Z_PLUS);
 
 	assert(invariant());
 }
@@ -2141,9 +2155,9 @@ void ObjModel :: setNormalX (unsigned int normal, double x)
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || getNormalY(normal) != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].x = x;
+	mv_normals.edit()[normal].x = x;
 	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	mv_normals.edit()[normal].normalize();
 
 	assert(invariant());
 }
@@ -2153,9 +2167,9 @@ void ObjModel :: setNormalY (unsigned int normal, double y)
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || y != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].y = y;
+	mv_normals.edit()[normal].y = y;
 	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	mv_normals.edit()[normal].normalize();
 
 	assert(invariant());
 }
@@ -2165,9 +2179,9 @@ void ObjModel :: setNormalZ (unsigned int normal, double z)
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || getNormalY(normal) != 0.0 || z != 0.0);
 
-	mv_normals[normal].z = z;
+	mv_normals.edit()[normal].z = z;
 	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	mv_normals.edit()[normal].normalize();
 
 	assert(invariant());
 }
@@ -2177,9 +2191,9 @@ void ObjModel :: setNormalVector (unsigned int normal, double x, double y, doubl
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || y != 0.0 || z != 0.0);
 
-	mv_normals[normal].set(x, y, z);
+	mv_normals.edit()[normal].set(x, y, z);
 	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	mv_normals.edit()[normal].normalize();
 
 	assert(invariant());
 }
@@ -2189,7 +2203,7 @@ void ObjModel :: setNormalVector (unsigned int normal, const Vector3& vector)
 	assert(normal < getNormalCount());
 	assert(!vector.isZero());
 
-	mv_normals[normal] = vector.getNormalized();
+	mv_normals.edit()[normal] = vector.getNormalized();
 
 	assert(invariant());
 }
@@ -2202,9 +2216,9 @@ void ObjModel :: setMeshMaterial (unsigned int mesh, const string& material)
 	if(DEBUGGING_LOAD)
 		cout << "    Setting mesh " << mesh << " to use material " << material << endl;
 
-	mv_meshes[mesh].m_material_name = material;
+	mv_meshes.edit()[mesh].m_material_name = material;
 
-	mv_meshes[mesh].mp_material = NULL;
+	mv_meshes.edit()[mesh].mp_material = NULL;
 	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
 	{
 		if(mv_material_libraries[i].mp_mtl_library == NULL)
@@ -2215,7 +2229,7 @@ void ObjModel :: setMeshMaterial (unsigned int mesh, const string& material)
 		if(index == MtlLibrary::NO_SUCH_MATERIAL)
 			continue;
 
-		mv_meshes[mesh].mp_material = mv_material_libraries[i].mp_mtl_library->getMaterial(index);
+		mv_meshes.edit()[mesh].mp_material = mv_material_libraries[i].mp_mtl_library->getMaterial(index);
 	}
 
 	assert(invariant());
@@ -2225,8 +2239,8 @@ void ObjModel :: setMeshMaterialNone (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].m_material_name = "";
-	mv_meshes[mesh].mp_material = NULL;
+	mv_meshes.edit()[mesh].m_material_name = "";
+	mv_meshes.edit()[mesh].mp_material = NULL;
 
 	assert(invariant());
 }
@@ -2237,7 +2251,7 @@ void ObjModel :: setPointSetVertexIndex (unsigned int mesh, unsigned int point_s
 	assert(point_set < getPointSetCount(mesh));
 	assert(vertex < getPointSetVertexCount(mesh, point_set));
 
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes[vertex] = index;
+	mv_meshes.edit()[mesh].mv_point_sets[point_set].mv_vertexes[vertex] = index;
 	if(index >= getVertexCount())
 		m_valid = false;
 
@@ -2250,7 +2264,7 @@ void ObjModel :: setPolylineVertexIndex (unsigned int mesh, unsigned int polylin
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex = index;
+	mv_meshes.edit()[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex = index;
 	if(index >= getVertexCount())
 		m_valid = false;
 
@@ -2263,7 +2277,7 @@ void ObjModel :: setPolylineVertexTextureCoordinates (unsigned int mesh, unsigne
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate = index;
+	mv_meshes.edit()[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate = index;
 	if(index >= getTextureCoordinateCount() && index != NO_TEXTURE_COORDINATES)
 		m_valid = false;
 
@@ -2276,7 +2290,7 @@ void ObjModel :: setFaceVertexIndex (unsigned int mesh, unsigned int face, unsig
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex = index;
+	mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex = index;
 	if(index >= getVertexCount())
 		m_valid = false;
 
@@ -2289,7 +2303,7 @@ void ObjModel :: setFaceVertexTextureCoordinates (unsigned int mesh, unsigned in
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate = index;
+	mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate = index;
 	if(index >= getTextureCoordinateCount() && index != NO_TEXTURE_COORDINATES)
 		m_valid = false;
 
@@ -2302,7 +2316,7 @@ void ObjModel :: setFaceVertexNormal (unsigned int mesh, unsigned int face, unsi
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal = index;
+	mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes[vertex].m_normal = index;
 	if(index >= getVertexCount() && index != NO_NORMAL)
 		m_valid = false;
 
@@ -2337,7 +2351,7 @@ void ObjModel :: addMaterialLibrary (const string& library, ostream& r_logstream
 	assert(ObjStringParsing::isValidFilenameWithPath(library));
 
 #ifdef OBJ_LIBRARY_PATH_PROPAGATION
-	mv_material_libraries.push_back(MaterialLibrary(m_file_path, library, r_logstream));
+	mv_material_libraries.edit().push_back(MaterialLibrary(m_file_path, library, r_logstream));
 #else
 	mv_material_libraries.push_back(MaterialLibrary("", library, r_logstream));
 #endif
@@ -2361,7 +2375,7 @@ unsigned int ObjModel :: addVertex (double x, double y, double z)
 unsigned int ObjModel :: addVertex (const Vector3& position)
 {
 	unsigned int id = mv_vertexes.size();
-	mv_vertexes.push_back(position);
+	mv_vertexes.edit().push_back(position);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Vertex #" << (id + 1) << " " << position << endl;
@@ -2378,7 +2392,7 @@ unsigned int ObjModel :: addTextureCoordinate (double u, double v)
 unsigned int ObjModel :: addTextureCoordinate (const Vector2& texture_coordinates)
 {
 	unsigned int id = mv_texture_coordinates.size();
-	mv_texture_coordinates.push_back(texture_coordinates);
+	mv_texture_coordinates.edit().push_back(texture_coordinates);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Texture Coordinate #" << (id + 1) << " " << texture_coordinates << endl;
@@ -2399,7 +2413,7 @@ unsigned int ObjModel :: addNormal (const Vector3& normal)
 	assert(!normal.isZero());
 
 	unsigned int id = mv_normals.size();
-	mv_normals.push_back(normal.getNormalized());
+	mv_normals.edit().push_back(normal.getNormalized());
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Normal #" << (id + 1) << " " << normal << endl;
@@ -2411,7 +2425,7 @@ unsigned int ObjModel :: addNormal (const Vector3& normal)
 unsigned int ObjModel :: addMesh ()
 {
 	unsigned int id = mv_meshes.size();
-	mv_meshes.push_back(Mesh());
+	mv_meshes.edit().push_back(Mesh());
 
 	if(DEBUGGING_EDITING)
 		cout << "Added mesh #" << (id + 1) << endl;
@@ -2425,7 +2439,7 @@ unsigned int ObjModel :: addPointSet (unsigned int mesh)
 	assert(mesh < getMeshCount());
 
 	unsigned int id = mv_meshes[mesh].mv_point_sets.size();
-	mv_meshes[mesh].mv_point_sets.push_back(PointSet());
+	mv_meshes.edit()[mesh].mv_point_sets.push_back(PointSet());
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2441,7 +2455,7 @@ unsigned int ObjModel :: addPointSetVertex (unsigned int mesh, unsigned int poin
 	assert(point_set < getPointSetCount(mesh));
 
 	unsigned int id = mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.size();
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.push_back(vertex);
+	mv_meshes.edit()[mesh].mv_point_sets[point_set].mv_vertexes.push_back(vertex);
 
 	if(vertex >= getVertexCount())
 		m_valid = false;
@@ -2458,7 +2472,7 @@ unsigned int ObjModel :: addPolyline (unsigned int mesh)
 	assert(mesh < getMeshCount());
 
 	unsigned int id = mv_meshes[mesh].mv_polylines.size();
-	mv_meshes[mesh].mv_polylines.push_back(Polyline());
+	mv_meshes.edit()[mesh].mv_polylines.push_back(Polyline());
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2474,7 +2488,7 @@ unsigned int ObjModel :: addPolylineVertex (unsigned int mesh, unsigned int poly
 	assert(polyline < getPolylineCount(mesh));
 
 	unsigned int id = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.size();
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.push_back(PolylineVertex(vertex, texture_coordinates));
+	mv_meshes.edit()[mesh].mv_polylines[polyline].mv_vertexes.push_back(PolylineVertex(vertex, texture_coordinates));
 
 	if(vertex >= getVertexCount())
 		m_valid = false;
@@ -2500,7 +2514,7 @@ unsigned int ObjModel :: addFace (unsigned int mesh)
 	assert(mesh < getMeshCount());
 
 	unsigned int id = mv_meshes[mesh].mv_faces.size();
-	mv_meshes[mesh].mv_faces.push_back(Face());
+	mv_meshes.edit()[mesh].mv_faces.push_back(Face());
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2516,7 +2530,7 @@ unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, un
 	assert(face < getFaceCount(mesh));
 
 	unsigned int id = mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.push_back(FaceVertex(vertex, texture_coordinates, normal));
+	mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes.push_back(FaceVertex(vertex, texture_coordinates, normal));
 
 	if(vertex >= getVertexCount())
 		m_valid = false;
@@ -2525,7 +2539,7 @@ unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, un
 	if(normal != NO_NORMAL && normal >= getNormalCount())
 		m_valid = false;
 	if(id > 3)
-		mv_meshes[mesh].m_all_triangles = false;
+		mv_meshes.edit()[mesh].m_all_triangles = false;
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2548,7 +2562,7 @@ unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, un
 
 void ObjModel :: removeMaterialLibaryAll ()
 {
-	mv_material_libraries.clear();
+	mv_material_libraries.edit().clear();
 
 	unsigned int mesh_count = mv_meshes.size();
 	for(unsigned int m = 0; m < mesh_count; m++)
@@ -2568,10 +2582,10 @@ void ObjModel :: removeMesh (unsigned int mesh)
 	for(unsigned int i = mesh + 1; i < mesh_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[i - 1] = mv_meshes[i];
+		mv_meshes.edit()[i - 1] = mv_meshes[i];
 	}
 
-	mv_meshes.pop_back();
+	mv_meshes.edit().pop_back();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << endl;
@@ -2581,7 +2595,7 @@ void ObjModel :: removeMesh (unsigned int mesh)
 
 void ObjModel :: removeMeshAll ()
 {
-	mv_meshes.clear();
+	mv_meshes.edit().clear();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed all meshes" << endl;
@@ -2599,9 +2613,9 @@ void ObjModel :: removePointSet (unsigned int mesh,
 	for(unsigned int i = point_set + 1; i < point_set_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[mesh].mv_point_sets[i - 1] = mv_meshes[mesh].mv_point_sets[i];
+		mv_meshes.edit()[mesh].mv_point_sets[i - 1] = mv_meshes[mesh].mv_point_sets[i];
 	}
-	mv_meshes[mesh].mv_point_sets.pop_back();
+	mv_meshes.edit()[mesh].mv_point_sets.pop_back();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2616,7 +2630,7 @@ void ObjModel :: removePointSetAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_point_sets.clear();
+	mv_meshes.edit()[mesh].mv_point_sets.clear();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all point sets" << endl;
@@ -2632,7 +2646,7 @@ void ObjModel :: removePointSetVertex (unsigned int mesh,
 	assert(point_set < getPointSetCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, point_set));
 
-	vector<unsigned int>& rv_vertexes = mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes;
+	vector<unsigned int>& rv_vertexes = mv_meshes.edit()[mesh].mv_point_sets[point_set].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2657,7 +2671,7 @@ void ObjModel :: removePointSetVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.clear();
+	mv_meshes.edit()[mesh].mv_point_sets[point_set].mv_vertexes.clear();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2678,9 +2692,9 @@ void ObjModel :: removePolyline (unsigned int mesh,
 	for(unsigned int i = polyline + 1; i < polyline_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[mesh].mv_polylines[i - 1] = mv_meshes[mesh].mv_polylines[i];
+		mv_meshes.edit()[mesh].mv_polylines[i - 1] = mv_meshes[mesh].mv_polylines[i];
 	}
-	mv_meshes[mesh].mv_polylines.pop_back();
+	mv_meshes.edit()[mesh].mv_polylines.pop_back();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2695,7 +2709,7 @@ void ObjModel :: removePolylineAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_polylines.clear();
+	mv_meshes.edit()[mesh].mv_polylines.clear();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all polylines" << endl;
@@ -2711,7 +2725,7 @@ void ObjModel :: removePolylineVertex (unsigned int mesh,
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	vector<PolylineVertex>& rv_vertexes = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
+	vector<PolylineVertex>& rv_vertexes = mv_meshes.edit()[mesh].mv_polylines[polyline].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2736,7 +2750,7 @@ void ObjModel :: removePolylineVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.clear();
+	mv_meshes.edit()[mesh].mv_polylines[polyline].mv_vertexes.clear();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2753,7 +2767,7 @@ void ObjModel :: removeFace (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	vector<Face>& rv_faces = mv_meshes[mesh].mv_faces;
+	vector<Face>& rv_faces = mv_meshes.edit()[mesh].mv_faces;
 	unsigned int face_count = rv_faces.size();
 	for(unsigned int i = face + 1; i < face_count; i++)
 	{
@@ -2775,8 +2789,8 @@ void ObjModel :: removeFaceAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_faces.clear();
-	mv_meshes[mesh].m_all_triangles = true;
+	mv_meshes.edit()[mesh].mv_faces.clear();
+	mv_meshes.edit()[mesh].m_all_triangles = true;
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all faces" << endl;
@@ -2792,7 +2806,7 @@ void ObjModel :: removeFaceVertex (unsigned int mesh,
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	vector<FaceVertex>& rv_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
+	vector<FaceVertex>& rv_vertexes = mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2818,7 +2832,7 @@ void ObjModel :: removeFaceVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.clear();
+	mv_meshes.edit()[mesh].mv_faces[face].mv_vertexes.clear();
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2937,7 +2951,7 @@ void ObjModel :: validate ()
 			}
 		}
 
-		mv_meshes[m].m_all_triangles = true;
+		bool all_triangles = true;
 		for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
 		{
 			unsigned int face_vertex_count = mv_meshes[m].mv_faces[f].mv_vertexes.size();
@@ -2950,7 +2964,7 @@ void ObjModel :: validate ()
 				return;
 			}
 			else if(face_vertex_count > 3)
-				mv_meshes[m].m_all_triangles = false;
+				all_triangles = false;
 
 			for(unsigned int v = 0; v < face_vertex_count; v++)
 			{
@@ -2992,6 +3006,10 @@ void ObjModel :: validate ()
 				}
 			}
 		}
+
+		// don't stop sharing the meshes if nothing changed
+		if(mv_meshes[m].m_all_triangles != all_triangles)
+			mv_meshes.edit()[m].m_all_triangles = all_triangles;
 	}
 
 	assert(invariant());
@@ -4298,7 +4316,7 @@ void ObjModel :: removeLastPointSet (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getPointSetCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_point_sets.pop_back();
+	mv_meshes.edit()[mesh].mv_point_sets.pop_back();
 	m_valid = false;
 }
 
@@ -4307,7 +4325,7 @@ void ObjModel :: removeLastPolyline (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getPolylineCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_polylines.pop_back();
+	mv_meshes.edit()[mesh].mv_polylines.pop_back();
 	m_valid = false;
 }
 
@@ -4316,7 +4334,7 @@ void ObjModel :: removeLastFace (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getFaceCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_faces.pop_back();
+	mv_meshes.edit()[mesh].mv_faces.pop_back();
 	m_valid = false;
 }
 
@@ -25,6 +25,8 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <atomic>
 
 #include "ObjSettings.h"
 #include "MtlLibrary.h"
@@ -82,6 +84,13 @@ class Material;
 //    output.  Function arguments and return values, however,
 //    the numbering starts at 0.
 //
+//  Copying an ObjModel is cheap.  The vertexes, texture
+//    coordinates, normals, meshes, and material libraries are
+//    each stored in a reference-counted array that is shared
+//    between copies.  An array is only copied when a model
+//    sharing it is changed, so a copy that only has its vertexes
+//    moved shares everything else with the original.
+//
 //  Class Invariant:
 //    <1> ObjStringParsing::isValidFilename(m_file_name)
 //    <2> ObjStringParsing::isValidPath(m_file_path)
@@ -191,7 +200,8 @@ public:
 //  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: A new ObjModel is created representing the same
-//               model as original.
+//               model as original.  The data is shared with
+//               original until one of them is changed.
 //
 	ObjModel (const ObjModel& original);
 
@@ -204,8 +214,9 @@ public:
 //    <1> original: The ObjModel to copy
 //  Precondition(s): N/A
 //  Returns: A reference to this ObjModel.
-//  Side Effect: This ObjModel is transformed into a deep copy
-//               of original.
+//  Side Effect: This ObjModel is transformed into a copy of
+//               original.  The data is shared with original
+//               until one of them is changed.
 //
 	ObjModel& operator= (const ObjModel& original);
 
@@ -1872,6 +1883,27 @@ public:
 //  Side Effect: N/A
 //
 	DisplayList getDisplayListMaterialNone () const;
+
+//
+//  getDisplayListMeshMaterialNone
+//
+//  Purpose: To generate a DisplayList for the specified mesh in
+//           this ObjModel without using its material.  The
+//           point sets, polylines, and faces in the mesh are
+//           drawn to the display list, but no materials are
+//           activated.  This can be used to draw many meshes
+//           with the same material while activating it only
+//           once.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//  Precondition(s):
+//    <1> isValid()
+//    <2> mesh < getMeshCount()
+//  Returns: A DisplayList for mesh mesh without any materials.
+//  Side Effect: N/A
+//
+	DisplayList getDisplayListMeshMaterialNone (
+	                                   unsigned int mesh) const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3673,6 +3705,75 @@ private:
 //
 	bool invariant () const;
 
+private:
+	//
+	//  SharedVector
+	//
+	//  A class template to represent a std::vector that is
+	//    shared between copies until one of them is changed.
+	//    Copying a SharedVector only increments a reference
+	//    count.  The contents can be read freely, but must be
+	//    accessed with edit() to be changed, which first copies
+	//    them if they are shared.
+	//
+	//  Different SharedVectors that share contents can be used
+	//    on different threads, but a single SharedVector cannot
+	//    be used on more than one thread at a time.
+	//
+	template <typename T>
+	class SharedVector
+	{
+	public:
+		typedef typename std::vector<T>::size_type size_type;
+		typedef typename std::vector<T>::const_iterator const_iterator;
+
+	public:
+		SharedVector ()
+				: mp_vector(std::make_shared<std::vector<T> >())
+		{ }
+
+		size_type size () const
+		{	return mp_vector->size();	}
+		bool empty () const
+		{	return mp_vector->empty();	}
+		const T& operator[] (size_type index) const
+		{	return (*mp_vector)[index];	}
+		const T& back () const
+		{	return mp_vector->back();	}
+		const_iterator begin () const
+		{	return mp_vector->begin();	}
+		const_iterator end () const
+		{	return mp_vector->end();	}
+
+		bool isShared () const
+		{	return mp_vector.use_count() > 1;	}
+
+		void clear ()
+		{
+			if(isShared())
+				mp_vector = std::make_shared<std::vector<T> >();
+			else
+				edit().clear();
+		}
+
+		std::vector<T>& edit ()
+		{
+			if(isShared())
+				mp_vector = std::make_shared<std::vector<T> >(*mp_vector);
+			else
+			{
+				// the count was decremented after the last read on
+				//   another thread, so make sure the reads happened
+				//   before we write
+				std::atomic_thread_fence(std::memory_order_acquire);
+			}
+			return *mp_vector;
+		}
+
+	private:
+		std::shared_ptr<std::vector<T> > mp_vector;
+	};
+
 private:
 	//
 	//  MaterialLibrary
@@ -3825,11 +3926,11 @@ private:
 	};
 
 private:
-	std::vector<MaterialLibrary> mv_material_libraries;
-	std::vector<Vector3> mv_vertexes;
-	std::vector<Vector2> mv_texture_coordinates;
-	std::vector<Vector3> mv_normals;
-	std::vector<Mesh> mv_meshes;
+	SharedVector<MaterialLibrary> mv_material_libraries;
+	SharedVector<Vector3> mv_vertexes;
+	SharedVector<Vector2> mv_texture_coordinates;
+	SharedVector<Vector3> mv_normals;
+	SharedVector<Mesh> mv_meshes;
 
 	std::string m_file_name;
 	std::string m_file_path;
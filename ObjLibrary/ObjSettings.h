@@ -211,5 +211,31 @@
 
 
 
+//
+//  Some programs need to run without a display at all, such as
+//    a simulation running on a build machine.  In this case,
+//    the program must not depend on OpenGL, GLU, or GLUT.  The
+//    DisplayList class can still be used as a reference-counted
+//    handle, but no OpenGL display list is ever created and
+//    drawing does nothing.
+//
+//  Only the DisplayList, Vector2, Vector3, and ObjStringParsing
+//    modules can be used in this mode.  The other modules
+//    require OpenGL and should not be compiled.
+//
+//  To build without OpenGL, define the macro
+//    OBJ_LIBRARY_HEADLESS.  This is normally done by the build
+//    system for specific targets rather than here.
+//
+//#define OBJ_LIBRARY_HEADLESS
+
+#ifdef OBJ_LIBRARY_HEADLESS
+	#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+		#error "OBJ_LIBRARY_HEADLESS cannot be combined with OBJ_LIBRARY_SHADER_DISPLAY"
+	#endif
+#endif
+
+
+
 
 #endif
@@ -0,0 +1,110 @@
+//
+//  OctahedralMap.cpp
+//
+
+#include "OctahedralMap.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>  // for min/max
+#include <vector>
+#include <functional>
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+OctahedralMap :: OctahedralMap ()
+		: m_resolution(0)
+		, mv_values()
+{
+	assert(invariant());
+}
+
+OctahedralMap :: OctahedralMap (unsigned int resolution,
+                                const Function& function)
+		: m_resolution(resolution)
+		, mv_values()
+{
+	if(resolution > 0)
+	{
+		unsigned int row_length = resolution + 1;
+		mv_values.resize(row_length * row_length);
+		vector<Vector3> v_directions(row_length);
+		for(unsigned int r = 0; r <= resolution; r++)
+		{
+			for(unsigned int c = 0; c <= resolution; c++)
+				v_directions[c] = getCornerDirection(c, r);
+			function(row_length, v_directions.data(), mv_values.data() + r * row_length);
+		}
+	}
+
+	assert(invariant());
+}
+
+
+
+double OctahedralMap :: getValue (const ObjLibrary::Vector3& direction) const
+{
+	assert(!isEmpty());
+	assert(!direction.isZero());
+
+	// project onto the octahedron |x| + |y| + |z| = 1
+	double sum = fabs(direction.x) + fabs(direction.y) + fabs(direction.z);
+	double u = direction.x / sum;
+	double v = direction.y / sum;
+	if(direction.z < 0.0)
+	{
+		// fold the lower half over the corners
+		double folded_u = (1.0 - fabs(v)) * ((u >= 0.0) ? 1.0 : -1.0);
+		double folded_v = (1.0 - fabs(u)) * ((v >= 0.0) ? 1.0 : -1.0);
+		u = folded_u;
+		v = folded_v;
+	}
+
+	// from [-1, 1] to [0, m_resolution]
+	double half_resolution = m_resolution * 0.5;
+	double grid_x = min(max((u + 1.0) * half_resolution, 0.0), (double)(m_resolution));
+	double grid_y = min(max((v + 1.0) * half_resolution, 0.0), (double)(m_resolution));
+	unsigned int column = min((unsigned int)(grid_x), m_resolution - 1);
+	unsigned int row    = min((unsigned int)(grid_y), m_resolution - 1);
+	double fraction_x = grid_x - column;
+	double fraction_y = grid_y - row;
+
+	unsigned int row_length = m_resolution + 1;
+	const float* p_corners = mv_values.data() + row * row_length + column;
+	double bottom = p_corners[0]          + (p_corners[1]              - p_corners[0])          * fraction_x;
+	double top    = p_corners[row_length] + (p_corners[row_length + 1] - p_corners[row_length]) * fraction_x;
+	return bottom + (top - bottom) * fraction_y;
+}
+
+
+
+Vector3 OctahedralMap :: getCornerDirection (unsigned int column,
+                                             unsigned int row) const
+{
+	assert(column <= m_resolution);
+	assert(row    <= m_resolution);
+	assert(m_resolution > 0);
+
+	double u = 2.0 * column / m_resolution - 1.0;
+	double v = 2.0 * row    / m_resolution - 1.0;
+	double z = 1.0 - fabs(u) - fabs(v);
+	if(z >= 0.0)
+		return Vector3(u, v, z).getNormalized();
+
+	// unfold the lower half, as in getValue
+	double x = (1.0 - fabs(v)) * ((u >= 0.0) ? 1.0 : -1.0);
+	double y = (1.0 - fabs(u)) * ((v >= 0.0) ? 1.0 : -1.0);
+	return Vector3(x, y, z).getNormalized();
+}
+
+bool OctahedralMap :: invariant () const
+{
+	if(m_resolution != 0 && mv_values.size() != (m_resolution + 1) * (m_resolution + 1)) return false;
+	if(m_resolution == 0 && !mv_values.empty()) return false;
+	return true;
+}
@@ -0,0 +1,181 @@
+//
+//  OctahedralMap.h
+//
+//  A module to store a precalculated value for every direction.
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  OctahedralMap
+//
+//  A class to store a table of values for directions, so that
+//    an expensive function of direction only has to be
+//    calculated once.  The directions are mapped to a square by
+//    projecting them onto an octahedron and unfolding it, with
+//    the lower half folded over the corners.  The function is
+//    calculated at the corners of a grid of cells covering the
+//    square, and values for other directions are interpolated
+//    bilinearly from the nearest 4 corners.
+//
+//  The corners on the edges of the square are shared between
+//    the two halves, so the interpolated values are continuous
+//    everywhere and no wrapping is needed.  An interpolated
+//    value is always between the smallest and largest values
+//    calculated.
+//
+//  An OctahedralMap with a resolution of 0 is empty and stores
+//    no values.
+//
+//  Class Invariant:
+//    <1> m_resolution == 0 || mv_values.size() == (m_resolution + 1)^2
+//    <2> m_resolution != 0 || mv_values.empty()
+//
+class OctahedralMap
+{
+public:
+//
+//  Function
+//
+//  The type of the function stored in an OctahedralMap.  It is
+//    passed a number of unit vectors and an array to store the
+//    value for each direction in, so that the values can be
+//    calculated together.
+//
+	typedef std::function<void (unsigned int count,
+	                            const ObjLibrary::Vector3 a_directions[],
+	                            float a_values[])> Function;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty OctahedralMap.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new OctahedralMap is created with a
+//               resolution of 0.
+//
+	OctahedralMap ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an OctahedralMap for the specified
+//           function.
+//  Parameter(s):
+//    <1> resolution: The number of cells along each side of
+//                    the map
+//    <2> function: The function to store
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new OctahedralMap is created.  function is
+//               called once for each row of (resolution + 1)
+//               corners to fill it.  If resolution is 0, the
+//               OctahedralMap is empty and function is not
+//               called.
+//
+	OctahedralMap (unsigned int resolution,
+	               const Function& function);
+
+	OctahedralMap (const OctahedralMap& to_copy) = default;
+	~OctahedralMap () = default;
+	OctahedralMap& operator= (const OctahedralMap& to_copy) = default;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine whether this OctahedralMap stores any
+//           values.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the resolution is 0.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{  return m_resolution == 0;  }
+
+//
+//  getResolution
+//
+//  Purpose: To determine how finely this OctahedralMap divides
+//           the directions.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of cells along each side of the map.
+//  Side Effect: N/A
+//
+	unsigned int getResolution () const
+	{  return m_resolution;  }
+
+//
+//  getMemorySize
+//
+//  Purpose: To determine how much memory the values in this
+//           OctahedralMap use.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The size of the stored values in bytes.
+//  Side Effect: N/A
+//
+	unsigned int getMemorySize () const
+	{  return mv_values.size() * sizeof(float);  }
+
+//
+//  getValue
+//
+//  Purpose: To determine the value for the specified
+//           direction.
+//  Parameter(s):
+//    <1> direction: The direction
+//  Preconditions:
+//    <1> !isEmpty()
+//    <2> !direction.isZero()
+//  Returns: The value for direction direction, interpolated
+//           from the values stored around it.  The norm of
+//           direction does not matter.
+//  Side Effect: N/A
+//
+	double getValue (const ObjLibrary::Vector3& direction) const;
+
+private:
+//
+//  getCornerDirection
+//
+//  Purpose: To determine the direction for the specified grid
+//           corner.
+//  Parameter(s):
+//    <1> column
+//    <2> row: The corner
+//  Preconditions:
+//    <1> column <= m_resolution
+//    <2> row <= m_resolution
+//  Returns: The unit vector mapped to the corner.
+//  Side Effect: N/A
+//
+	ObjLibrary::Vector3 getCornerDirection (unsigned int column,
+	                                        unsigned int row) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_resolution;
+	std::vector<float> mv_values;  // row-major, (m_resolution + 1) per row
+};
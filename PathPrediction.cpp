@@ -0,0 +1,173 @@
+//
+//  PathPrediction.cpp
+//
+
+#include "PathPrediction.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>  // for upper_bound
+
+#include "ObjLibrary/Vector3.h"
+
+#include "GravityKernels.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	// the time step is the square root of the distance divided by this
+	const double STEP_DISTANCE_FACTOR = 25.0;
+
+	// if the body is farther than this from where it should be, start again
+	const double DRIFT_TOLERANCE = 1.0;
+
+}  // end of anonymous namespace
+
+
+
+PathPrediction :: PathPrediction ()
+		: mv_samples()
+		, m_sample_count_max(0)
+		, m_time(0.0)
+{
+	assert(invariant());
+}
+
+PathPrediction :: PathPrediction (unsigned int sample_count)
+		: mv_samples()
+		, m_sample_count_max(sample_count)
+		, m_time(0.0)
+{
+	mv_samples.reserve(sample_count);
+
+	assert(invariant());
+}
+
+
+
+double PathPrediction :: getSampleTime (unsigned int sample) const
+{
+	assert(sample < getSampleCount());
+
+	return mv_samples[sample].m_time - m_time;
+}
+
+const ObjLibrary::Vector3& PathPrediction :: getSamplePosition (
+                                          unsigned int sample) const
+{
+	assert(sample < getSampleCount());
+
+	return mv_samples[sample].m_position;
+}
+
+double PathPrediction :: getDuration () const
+{
+	assert(isReady());
+
+	return mv_samples.back().m_time - m_time;
+}
+
+ObjLibrary::Vector3 PathPrediction :: getPosition (double time) const
+{
+	assert(isReady());
+	assert(time >= getSampleTime(0));
+
+	double sample_time = m_time + time;
+
+	const Sample& last = mv_samples.back();
+	if(sample_time >= last.m_time)
+		return last.m_position + last.m_velocity * (sample_time - last.m_time);
+
+	// find the first sample after the time
+	vector<Sample>::const_iterator after =
+		upper_bound(mv_samples.begin(), mv_samples.end(), sample_time,
+		            [] (double time, const Sample& sample)
+		            {  return time < sample.m_time;  });
+	assert(after != mv_samples.begin());
+	assert(after != mv_samples.end());
+	vector<Sample>::const_iterator before = after - 1;
+
+	double fraction = (sample_time - before->m_time) / (after->m_time - before->m_time);
+	return before->m_position + (after->m_position - before->m_position) * fraction;
+}
+
+
+
+void PathPrediction :: invalidate ()
+{
+	mv_samples.clear();
+
+	assert(invariant());
+}
+
+void PathPrediction :: update (double delta_time,
+                               const ObjLibrary::Vector3& position,
+                               const ObjLibrary::Vector3& velocity,
+                               const ObjLibrary::Vector3& black_hole_position,
+                               double black_hole_mass)
+{
+	assert(delta_time >= 0.0);
+	assert(black_hole_mass > 0.0);
+
+	m_time += delta_time;
+
+	if(isReady())
+	{
+		// remove past samples, except the last one to interpolate from
+		unsigned int past_count = 0;
+		while(past_count + 1 < mv_samples.size() && mv_samples[past_count + 1].m_time <= m_time)
+			past_count++;
+		mv_samples.erase(mv_samples.begin(), mv_samples.begin() + past_count);
+
+		if(!getPosition(0.0).isDistanceLessThan(position, DRIFT_TOLERANCE))
+			mv_samples.clear();
+	}
+
+	if(!isReady())
+	{
+		if(m_sample_count_max == 0)
+			return;
+
+		m_time = 0.0;
+		Sample current = { m_time, position, velocity };
+		mv_samples.push_back(current);
+	}
+
+	extend(black_hole_position, black_hole_mass);
+
+	assert(invariant());
+}
+
+
+
+void PathPrediction :: extend (const ObjLibrary::Vector3& black_hole_position,
+                               double black_hole_mass)
+{
+	assert(isReady());
+	assert(black_hole_mass > 0.0);
+
+	while(mv_samples.size() < m_sample_count_max)
+	{
+		// same as updating a copy of the body
+		Sample next = mv_samples.back();
+		double distance   = black_hole_position.getDistance(next.m_position);
+		double delta_time = sqrt(distance) / STEP_DISTANCE_FACTOR;
+		GravityKernels::advance(GravityKernels::SCALAR, 1, delta_time,
+		                        black_hole_position, black_hole_mass,
+		                        &(next.m_position), &(next.m_velocity));
+		next.m_time += delta_time;
+		mv_samples.push_back(next);
+	}
+}
+
+bool PathPrediction :: invariant () const
+{
+	if(mv_samples.size() > m_sample_count_max) return false;
+	for(unsigned int i = 1; i < mv_samples.size(); i++)
+		if(mv_samples[i - 1].m_time >= mv_samples[i].m_time)
+			return false;
+	if(!mv_samples.empty() && mv_samples[0].m_time > m_time) return false;
+	return true;
+}
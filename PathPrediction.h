@@ -0,0 +1,250 @@
+//
+//  PathPrediction.h
+//
+//  A module to predict where a body will go if it is only
+//    affected by the gravity of the black hole.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  PathPrediction
+//
+//  A class to store the predicted path of a body, such as a
+//    spaceship, as a series of samples.  The path is
+//    calculated with numerical integration, using longer time
+//    steps farther from the black hole.
+//
+//  The path only has to be updated when it is used, such as
+//    when it is drawn, and one update can cover several time
+//    steps.  If the body has only moved as predicted, the
+//    samples that are now in the past are removed and new
+//    samples are added at the end, so only a few new samples
+//    have to be calculated.  The whole path is only calculated
+//    again if the PathPrediction has been marked invalid (e.g.
+//    because the body has accelerated) or the body is no longer
+//    where it was predicted to be.
+//
+//  Class Invariant:
+//    <1> mv_samples.size() <= m_sample_count_max
+//    <2> mv_samples[i].m_time < mv_samples[i + 1].m_time
+//    <3> mv_samples.empty() || mv_samples[0].m_time <= m_time
+//
+class PathPrediction
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a PathPrediction that does not predict
+//           anything.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new PathPrediction with a maximum of 0
+//               samples is created.
+//
+	PathPrediction ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a PathPrediction with the specified
+//           number of samples.
+//  Parameter(s):
+//    <1> sample_count: How many samples to predict, including
+//                      the current position
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new PathPrediction is created.  It will
+//               calculate the path on the first update.
+//
+	PathPrediction (unsigned int sample_count);
+
+	PathPrediction (const PathPrediction& to_copy) = default;
+	~PathPrediction () = default;
+	PathPrediction& operator= (const PathPrediction& to_copy) = default;
+
+//
+//  isReady
+//
+//  Purpose: To determine whether this PathPrediction has
+//           predicted a path.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether there are any samples.
+//  Side Effect: N/A
+//
+	bool isReady () const
+	{  return !mv_samples.empty();  }
+
+//
+//  getSampleCount
+//
+//  Purpose: To determine how many samples are stored.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of samples.  The first one is at or
+//           before the current time.
+//  Side Effect: N/A
+//
+	unsigned int getSampleCount () const
+	{  return mv_samples.size();  }
+
+//
+//  getSampleTime
+//
+//  Purpose: To determine when the specified sample is for.
+//  Parameter(s):
+//    <1> sample: Which sample
+//  Preconditions:
+//    <1> sample < getSampleCount()
+//  Returns: The time of sample sample in seconds from now.
+//           This is never positive for sample 0.
+//  Side Effect: N/A
+//
+	double getSampleTime (unsigned int sample) const;
+
+//
+//  getSamplePosition
+//
+//  Purpose: To determine where the body is predicted to be at
+//           the specified sample.
+//  Parameter(s):
+//    <1> sample: Which sample
+//  Preconditions:
+//    <1> sample < getSampleCount()
+//  Returns: The predicted position for sample sample.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getSamplePosition (
+	                                  unsigned int sample) const;
+
+//
+//  getDuration
+//
+//  Purpose: To determine how far ahead the path is predicted.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isReady()
+//  Returns: The time of the last sample in seconds from now.
+//  Side Effect: N/A
+//
+	double getDuration () const;
+
+//
+//  getPosition
+//
+//  Purpose: To determine where the body is predicted to be at
+//           the specified time.
+//  Parameter(s):
+//    <1> time: The time in seconds from now
+//  Preconditions:
+//    <1> isReady()
+//    <2> time >= getSampleTime(0)
+//  Returns: The predicted position time seconds from now.
+//           Between samples, this is interpolated linearly,
+//           because the integration moves the body in a
+//           straight line during each step.  After the last
+//           sample, the body is assumed to keep moving at its
+//           last velocity.
+//  Side Effect: N/A
+//
+	ObjLibrary::Vector3 getPosition (double time) const;
+
+//
+//  invalidate
+//
+//  Purpose: To mark that the body has not moved as predicted.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The whole path will be calculated again on the
+//               next update.
+//
+	void invalidate ();
+
+//
+//  update
+//
+//  Purpose: To update the predicted path after one or more
+//           time steps.
+//  Parameter(s):
+//    <1> delta_time: The time in seconds since the last update
+//    <2> position: The current position of the body
+//    <3> velocity: The current velocity of the body
+//    <4> black_hole_position: The position of the black hole
+//    <5> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> delta_time >= 0.0
+//    <2> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: The current time is moved forward by
+//               delta_time and samples in the past are
+//               removed.  If this PathPrediction was marked
+//               invalid or position is not where the body was
+//               predicted to be, the path is calculated again
+//               starting from position and velocity.
+//               Otherwise, new samples are added to the end of
+//               the path.
+//
+	void update (double delta_time,
+	             const ObjLibrary::Vector3& position,
+	             const ObjLibrary::Vector3& velocity,
+	             const ObjLibrary::Vector3& black_hole_position,
+	             double black_hole_mass);
+
+private:
+//
+//  Sample
+//
+//  A record to store the predicted state of the body at one
+//    time.
+//
+	struct Sample
+	{
+		double m_time;
+		ObjLibrary::Vector3 m_position;
+		ObjLibrary::Vector3 m_velocity;
+	};
+
+//
+//  extend
+//
+//  Purpose: To add samples to the end of the path until it has
+//           the maximum number.
+//  Parameter(s):
+//    <1> black_hole_position: The position of the black hole
+//    <2> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> isReady()
+//    <2> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Samples are added, each one calculated from the
+//               one before.
+//
+	void extend (const ObjLibrary::Vector3& black_hole_position,
+	             double black_hole_mass);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<Sample> mv_samples;
+	unsigned int m_sample_count_max;
+	double m_time;  // same clock as samples
+};
@@ -0,0 +1,119 @@
+//
+//  PerlinNoiseCheck.cpp
+//
+//  A program to check that every supported batch kernel in
+//    PerlinNoiseField3 gives exactly the same results as
+//    calculating the Perlin noise one point at a time.  The
+//    points include negative and large coordinates and points
+//    on the lattice, and the batch sizes are not multiples of
+//    the vector widths.
+//
+//  Usage: perlin_noise_check
+//
+
+#include <cstdlib>  // for rand
+#include <cstring>  // for memcmp
+#include <iostream>
+#include <vector>
+
+#include "PerlinNoiseField3.h"
+
+using namespace std;
+
+namespace
+{
+	const float GRID_SIZE = 0.6f;  // same as Asteroid
+	const unsigned int SAMPLES_PER_RANGE = 100003;  // not a multiple of any vector width
+	const float RANGES[] = { 1.0f, 1.0e2f, 1.0e4f, 1.0e6f };
+	const unsigned int RANGE_COUNT = sizeof(RANGES) / sizeof(RANGES[0]);
+	const int LATTICE_MAX = 1000;
+
+	float randomPosition (float range)
+	{
+		return (rand() / (float)(RAND_MAX) * 2.0f - 1.0f) * range;
+	}
+
+	void addPoint (vector<float>& r_x,
+	               vector<float>& r_y,
+	               vector<float>& r_z,
+	               float x,
+	               float y,
+	               float z)
+	{
+		r_x.push_back(x);
+		r_y.push_back(y);
+		r_z.push_back(z);
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	vector<float> v_x;
+	vector<float> v_y;
+	vector<float> v_z;
+	for(unsigned int r = 0; r < RANGE_COUNT; r++)
+		for(unsigned int i = 0; i < SAMPLES_PER_RANGE; i++)
+			addPoint(v_x, v_y, v_z, randomPosition(RANGES[r]), randomPosition(RANGES[r]), randomPosition(RANGES[r]));
+
+	// on the lattice, where the fractions are 0
+	for(unsigned int i = 0; i < SAMPLES_PER_RANGE; i++)
+	{
+		float x = (rand() % (LATTICE_MAX * 2) - LATTICE_MAX) * GRID_SIZE;
+		float y = (rand() % (LATTICE_MAX * 2) - LATTICE_MAX) * GRID_SIZE;
+		float z = (rand() % (LATTICE_MAX * 2) - LATTICE_MAX) * GRID_SIZE;
+		addPoint(v_x, v_y, v_z, x, y, z);
+	}
+	addPoint(v_x, v_y, v_z,  0.0f,  0.0f,  0.0f);
+	addPoint(v_x, v_y, v_z, -0.0f, -0.0f, -0.0f);
+
+	unsigned int count = v_x.size();
+	vector<float> v_expected(count);
+	vector<float> v_noise(count);
+
+	unsigned int failure_count = 0;
+	for(unsigned int mode = 0; mode < PerlinNoiseField3::MODE_COUNT; mode++)
+	{
+		PerlinNoiseField3 noise(GRID_SIZE, 1.0f);
+		noise.setMode(mode);
+		for(unsigned int i = 0; i < count; i++)
+			v_expected[i] = noise.perlinNoise(v_x[i], v_y[i], v_z[i]);
+
+		for(unsigned int k = 0; k < PerlinNoiseField3::KERNEL_COUNT; k++)
+		{
+			if(!PerlinNoiseField3::isKernelSupported(k))
+			{
+				cout << PerlinNoiseField3::getModeName(mode) << " " << PerlinNoiseField3::getKernelName(k)
+				     << ": not supported" << endl;
+				continue;
+			}
+
+			noise.perlinNoise(k, count, v_x.data(), v_y.data(), v_z.data(), v_noise.data());
+			if(memcmp(v_noise.data(), v_expected.data(), count * sizeof(float)) == 0)
+			{
+				cout << PerlinNoiseField3::getModeName(mode) << " " << PerlinNoiseField3::getKernelName(k)
+				     << ": " << count << " points match" << endl;
+				continue;
+			}
+
+			failure_count++;
+			for(unsigned int i = 0; i < count; i++)
+			{
+				if(memcmp(&(v_noise[i]), &(v_expected[i]), sizeof(float)) != 0)
+				{
+					cerr << PerlinNoiseField3::getModeName(mode) << " " << PerlinNoiseField3::getKernelName(k)
+					     << ": point (" << v_x[i] << ", " << v_y[i] << ", " << v_z[i] << ") gives "
+					     << v_noise[i] << " instead of " << v_expected[i] << endl;
+					break;
+				}
+			}
+		}
+	}
+
+	if(failure_count > 0)
+		return 1;
+	cout << "PerlinNoiseField3 check passed" << endl;
+	return 0;
+}
@@ -8,11 +8,26 @@
 #include <cmath>
 #include <climits>
 #include <iostream>
+#include <vector>
+#include <algorithm>  // for swap
 
 #include "ObjLibrary/Vector3.h"
 
 #include "PerlinNoiseField3.h"
 
+// the SIMD kernels are only built for x86 compilers we know how to check
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+	#define PERLIN_NOISE_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define PERLIN_NOISE_TARGET(name)
+	#else
+		#define PERLIN_NOISE_TARGET(name) __attribute__((target(name)))
+	#endif
+#endif
+
 using namespace std;
 using namespace ObjLibrary;
 namespace
@@ -26,6 +41,640 @@ namespace
 	const unsigned int DEFAULT_SEED_Q0 = 1498573726;
 	const unsigned int DEFAULT_SEED_Q1 = 3476519523;
 	const unsigned int DEFAULT_SEED_Q2 = 3905844518;
+
+	const char* A_KERNEL_NAMES[PerlinNoiseField3::KERNEL_COUNT] =
+	{
+		"scalar",
+		"sse2",
+		"avx2",
+	};
+
+	const char* A_MODE_NAMES[PerlinNoiseField3::MODE_COUNT] =
+	{
+		"hash",
+		"table",
+	};
+
+	// for MODE_TABLE, TABLE_SIZE must be a power of 2 up to 256
+	const unsigned int TABLE_SIZE = 256;
+	const unsigned int TABLE_MASK = TABLE_SIZE - 1;
+
+	const float  FADE_PI = 3.14159265f;
+	const double TWO_PI  = 6.283185307179586476925286766559;  // same as Vector3
+
+	//
+	//  For calculateSinCos.  The constants are from fdlibm.
+	//    Half pi is split in two so that the high part times a
+	//    small integer is exact.
+	//
+	const double SIN_COS_ANGLE_MAX = 1.0e3;
+	const double TWO_OVER_PI     = 6.36619772367581382433e-01;
+	const double HALF_PI_HIGH    = 1.57079632673412561417e+00;  // first 33 bits
+	const double HALF_PI_LOW     = 6.07710050650619224932e-11;
+	const double SIN_1 = -1.66666666666666324348e-01;
+	const double SIN_2 =  8.33333333332248946124e-03;
+	const double SIN_3 = -1.98412698298579493134e-04;
+	const double SIN_4 =  2.75573137070700676789e-06;
+	const double SIN_5 = -2.50507602534068634195e-08;
+	const double SIN_6 =  1.58969099521155010221e-10;
+	const double COS_1 =  4.16666666666666019037e-02;
+	const double COS_2 = -1.38888888888741095749e-03;
+	const double COS_3 =  2.48015872894767294178e-05;
+	const double COS_4 = -2.75573143513906633035e-07;
+	const double COS_5 =  2.08757232129817482790e-09;
+	const double COS_6 = -1.13596475577881948265e-11;
+
+
+
+	//
+	//  calculateSinCos
+	//
+	//  Purpose: To calculate the sine and cosine of the
+	//           specified angle the same way as the batch
+	//           kernels do.
+	//  Parameter(s):
+	//    <1> angle: The angle in radians
+	//    <2> r_sin: A reference to a double to store the sine in
+	//    <3> r_cos: A reference to a double to store the cosine
+	//               in
+	//  Preconditions:
+	//    <1> angle >= 0.0
+	//    <2> angle <= SIN_COS_ANGLE_MAX
+	//  Returns: N/A
+	//  Side Effect: r_sin and r_cos are set to the sine and
+	//               cosine of angle.  These are within about 1
+	//               ulp of the true values.
+	//
+	void calculateSinCos (double angle, double& r_sin, double& r_cos)
+	{
+		assert(angle >= 0.0);
+		assert(angle <= SIN_COS_ANGLE_MAX);
+
+		// reduce to [-pi/4, pi/4] around a multiple of pi/2
+		int quadrant = (int)(angle * TWO_OVER_PI + 0.5);
+		double quadrant_double = quadrant;
+		double x = (angle - quadrant_double * HALF_PI_HIGH) - quadrant_double * HALF_PI_LOW;
+		double z = x * x;
+
+		double sin_inner = SIN_2 + z * (SIN_3 + z * (SIN_4 + z * (SIN_5 + z * SIN_6)));
+		double sin_x = x + (z * x) * (SIN_1 + z * sin_inner);
+		double cos_inner = z * (COS_1 + z * (COS_2 + z * (COS_3 + z * (COS_4 + z * (COS_5 + z * COS_6)))));
+		double half_z = 0.5 * z;
+		double w = 1.0 - half_z;
+		double cos_x = w + (((1.0 - w) - half_z) + z * cos_inner);
+
+		if((quadrant & 1) != 0)
+			swap(sin_x, cos_x);
+		r_sin = ((quadrant       & 2) != 0) ? -sin_x : sin_x;
+		r_cos = (((quadrant + 1) & 2) != 0) ? -cos_x : cos_x;
+	}
+
+	//
+	//  gradientDot
+	//
+	//  Purpose: To calculate the dot product of a gradient from
+	//           the table and a direction.
+	//  Parameter(s):
+	//    <1> a_gradient: The gradient, as 3 floats
+	//    <2> x
+	//    <3> y
+	//    <4> z: The direction
+	//  Preconditions:
+	//    <1> a_gradient != nullptr
+	//  Returns: The dot product.
+	//  Side Effect: N/A
+	//
+	float gradientDot (const float a_gradient[], float x, float y, float z)
+	{
+		assert(a_gradient != nullptr);
+
+		return a_gradient[0] * x + a_gradient[1] * y + a_gradient[2] * z;
+	}
+
+#ifdef PERLIN_NOISE_X86
+	//
+	//  The SIMD kernels calculate the noise for several points
+	//    at once, with one lane per point.  Every operation
+	//    matches one in perlinNoise (including fade, lattice,
+	//    pseudorandom, and calculateSinCos), in the same order,
+	//    so that the results are identical.  The gradients and
+	//    dot products are calculated in double precision, as in
+	//    perlinNoise, so each register of floats is split into
+	//    two registers of doubles for them.
+	//
+	//  The integer hashes wrap around, as unsigned int
+	//    arithmetic does, so they do not depend on the order of
+	//    the operations.  Unsigned ints are converted to float as
+	//    the sum of their upper and lower 16 bits, which are both
+	//    exact, so there is only one rounding, the same as the
+	//    scalar conversion.
+	//
+	struct Seeds
+	{
+		unsigned int m_x1;
+		unsigned int m_x2;
+		unsigned int m_y1;
+		unsigned int m_y2;
+		unsigned int m_z1;
+		unsigned int m_z2;
+		unsigned int m_q0;
+		unsigned int m_q1;
+		unsigned int m_q2;
+	};
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128i multiplySse2 (__m128i a, __m128i b)
+	{
+		// low 32 bits of each product, like _mm_mullo_epi32 (SSE4.1)
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+		                          _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128i pseudorandomSse2 (const Seeds& seeds, __m128i x, __m128i y, __m128i z)
+	{
+		__m128i n = _mm_add_epi32(_mm_add_epi32(multiplySse2(_mm_set1_epi32(seeds.m_x1), x),
+		                                        multiplySse2(_mm_set1_epi32(seeds.m_y1), y)),
+		                                        multiplySse2(_mm_set1_epi32(seeds.m_z1), z));
+		__m128i quad_term = _mm_add_epi32(_mm_add_epi32(
+		        multiplySse2(multiplySse2(_mm_set1_epi32(seeds.m_q2), n), n),
+		        multiplySse2(_mm_set1_epi32(seeds.m_q1), n)),
+		        _mm_set1_epi32(seeds.m_q0));
+		return _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(quad_term,
+		                     multiplySse2(_mm_set1_epi32(seeds.m_x2), x)),
+		                     multiplySse2(_mm_set1_epi32(seeds.m_y2), y)),
+		                     multiplySse2(_mm_set1_epi32(seeds.m_z2), z));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128 unsignedIntTo01Sse2 (__m128i n)
+	{
+		__m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(n, 16));
+		__m128 low  = _mm_cvtepi32_ps(_mm_and_si128(n, _mm_set1_epi32(0xFFFF)));
+		__m128 as_float = _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+		return _mm_div_ps(as_float, _mm_set1_ps((float)(UINT_MAX)));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	void sinCosSse2 (__m128d angle, __m128d& r_sin, __m128d& r_cos)
+	{
+		const __m128d SIGN_BIT = _mm_set1_pd(-0.0);
+
+		__m128i quadrant = _mm_cvttpd_epi32(_mm_add_pd(_mm_mul_pd(angle, _mm_set1_pd(TWO_OVER_PI)),
+		                                               _mm_set1_pd(0.5)));
+		__m128d quadrant_double = _mm_cvtepi32_pd(quadrant);
+		__m128d x = _mm_sub_pd(_mm_sub_pd(angle, _mm_mul_pd(quadrant_double, _mm_set1_pd(HALF_PI_HIGH))),
+		                       _mm_mul_pd(quadrant_double, _mm_set1_pd(HALF_PI_LOW)));
+		__m128d z = _mm_mul_pd(x, x);
+
+		__m128d sin_inner = _mm_add_pd(_mm_set1_pd(SIN_5), _mm_mul_pd(z, _mm_set1_pd(SIN_6)));
+		sin_inner = _mm_add_pd(_mm_set1_pd(SIN_4), _mm_mul_pd(z, sin_inner));
+		sin_inner = _mm_add_pd(_mm_set1_pd(SIN_3), _mm_mul_pd(z, sin_inner));
+		sin_inner = _mm_add_pd(_mm_set1_pd(SIN_2), _mm_mul_pd(z, sin_inner));
+		__m128d sin_x = _mm_add_pd(x, _mm_mul_pd(_mm_mul_pd(z, x),
+		                                         _mm_add_pd(_mm_set1_pd(SIN_1), _mm_mul_pd(z, sin_inner))));
+
+		__m128d cos_inner = _mm_add_pd(_mm_set1_pd(COS_5), _mm_mul_pd(z, _mm_set1_pd(COS_6)));
+		cos_inner = _mm_add_pd(_mm_set1_pd(COS_4), _mm_mul_pd(z, cos_inner));
+		cos_inner = _mm_add_pd(_mm_set1_pd(COS_3), _mm_mul_pd(z, cos_inner));
+		cos_inner = _mm_add_pd(_mm_set1_pd(COS_2), _mm_mul_pd(z, cos_inner));
+		cos_inner = _mm_add_pd(_mm_set1_pd(COS_1), _mm_mul_pd(z, cos_inner));
+		cos_inner = _mm_mul_pd(z, cos_inner);
+		__m128d half_z = _mm_mul_pd(_mm_set1_pd(0.5), z);
+		__m128d w = _mm_sub_pd(_mm_set1_pd(1.0), half_z);
+		__m128d cos_x = _mm_add_pd(w, _mm_add_pd(_mm_sub_pd(_mm_sub_pd(_mm_set1_pd(1.0), w), half_z),
+		                                         _mm_mul_pd(z, cos_inner)));
+
+		// one 64-bit mask per lane from the quadrant bits
+		__m128i quadrant64 = _mm_shuffle_epi32(quadrant, _MM_SHUFFLE(1, 1, 0, 0));
+		__m128i one = _mm_set1_epi32(1);
+		__m128i two = _mm_set1_epi32(2);
+		__m128d is_swap     = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(quadrant64, one), one));
+		__m128d is_sin_negative = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(quadrant64, two), two));
+		__m128d is_cos_negative = _mm_castsi128_pd(_mm_cmpeq_epi32(
+		                                   _mm_and_si128(_mm_add_epi32(quadrant64, one), two), two));
+
+		__m128d sin_swapped = _mm_or_pd(_mm_and_pd(is_swap, cos_x), _mm_andnot_pd(is_swap, sin_x));
+		__m128d cos_swapped = _mm_or_pd(_mm_and_pd(is_swap, sin_x), _mm_andnot_pd(is_swap, cos_x));
+		r_sin = _mm_xor_pd(sin_swapped, _mm_and_pd(is_sin_negative, SIGN_BIT));
+		r_cos = _mm_xor_pd(cos_swapped, _mm_and_pd(is_cos_negative, SIGN_BIT));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128 fadeSse2 (__m128 n)
+	{
+		__m128 angle = _mm_mul_ps(n, _mm_set1_ps(FADE_PI));
+		__m128d sin_low;
+		__m128d cos_low;
+		__m128d sin_high;
+		__m128d cos_high;
+		sinCosSse2(_mm_cvtps_pd(angle),                    sin_low,  cos_low);
+		sinCosSse2(_mm_cvtps_pd(_mm_movehl_ps(angle, angle)), sin_high, cos_high);
+		__m128 cos_n = _mm_movelh_ps(_mm_cvtpd_ps(cos_low), _mm_cvtpd_ps(cos_high));
+		return _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), cos_n), _mm_set1_ps(0.5f));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128d latticeDotSse2 (__m128 seed1, __m128 seed2,
+	                        __m128d direction_x, __m128d direction_y, __m128d direction_z)
+	{
+		__m128d xy_angle  = _mm_mul_pd(_mm_cvtps_pd(seed1), _mm_set1_pd(TWO_PI));
+		__m128d z         = _mm_sub_pd(_mm_mul_pd(_mm_cvtps_pd(seed2), _mm_set1_pd(2.0)), _mm_set1_pd(1.0));
+		__m128d radius_xy = _mm_sqrt_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(z, z)));
+		__m128d sin_angle;
+		__m128d cos_angle;
+		sinCosSse2(xy_angle, sin_angle, cos_angle);
+		__m128d x = _mm_mul_pd(radius_xy, cos_angle);
+		__m128d y = _mm_mul_pd(radius_xy, sin_angle);
+		return _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, direction_x),
+		                             _mm_mul_pd(y, direction_y)),
+		                             _mm_mul_pd(z, direction_z));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128 cornerSse2 (const Seeds& seeds,
+	                   __m128i x, __m128i y, __m128i z,
+	                   __m128 direction_x, __m128 direction_y, __m128 direction_z)
+	{
+		const __m128i ONE = _mm_set1_epi32(1);
+
+		__m128 seed1 = unsignedIntTo01Sse2(pseudorandomSse2(seeds, x, y, z));
+		__m128 seed2 = unsignedIntTo01Sse2(pseudorandomSse2(seeds, _mm_add_epi32(x, ONE),
+		                                                           _mm_add_epi32(y, ONE),
+		                                                           _mm_add_epi32(z, ONE)));
+
+		__m128d low = latticeDotSse2(seed1, seed2,
+		                             _mm_cvtps_pd(direction_x),
+		                             _mm_cvtps_pd(direction_y),
+		                             _mm_cvtps_pd(direction_z));
+		__m128d high = latticeDotSse2(_mm_movehl_ps(seed1, seed1), _mm_movehl_ps(seed2, seed2),
+		                              _mm_cvtps_pd(_mm_movehl_ps(direction_x, direction_x)),
+		                              _mm_cvtps_pd(_mm_movehl_ps(direction_y, direction_y)),
+		                              _mm_cvtps_pd(_mm_movehl_ps(direction_z, direction_z)));
+		return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	__m128 interpolateSse2 (__m128 v0, __m128 v1, __m128 fraction)
+	{
+		return _mm_add_ps(_mm_mul_ps(v0, _mm_sub_ps(_mm_set1_ps(1.0f), fraction)),
+		                  _mm_mul_ps(v1, fraction));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	void floorSse2 (__m128 value, __m128i& r_floor, __m128& r_fraction)
+	{
+		// truncate, then subtract 1 if that rounded up
+		__m128i truncated = _mm_cvttps_epi32(value);
+		__m128i is_above = _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), value));
+		r_floor = _mm_add_epi32(truncated, is_above);
+		r_fraction = _mm_sub_ps(value, _mm_cvtepi32_ps(r_floor));
+	}
+
+	PERLIN_NOISE_TARGET("sse2")
+	unsigned int perlinNoiseSse2 (const Seeds& seeds,
+	                              float grid_size,
+	                              float amplitude,
+	                              unsigned int count,
+	                              const float a_x[],
+	                              const float a_y[],
+	                              const float a_z[],
+	                              float a_noise[])
+	{
+		const __m128i ONE       = _mm_set1_epi32(1);
+		const __m128  ONE_FLOAT = _mm_set1_ps(1.0f);
+		const __m128  SIGN_BIT  = _mm_set1_ps(-0.0f);
+		const __m128  GRID_SIZE = _mm_set1_ps(grid_size);
+
+		unsigned int p = 0;
+		for( ; p + 4 <= count; p += 4)
+		{
+			__m128i x0;
+			__m128i y0;
+			__m128i z0;
+			__m128 x_frac;
+			__m128 y_frac;
+			__m128 z_frac;
+			floorSse2(_mm_div_ps(_mm_loadu_ps(a_x + p), GRID_SIZE), x0, x_frac);
+			floorSse2(_mm_div_ps(_mm_loadu_ps(a_y + p), GRID_SIZE), y0, y_frac);
+			floorSse2(_mm_div_ps(_mm_loadu_ps(a_z + p), GRID_SIZE), z0, z_frac);
+			__m128i x1 = _mm_add_epi32(x0, ONE);
+			__m128i y1 = _mm_add_epi32(y0, ONE);
+			__m128i z1 = _mm_add_epi32(z0, ONE);
+
+			__m128 x_fade = fadeSse2(x_frac);
+			__m128 y_fade = fadeSse2(y_frac);
+			__m128 z_fade = fadeSse2(z_frac);
+
+			__m128 x_to_0 = _mm_xor_ps(x_frac, SIGN_BIT);
+			__m128 y_to_0 = _mm_xor_ps(y_frac, SIGN_BIT);
+			__m128 z_to_0 = _mm_xor_ps(z_frac, SIGN_BIT);
+			__m128 x_to_1 = _mm_sub_ps(ONE_FLOAT, x_frac);
+			__m128 y_to_1 = _mm_sub_ps(ONE_FLOAT, y_frac);
+			__m128 z_to_1 = _mm_sub_ps(ONE_FLOAT, z_frac);
+
+			__m128 value000 = cornerSse2(seeds, x0, y0, z0, x_to_0, y_to_0, z_to_0);
+			__m128 value001 = cornerSse2(seeds, x0, y0, z1, x_to_0, y_to_0, z_to_1);
+			__m128 value010 = cornerSse2(seeds, x0, y1, z0, x_to_0, y_to_1, z_to_0);
+			__m128 value011 = cornerSse2(seeds, x0, y1, z1, x_to_0, y_to_1, z_to_1);
+			__m128 value100 = cornerSse2(seeds, x1, y0, z0, x_to_1, y_to_0, z_to_0);
+			__m128 value101 = cornerSse2(seeds, x1, y0, z1, x_to_1, y_to_0, z_to_1);
+			__m128 value110 = cornerSse2(seeds, x1, y1, z0, x_to_1, y_to_1, z_to_0);
+			__m128 value111 = cornerSse2(seeds, x1, y1, z1, x_to_1, y_to_1, z_to_1);
+
+			__m128 value00 = interpolateSse2(value000, value001, z_fade);
+			__m128 value01 = interpolateSse2(value010, value011, z_fade);
+			__m128 value10 = interpolateSse2(value100, value101, z_fade);
+			__m128 value11 = interpolateSse2(value110, value111, z_fade);
+			__m128 value0  = interpolateSse2(value00,  value01,  y_fade);
+			__m128 value1  = interpolateSse2(value10,  value11,  y_fade);
+			__m128 value   = interpolateSse2(value0,   value1,   x_fade);
+
+			_mm_storeu_ps(a_noise + p, _mm_mul_ps(value, _mm_set1_ps(amplitude)));
+		}
+		return p;
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256i pseudorandomAvx2 (const Seeds& seeds, __m256i x, __m256i y, __m256i z)
+	{
+		__m256i n = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_x1), x),
+		                                              _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_y1), y)),
+		                                              _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_z1), z));
+		__m256i quad_term = _mm256_add_epi32(_mm256_add_epi32(
+		        _mm256_mullo_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_q2), n), n),
+		        _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_q1), n)),
+		        _mm256_set1_epi32(seeds.m_q0));
+		return _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(quad_term,
+		                        _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_x2), x)),
+		                        _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_y2), y)),
+		                        _mm256_mullo_epi32(_mm256_set1_epi32(seeds.m_z2), z));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256 unsignedIntTo01Avx2 (__m256i n)
+	{
+		__m256 high = _mm256_cvtepi32_ps(_mm256_srli_epi32(n, 16));
+		__m256 low  = _mm256_cvtepi32_ps(_mm256_and_si256(n, _mm256_set1_epi32(0xFFFF)));
+		__m256 as_float = _mm256_add_ps(_mm256_mul_ps(high, _mm256_set1_ps(65536.0f)), low);
+		return _mm256_div_ps(as_float, _mm256_set1_ps((float)(UINT_MAX)));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	void sinCosAvx2 (__m256d angle, __m256d& r_sin, __m256d& r_cos)
+	{
+		const __m256d SIGN_BIT = _mm256_set1_pd(-0.0);
+
+		__m128i quadrant = _mm256_cvttpd_epi32(_mm256_add_pd(_mm256_mul_pd(angle, _mm256_set1_pd(TWO_OVER_PI)),
+		                                                     _mm256_set1_pd(0.5)));
+		__m256d quadrant_double = _mm256_cvtepi32_pd(quadrant);
+		__m256d x = _mm256_sub_pd(_mm256_sub_pd(angle, _mm256_mul_pd(quadrant_double, _mm256_set1_pd(HALF_PI_HIGH))),
+		                          _mm256_mul_pd(quadrant_double, _mm256_set1_pd(HALF_PI_LOW)));
+		__m256d z = _mm256_mul_pd(x, x);
+
+		__m256d sin_inner = _mm256_add_pd(_mm256_set1_pd(SIN_5), _mm256_mul_pd(z, _mm256_set1_pd(SIN_6)));
+		sin_inner = _mm256_add_pd(_mm256_set1_pd(SIN_4), _mm256_mul_pd(z, sin_inner));
+		sin_inner = _mm256_add_pd(_mm256_set1_pd(SIN_3), _mm256_mul_pd(z, sin_inner));
+		sin_inner = _mm256_add_pd(_mm256_set1_pd(SIN_2), _mm256_mul_pd(z, sin_inner));
+		__m256d sin_x = _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(z, x),
+		                                               _mm256_add_pd(_mm256_set1_pd(SIN_1), _mm256_mul_pd(z, sin_inner))));
+
+		__m256d cos_inner = _mm256_add_pd(_mm256_set1_pd(COS_5), _mm256_mul_pd(z, _mm256_set1_pd(COS_6)));
+		cos_inner = _mm256_add_pd(_mm256_set1_pd(COS_4), _mm256_mul_pd(z, cos_inner));
+		cos_inner = _mm256_add_pd(_mm256_set1_pd(COS_3), _mm256_mul_pd(z, cos_inner));
+		cos_inner = _mm256_add_pd(_mm256_set1_pd(COS_2), _mm256_mul_pd(z, cos_inner));
+		cos_inner = _mm256_add_pd(_mm256_set1_pd(COS_1), _mm256_mul_pd(z, cos_inner));
+		cos_inner = _mm256_mul_pd(z, cos_inner);
+		__m256d half_z = _mm256_mul_pd(_mm256_set1_pd(0.5), z);
+		__m256d w = _mm256_sub_pd(_mm256_set1_pd(1.0), half_z);
+		__m256d cos_x = _mm256_add_pd(w, _mm256_add_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), w), half_z),
+		                                               _mm256_mul_pd(z, cos_inner)));
+
+		// one 64-bit mask per lane from the quadrant bits
+		__m256i quadrant64 = _mm256_cvtepi32_epi64(quadrant);
+		__m256i one = _mm256_set1_epi64x(1);
+		__m256i two = _mm256_set1_epi64x(2);
+		__m256d is_swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant64, one), one));
+		__m256d is_sin_negative = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant64, two), two));
+		__m256d is_cos_negative = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+		                                   _mm256_and_si256(_mm256_add_epi64(quadrant64, one), two), two));
+
+		__m256d sin_swapped = _mm256_blendv_pd(sin_x, cos_x, is_swap);
+		__m256d cos_swapped = _mm256_blendv_pd(cos_x, sin_x, is_swap);
+		r_sin = _mm256_xor_pd(sin_swapped, _mm256_and_pd(is_sin_negative, SIGN_BIT));
+		r_cos = _mm256_xor_pd(cos_swapped, _mm256_and_pd(is_cos_negative, SIGN_BIT));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256 fadeAvx2 (__m256 n)
+	{
+		__m256 angle = _mm256_mul_ps(n, _mm256_set1_ps(FADE_PI));
+		__m256d sin_low;
+		__m256d cos_low;
+		__m256d sin_high;
+		__m256d cos_high;
+		sinCosAvx2(_mm256_cvtps_pd(_mm256_castps256_ps128(angle)),   sin_low,  cos_low);
+		sinCosAvx2(_mm256_cvtps_pd(_mm256_extractf128_ps(angle, 1)), sin_high, cos_high);
+		__m256 cos_n = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(cos_low)),
+		                                    _mm256_cvtpd_ps(cos_high), 1);
+		return _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), cos_n), _mm256_set1_ps(0.5f));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256d latticeDotAvx2 (__m128 seed1, __m128 seed2,
+	                        __m256d direction_x, __m256d direction_y, __m256d direction_z)
+	{
+		__m256d xy_angle  = _mm256_mul_pd(_mm256_cvtps_pd(seed1), _mm256_set1_pd(TWO_PI));
+		__m256d z         = _mm256_sub_pd(_mm256_mul_pd(_mm256_cvtps_pd(seed2), _mm256_set1_pd(2.0)),
+		                                  _mm256_set1_pd(1.0));
+		__m256d radius_xy = _mm256_sqrt_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(z, z)));
+		__m256d sin_angle;
+		__m256d cos_angle;
+		sinCosAvx2(xy_angle, sin_angle, cos_angle);
+		__m256d x = _mm256_mul_pd(radius_xy, cos_angle);
+		__m256d y = _mm256_mul_pd(radius_xy, sin_angle);
+		return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, direction_x),
+		                                   _mm256_mul_pd(y, direction_y)),
+		                                   _mm256_mul_pd(z, direction_z));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256 cornerAvx2 (const Seeds& seeds,
+	                   __m256i x, __m256i y, __m256i z,
+	                   __m256 direction_x, __m256 direction_y, __m256 direction_z)
+	{
+		const __m256i ONE = _mm256_set1_epi32(1);
+
+		__m256 seed1 = unsignedIntTo01Avx2(pseudorandomAvx2(seeds, x, y, z));
+		__m256 seed2 = unsignedIntTo01Avx2(pseudorandomAvx2(seeds, _mm256_add_epi32(x, ONE),
+		                                                           _mm256_add_epi32(y, ONE),
+		                                                           _mm256_add_epi32(z, ONE)));
+
+		__m256d low = latticeDotAvx2(_mm256_castps256_ps128(seed1), _mm256_castps256_ps128(seed2),
+		                             _mm256_cvtps_pd(_mm256_castps256_ps128(direction_x)),
+		                             _mm256_cvtps_pd(_mm256_castps256_ps128(direction_y)),
+		                             _mm256_cvtps_pd(_mm256_castps256_ps128(direction_z)));
+		__m256d high = latticeDotAvx2(_mm256_extractf128_ps(seed1, 1), _mm256_extractf128_ps(seed2, 1),
+		                              _mm256_cvtps_pd(_mm256_extractf128_ps(direction_x, 1)),
+		                              _mm256_cvtps_pd(_mm256_extractf128_ps(direction_y, 1)),
+		                              _mm256_cvtps_pd(_mm256_extractf128_ps(direction_z, 1)));
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)),
+		                            _mm256_cvtpd_ps(high), 1);
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	__m256 interpolateAvx2 (__m256 v0, __m256 v1, __m256 fraction)
+	{
+		return _mm256_add_ps(_mm256_mul_ps(v0, _mm256_sub_ps(_mm256_set1_ps(1.0f), fraction)),
+		                     _mm256_mul_ps(v1, fraction));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	void floorAvx2 (__m256 value, __m256i& r_floor, __m256& r_fraction)
+	{
+		r_floor = _mm256_cvttps_epi32(_mm256_floor_ps(value));
+		r_fraction = _mm256_sub_ps(value, _mm256_cvtepi32_ps(r_floor));
+	}
+
+	PERLIN_NOISE_TARGET("avx2")
+	unsigned int perlinNoiseAvx2 (const Seeds& seeds,
+	                              float grid_size,
+	                              float amplitude,
+	                              unsigned int count,
+	                              const float a_x[],
+	                              const float a_y[],
+	                              const float a_z[],
+	                              float a_noise[])
+	{
+		const __m256i ONE       = _mm256_set1_epi32(1);
+		const __m256  ONE_FLOAT = _mm256_set1_ps(1.0f);
+		const __m256  SIGN_BIT  = _mm256_set1_ps(-0.0f);
+		const __m256  GRID_SIZE = _mm256_set1_ps(grid_size);
+
+		unsigned int p = 0;
+		for( ; p + 8 <= count; p += 8)
+		{
+			__m256i x0;
+			__m256i y0;
+			__m256i z0;
+			__m256 x_frac;
+			__m256 y_frac;
+			__m256 z_frac;
+			floorAvx2(_mm256_div_ps(_mm256_loadu_ps(a_x + p), GRID_SIZE), x0, x_frac);
+			floorAvx2(_mm256_div_ps(_mm256_loadu_ps(a_y + p), GRID_SIZE), y0, y_frac);
+			floorAvx2(_mm256_div_ps(_mm256_loadu_ps(a_z + p), GRID_SIZE), z0, z_frac);
+			__m256i x1 = _mm256_add_epi32(x0, ONE);
+			__m256i y1 = _mm256_add_epi32(y0, ONE);
+			__m256i z1 = _mm256_add_epi32(z0, ONE);
+
+			__m256 x_fade = fadeAvx2(x_frac);
+			__m256 y_fade = fadeAvx2(y_frac);
+			__m256 z_fade = fadeAvx2(z_frac);
+
+			__m256 x_to_0 = _mm256_xor_ps(x_frac, SIGN_BIT);
+			__m256 y_to_0 = _mm256_xor_ps(y_frac, SIGN_BIT);
+			__m256 z_to_0 = _mm256_xor_ps(z_frac, SIGN_BIT);
+			__m256 x_to_1 = _mm256_sub_ps(ONE_FLOAT, x_frac);
+			__m256 y_to_1 = _mm256_sub_ps(ONE_FLOAT, y_frac);
+			__m256 z_to_1 = _mm256_sub_ps(ONE_FLOAT, z_frac);
+
+			__m256 value000 = cornerAvx2(seeds, x0, y0, z0, x_to_0, y_to_0, z_to_0);
+			__m256 value001 = cornerAvx2(seeds, x0, y0, z1, x_to_0, y_to_0, z_to_1);
+			__m256 value010 = cornerAvx2(seeds, x0, y1, z0, x_to_0, y_to_1, z_to_0);
+			__m256 value011 = cornerAvx2(seeds, x0, y1, z1, x_to_0, y_to_1, z_to_1);
+			__m256 value100 = cornerAvx2(seeds, x1, y0, z0, x_to_1, y_to_0, z_to_0);
+			__m256 value101 = cornerAvx2(seeds, x1, y0, z1, x_to_1, y_to_0, z_to_1);
+			__m256 value110 = cornerAvx2(seeds, x1, y1, z0, x_to_1, y_to_1, z_to_0);
+			__m256 value111 = cornerAvx2(seeds, x1, y1, z1, x_to_1, y_to_1, z_to_1);
+
+			__m256 value00 = interpolateAvx2(value000, value001, z_fade);
+			__m256 value01 = interpolateAvx2(value010, value011, z_fade);
+			__m256 value10 = interpolateAvx2(value100, value101, z_fade);
+			__m256 value11 = interpolateAvx2(value110, value111, z_fade);
+			__m256 value0  = interpolateAvx2(value00,  value01,  y_fade);
+			__m256 value1  = interpolateAvx2(value10,  value11,  y_fade);
+			__m256 value   = interpolateAvx2(value0,   value1,   x_fade);
+
+			_mm256_storeu_ps(a_noise + p, _mm256_mul_ps(value, _mm256_set1_ps(amplitude)));
+		}
+		return p;
+	}
+
+	bool isCpuSse2 ()
+	{
+	#if defined(_M_X64) || defined(__x86_64__)
+		return true;  // part of x86-64
+	#elif defined(_MSC_VER)
+		int a_registers[4];
+		__cpuid(a_registers, 1);
+		return (a_registers[3] & (1 << 26)) != 0;
+	#else
+		return __builtin_cpu_supports("sse2") != 0;
+	#endif
+	}
+
+	bool isCpuAvx2 ()
+	{
+	#ifdef _MSC_VER
+		// the processor and the operating system must both support it
+		int a_registers[4];
+		__cpuid(a_registers, 1);
+		bool is_osxsave = (a_registers[2] & (1 << 27)) != 0;
+		bool is_avx     = (a_registers[2] & (1 << 28)) != 0;
+		if(!is_osxsave || !is_avx || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(a_registers, 7, 0);
+		return (a_registers[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2") != 0;
+	#endif
+	}
+#endif  // PERLIN_NOISE_X86
+
+}  // end of anonymous namespace
+
+
+
+const char* PerlinNoiseField3 :: getKernelName (unsigned int kernel)
+{
+	assert(kernel < KERNEL_COUNT);
+
+	return A_KERNEL_NAMES[kernel];
+}
+
+bool PerlinNoiseField3 :: isKernelSupported (unsigned int kernel)
+{
+	assert(kernel < KERNEL_COUNT);
+
+	switch(kernel)
+	{
+	case KERNEL_SCALAR:
+		return true;
+#ifdef PERLIN_NOISE_X86
+	case KERNEL_SSE2:
+		return isCpuSse2();
+	case KERNEL_AVX2:
+		return isCpuAvx2();
+#endif
+	default:
+		return false;
+	}
+}
+
+unsigned int PerlinNoiseField3 :: getBestKernel ()
+{
+	static const unsigned int BEST = isKernelSupported(KERNEL_AVX2) ? KERNEL_AVX2 :
+	                                 isKernelSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_SCALAR;
+	return BEST;
+}
+
+const char* PerlinNoiseField3 :: getModeName (unsigned int mode)
+{
+	assert(mode < MODE_COUNT);
+
+	return A_MODE_NAMES[mode];
 }
 
 
@@ -42,6 +691,10 @@ PerlinNoiseField3 :: PerlinNoiseField3 ()
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_mode(MODE_HASH)
+		, mv_permutation()
+		, mv_gradients()
+		, mv_values()
 {
 	assert(invariant());
 }
@@ -59,6 +712,10 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_mode(MODE_HASH)
+		, mv_permutation()
+		, mv_gradients()
+		, mv_values()
 {
 	assert(grid_size > 0.0f);
 
@@ -87,6 +744,10 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(seed_q0)
 		, m_seed_q1(seed_q1)
 		, m_seed_q2(seed_q2)
+		, m_mode(MODE_HASH)
+		, mv_permutation()
+		, mv_gradients()
+		, mv_values()
 {
 	assert(grid_size > 0.0f);
 
@@ -105,8 +766,16 @@ float PerlinNoiseField3 :: getAmplitude () const
 	return m_amplitude;
 }
 
+unsigned int PerlinNoiseField3 :: getMode () const
+{
+	return m_mode;
+}
+
 float PerlinNoiseField3 :: valueNoise (float x, float y, float z) const
 {
+	if(m_mode == MODE_TABLE)
+		return valueNoiseTable(x, y, z);
+
 	int x0 = (int)(floor(x / m_grid_size));
 	int y0 = (int)(floor(y / m_grid_size));
 	int z0 = (int)(floor(z / m_grid_size));
@@ -144,6 +813,9 @@ float PerlinNoiseField3 :: valueNoise (float x, float y, float z) const
 
 float PerlinNoiseField3 :: perlinNoise (float x, float y, float z) const
 {
+	if(m_mode == MODE_TABLE)
+		return perlinNoiseTable(x, y, z);
+
 	int x0 = (int)(floor(x / m_grid_size));
 	int y0 = (int)(floor(y / m_grid_size));
 	int z0 = (int)(floor(z / m_grid_size));
@@ -197,6 +869,52 @@ float PerlinNoiseField3 :: perlinNoise (float x, float y, float z) const
 	return value * m_amplitude;
 }
 
+void PerlinNoiseField3 :: perlinNoise (unsigned int count,
+                                       const float a_x[],
+                                       const float a_y[],
+                                       const float a_z[],
+                                       float a_noise[]) const
+{
+	perlinNoise(getBestKernel(), count, a_x, a_y, a_z, a_noise);
+}
+
+void PerlinNoiseField3 :: perlinNoise (unsigned int kernel,
+                                       unsigned int count,
+                                       const float a_x[],
+                                       const float a_y[],
+                                       const float a_z[],
+                                       float a_noise[]) const
+{
+	assert(kernel < KERNEL_COUNT);
+	assert(isKernelSupported(kernel));
+	assert(a_x     != nullptr || count == 0);
+	assert(a_y     != nullptr || count == 0);
+	assert(a_z     != nullptr || count == 0);
+	assert(a_noise != nullptr || count == 0);
+
+	unsigned int done = 0;
+#ifdef PERLIN_NOISE_X86
+	Seeds seeds = { m_seed_x1, m_seed_x2, m_seed_y1, m_seed_y2, m_seed_z1, m_seed_z2,
+	                m_seed_q0, m_seed_q1, m_seed_q2 };
+	if(m_mode == MODE_HASH)
+	{
+		switch(kernel)
+		{
+		case KERNEL_SSE2:
+			done = perlinNoiseSse2(seeds, m_grid_size, m_amplitude, count, a_x, a_y, a_z, a_noise);
+			break;
+		case KERNEL_AVX2:
+			done = perlinNoiseAvx2(seeds, m_grid_size, m_amplitude, count, a_x, a_y, a_z, a_noise);
+			break;
+		}
+	}
+#endif
+
+	// the scalar kernel, MODE_TABLE, and any left over
+	for(unsigned int p = done; p < count; p++)
+		a_noise[p] = perlinNoise(a_x[p], a_y[p], a_z[p]);
+}
+
 void PerlinNoiseField3 :: printPerlin (unsigned int print_rows,
                                        unsigned int print_columns,
                                        float interval) const
@@ -269,6 +987,23 @@ void PerlinNoiseField3 :: setAmplitude (float amplitude)
 	assert(invariant());
 }
 
+void PerlinNoiseField3 :: setMode (unsigned int mode)
+{
+	assert(mode < MODE_COUNT);
+
+	m_mode = mode;
+	if(mode == MODE_TABLE)
+		buildTables();
+	else
+	{
+		mv_permutation.clear();
+		mv_gradients.clear();
+		mv_values.clear();
+	}
+
+	assert(invariant());
+}
+
 void PerlinNoiseField3 :: setSeeds (unsigned int seed_x1,
                                     unsigned int seed_x2,
                                     unsigned int seed_y1,
@@ -288,6 +1023,8 @@ void PerlinNoiseField3 :: setSeeds (unsigned int seed_x1,
 	m_seed_q0 = seed_q0;
 	m_seed_q1 = seed_q1;
 	m_seed_q2 = seed_q2;
+	if(m_mode == MODE_TABLE)
+		buildTables();
 
 	assert(invariant());
 }
@@ -323,7 +1060,11 @@ float PerlinNoiseField3 :: fade (float n) const
 	//return n;
 	//return (-2.0f * n + 3) * n * n;
 	//return ((6 * n - 15) * n + 10) * n * n * n;
-	return (1 - cos(n * 3.14159265f)) * 0.5f;
+	//return (1 - cos(n * 3.14159265f)) * 0.5f;
+	double sin_n;
+	double cos_n;
+	calculateSinCos(n * FADE_PI, sin_n, cos_n);
+	return (1.0f - (float)(cos_n)) * 0.5f;
 }
 
 unsigned int PerlinNoiseField3 :: interpolate (unsigned int v0,
@@ -346,8 +1087,133 @@ ObjLibrary::Vector3 PerlinNoiseField3 :: lattice (int x, int y, int z) const
 {
 	unsigned int value1 = pseudorandom(x, y, z);
 	unsigned int value2 = pseudorandom(x + 1, y + 1, z + 1);  //  <|>
-	return Vector3::getPseudorandomUnitVector(unsignedIntTo01(value1),
-	                                          unsignedIntTo01(value2));
+
+	// same as Vector3::getPseudorandomUnitVector, but with calculateSinCos
+	double xy_angle = unsignedIntTo01(value1) * TWO_PI;
+	double z_coord = unsignedIntTo01(value2) * 2.0 - 1.0;
+	double radius_xy = sqrt(1.0 - z_coord * z_coord);
+	double sin_angle;
+	double cos_angle;
+	calculateSinCos(xy_angle, sin_angle, cos_angle);
+	return Vector3(radius_xy * cos_angle, radius_xy * sin_angle, z_coord);
+}
+
+void PerlinNoiseField3 :: buildTables ()
+{
+	// shuffle with the hash, so the permutation depends on the seeds
+	mv_permutation.resize(TABLE_SIZE * 2);
+	for(unsigned int i = 0; i < TABLE_SIZE; i++)
+		mv_permutation[i] = (unsigned char)(i);
+	for(unsigned int i = TABLE_SIZE - 1; i > 0; i--)
+	{
+		// use the high bits, which are more random
+		unsigned int hash = pseudorandom((int)(i), 0, -1);
+		unsigned int j = (unsigned int)(((unsigned long long)(hash) * (i + 1)) >> 32);
+		assert(j <= i);
+		swap(mv_permutation[i], mv_permutation[j]);
+	}
+	for(unsigned int i = 0; i < TABLE_SIZE; i++)
+		mv_permutation[TABLE_SIZE + i] = mv_permutation[i];
+
+	mv_gradients.resize(TABLE_SIZE * 3);
+	mv_values.resize(TABLE_SIZE);
+	for(unsigned int i = 0; i < TABLE_SIZE; i++)
+	{
+		Vector3 gradient = lattice((int)(i), 0, 0);
+		mv_gradients[i * 3 + 0] = (float)(gradient.x);
+		mv_gradients[i * 3 + 1] = (float)(gradient.y);
+		mv_gradients[i * 3 + 2] = (float)(gradient.z);
+		mv_values[i] = pseudorandom((int)(i), 0, 0);
+	}
+}
+
+unsigned int PerlinNoiseField3 :: tableIndex (int x, int y, int z) const
+{
+	assert(m_mode == MODE_TABLE);
+
+	// the permutation is repeated, so the sums do not wrap
+	unsigned int index_x  = mv_permutation[x & TABLE_MASK];
+	unsigned int index_xy = mv_permutation[index_x + (y & TABLE_MASK)];
+	return mv_permutation[index_xy + (z & TABLE_MASK)];
+}
+
+float PerlinNoiseField3 :: valueNoiseTable (float x, float y, float z) const
+{
+	assert(m_mode == MODE_TABLE);
+
+	int x0 = (int)(floor(x / m_grid_size));
+	int y0 = (int)(floor(y / m_grid_size));
+	int z0 = (int)(floor(z / m_grid_size));
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float x_frac = x / m_grid_size - x0;
+	float y_frac = y / m_grid_size - y0;
+	float z_frac = z / m_grid_size - z0;
+
+	float x_fade = fade(x_frac);
+	float y_fade = fade(y_frac);
+	float z_fade = fade(z_frac);
+
+	unsigned int value000 = mv_values[tableIndex(x0, y0, z0)];
+	unsigned int value001 = mv_values[tableIndex(x0, y0, z1)];
+	unsigned int value010 = mv_values[tableIndex(x0, y1, z0)];
+	unsigned int value011 = mv_values[tableIndex(x0, y1, z1)];
+	unsigned int value100 = mv_values[tableIndex(x1, y0, z0)];
+	unsigned int value101 = mv_values[tableIndex(x1, y0, z1)];
+	unsigned int value110 = mv_values[tableIndex(x1, y1, z0)];
+	unsigned int value111 = mv_values[tableIndex(x1, y1, z1)];
+
+	unsigned int value00 = interpolate(value000, value001, z_fade);
+	unsigned int value01 = interpolate(value010, value011, z_fade);
+	unsigned int value10 = interpolate(value100, value101, z_fade);
+	unsigned int value11 = interpolate(value110, value111, z_fade);
+	unsigned int value0  = interpolate(value00,  value01,  y_fade);
+	unsigned int value1  = interpolate(value10,  value11,  y_fade);
+	unsigned int value   = interpolate(value0,   value1,   x_fade);
+
+	return unsignedIntToPM1(value) * m_amplitude;
+}
+
+float PerlinNoiseField3 :: perlinNoiseTable (float x, float y, float z) const
+{
+	assert(m_mode == MODE_TABLE);
+
+	int x0 = (int)(floor(x / m_grid_size));
+	int y0 = (int)(floor(y / m_grid_size));
+	int z0 = (int)(floor(z / m_grid_size));
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float x_frac = x / m_grid_size - x0;
+	float y_frac = y / m_grid_size - y0;
+	float z_frac = z / m_grid_size - z0;
+
+	float x_fade = fade(x_frac);
+	float y_fade = fade(y_frac);
+	float z_fade = fade(z_frac);
+
+	const float* a_gradients = mv_gradients.data();
+	float value000 = gradientDot(a_gradients + tableIndex(x0, y0, z0) * 3,      - x_frac,      - y_frac,      - z_frac);
+	float value001 = gradientDot(a_gradients + tableIndex(x0, y0, z1) * 3,      - x_frac,      - y_frac, 1.0f - z_frac);
+	float value010 = gradientDot(a_gradients + tableIndex(x0, y1, z0) * 3,      - x_frac, 1.0f - y_frac,      - z_frac);
+	float value011 = gradientDot(a_gradients + tableIndex(x0, y1, z1) * 3,      - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+	float value100 = gradientDot(a_gradients + tableIndex(x1, y0, z0) * 3, 1.0f - x_frac,      - y_frac,      - z_frac);
+	float value101 = gradientDot(a_gradients + tableIndex(x1, y0, z1) * 3, 1.0f - x_frac,      - y_frac, 1.0f - z_frac);
+	float value110 = gradientDot(a_gradients + tableIndex(x1, y1, z0) * 3, 1.0f - x_frac, 1.0f - y_frac,      - z_frac);
+	float value111 = gradientDot(a_gradients + tableIndex(x1, y1, z1) * 3, 1.0f - x_frac, 1.0f - y_frac, 1.0f - z_frac);
+
+	float value00 = interpolate(value000, value001, z_fade);
+	float value01 = interpolate(value010, value011, z_fade);
+	float value10 = interpolate(value100, value101, z_fade);
+	float value11 = interpolate(value110, value111, z_fade);
+	float value0  = interpolate(value00,  value01,  y_fade);
+	float value1  = interpolate(value10,  value11,  y_fade);
+	float value   = interpolate(value0,   value1,   x_fade);
+
+	return value * m_amplitude;
 }
 
 void PerlinNoiseField3 :: printValue (float value) const
@@ -375,5 +1241,18 @@ void PerlinNoiseField3 :: printValue (float value) const
 bool PerlinNoiseField3 :: invariant () const
 {
 	if(m_grid_size <= 0.0) return false;
+	if(m_mode >= MODE_COUNT) return false;
+	if(m_mode == MODE_TABLE)
+	{
+		if(mv_permutation.size() != TABLE_SIZE * 2) return false;
+		if(mv_gradients.size() != TABLE_SIZE * 3) return false;
+		if(mv_values.size() != TABLE_SIZE) return false;
+	}
+	else
+	{
+		if(!mv_permutation.empty()) return false;
+		if(!mv_gradients.empty()) return false;
+		if(!mv_values.empty()) return false;
+	}
 	return true;
 }
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "ObjLibrary/Vector3.h"
 
 
@@ -15,11 +17,56 @@
 //
 //  A class to calculate 3D value noise and Perlin noise.
 //
+//  Perlin noise can also be calculated for arrays of points at
+//    once.  There is a plain C++ kernel that works everywhere
+//    and kernels that use SSE2 (4 points at a time) and AVX2
+//    (8 points at a time) on x86 processors, chosen while the
+//    program is running as for GravityKernels.  All kernels
+//    perform the same IEEE floating-point operations in the
+//    same order as perlinNoise does for a single point, so they
+//    give bit-for-bit identical results.  To make this
+//    possible, the sines and cosines are calculated with
+//    polynomials in this module instead of the standard
+//    library, whose results can differ between platforms.
+//
+//  The values at the lattice points are normally calculated by
+//    hashing the lattice coordinates with the seeds
+//    (MODE_HASH).  In MODE_TABLE, a permutation table and
+//    tables of gradients and values are built from the same
+//    seeds instead, as in Ken Perlin's original noise, and the
+//    lattice coordinates are looked up in them.  This is much
+//    faster, but the noise is different and repeats every
+//    256 grid cells, so MODE_HASH is the default and must be
+//    used to reproduce existing shapes.  The batch kernels
+//    only support MODE_HASH; in MODE_TABLE, the points are
+//    calculated one at a time.
+//
 //  Class Invariant:
 //    <1> m_grid_size > 0.0
+//    <2> m_mode < MODE_COUNT
+//    <3> m_mode == MODE_TABLE || the tables are empty
+//    <4> m_mode != MODE_TABLE || the tables are full
 //
 class PerlinNoiseField3
 {
+public:
+	// identifiers for the batch kernels, KERNEL_SCALAR is always supported
+	static const unsigned int KERNEL_SCALAR = 0;
+	static const unsigned int KERNEL_SSE2   = 1;
+	static const unsigned int KERNEL_AVX2   = 2;
+	static const unsigned int KERNEL_COUNT  = 3;
+
+	static const char* getKernelName (unsigned int kernel);
+	static bool isKernelSupported (unsigned int kernel);
+	static unsigned int getBestKernel ();
+
+	// identifiers for how the lattice values are found
+	static const unsigned int MODE_HASH  = 0;
+	static const unsigned int MODE_TABLE = 1;
+	static const unsigned int MODE_COUNT = 2;
+
+	static const char* getModeName (unsigned int mode);
+
 public:
 	PerlinNoiseField3 ();
 	PerlinNoiseField3 (float grid_size,
@@ -41,15 +88,31 @@ public:
 
 	float getGridSize () const;
 	float getAmplitude () const;
+	unsigned int getMode () const;
 	float valueNoise (float x, float y, float z) const;
 	float perlinNoise (float x, float y, float z) const;
 
+	// a_noise[i] = perlinNoise(a_x[i], a_y[i], a_z[i]), using the best kernel
+	void perlinNoise (unsigned int count,
+	                  const float a_x[],
+	                  const float a_y[],
+	                  const float a_z[],
+	                  float a_noise[]) const;
+	// same, with the specified kernel, which must be supported
+	void perlinNoise (unsigned int kernel,
+	                  unsigned int count,
+	                  const float a_x[],
+	                  const float a_y[],
+	                  const float a_z[],
+	                  float a_noise[]) const;
+
 	void printPerlin (unsigned int print_rows,
 	                  unsigned int print_columns,
 	                  float interval) const;
 
 	void setGridSize (float grid_size);
 	void setAmplitude (float amplitude);
+	void setMode (unsigned int mode);
 	void setSeeds (unsigned int seed_x1,
 	               unsigned int seed_x2,
 	               unsigned int seed_y1,
@@ -73,6 +136,10 @@ private:
 	                   float v1,
 	                   float fraction) const;
 	ObjLibrary::Vector3 lattice (int x, int y, int z) const;
+	void buildTables ();
+	unsigned int tableIndex (int x, int y, int z) const;
+	float valueNoiseTable (float x, float y, float z) const;
+	float perlinNoiseTable (float x, float y, float z) const;
 	void printValue (float value) const;
 	bool invariant () const;
 
@@ -88,4 +155,11 @@ private:
 	unsigned int m_seed_q0;
 	unsigned int m_seed_q1;
 	unsigned int m_seed_q2;
+
+	unsigned int m_mode;
+
+	// only used in MODE_TABLE
+	std::vector<unsigned char> mv_permutation;  // repeated twice
+	std::vector<float> mv_gradients;            // x, y, z for each
+	std::vector<unsigned int> mv_values;
 };
@@ -0,0 +1,415 @@
+//
+//  PhysicsBodies.cpp
+//
+
+#include "PhysicsBodies.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "CoordinateSystem.h"
+#include "GravityKernels.h"
+#include "KeplerOrbit.h"
+#include "WorkerPool.h"
+
+using namespace ObjLibrary;
+
+namespace
+{
+	// fewer than this is faster to do than to wake another thread for
+	const unsigned int MIN_BODIES_PER_THREAD = 512;
+
+}  // end of anonymous namespace
+
+
+
+PhysicsBodies :: PhysicsBodies ()
+		: mv_positions()
+		, mv_velocities()
+		, mv_masses()
+		, mv_forwards()
+		, mv_ups()
+		, mv_rights()
+		, mv_rotation_axes()
+		, mv_rotation_rates()
+		, mv_is_active()
+		, mv_rotation_matrices()
+		, m_rotation_delta_time(0.0)
+		, m_gravity_kernel(GravityKernels::getBest())
+		, mv_orbits()
+		, mv_is_on_orbit()
+		, m_is_kepler_orbits(true)
+{
+	assert(invariant());
+}
+
+
+
+CoordinateSystem PhysicsBodies :: getCoordinateSystem (unsigned int body) const
+{
+	assert(body < getCount());
+
+	return CoordinateSystem(mv_positions[body],
+	                        mv_forwards [body],
+	                        mv_ups      [body],
+	                        mv_rights   [body]);
+}
+
+
+
+unsigned int PhysicsBodies :: addBody (const CoordinateSystem& coords,
+                                       const ObjLibrary::Vector3& velocity,
+                                       double mass,
+                                       const ObjLibrary::Vector3& rotation_axis,
+                                       double rotation_rate)
+{
+	assert(mass > 0.0);
+	assert(rotation_axis.isUnit());
+	assert(rotation_rate >= 0.0);
+
+	unsigned int body = getCount();
+	mv_positions     .push_back(Vector3());
+	mv_velocities    .push_back(Vector3());
+	mv_masses        .push_back(1.0);
+	mv_forwards      .push_back(Vector3());
+	mv_ups           .push_back(Vector3());
+	mv_rights        .push_back(Vector3());
+	mv_rotation_axes .push_back(Vector3());
+	mv_rotation_rates.push_back(0.0);
+	mv_is_active     .push_back(false);
+	mv_rotation_matrices.push_back(RotationMatrix());
+	mv_orbits        .push_back(KeplerOrbit());
+	mv_is_on_orbit   .push_back(0);
+
+	setBody(body, coords, velocity, mass, rotation_axis, rotation_rate);
+
+	assert(invariant());
+	return body;
+}
+
+void PhysicsBodies :: setBody (unsigned int body,
+                               const CoordinateSystem& coords,
+                               const ObjLibrary::Vector3& velocity,
+                               double mass,
+                               const ObjLibrary::Vector3& rotation_axis,
+                               double rotation_rate)
+{
+	assert(body < getCount());
+	assert(mass > 0.0);
+	assert(rotation_axis.isUnit());
+	assert(rotation_rate >= 0.0);
+
+	mv_positions     [body] = coords.getPosition();
+	mv_velocities    [body] = velocity;
+	mv_masses        [body] = mass;
+	mv_forwards      [body] = coords.getForward();
+	mv_ups           [body] = coords.getUp();
+	mv_rights        [body] = coords.getRight();
+	mv_rotation_axes [body] = rotation_axis.getNormalized();  // as CoordinateSystem::rotateAroundArbitrary does
+	mv_rotation_rates[body] = rotation_rate;
+	mv_is_active     [body] = true;
+	mv_rotation_matrices[body] = calculateRotationMatrix(mv_rotation_axes[body],
+	                                                     rotation_rate * m_rotation_delta_time);
+	mv_is_on_orbit   [body] = 0;  // starts after the first update
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setActive (unsigned int body, bool is_active)
+{
+	assert(body < getCount());
+
+	mv_is_active[body] = is_active;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setPosition (unsigned int body,
+                                   const ObjLibrary::Vector3& position)
+{
+	assert(body < getCount());
+
+	mv_positions[body] = position;
+	mv_is_on_orbit[body] = 0;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setVelocity (unsigned int body,
+                                   const ObjLibrary::Vector3& velocity)
+{
+	assert(body < getCount());
+
+	mv_velocities[body] = velocity;
+	mv_is_on_orbit[body] = 0;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setMass (unsigned int body, double mass)
+{
+	assert(body < getCount());
+	assert(mass > 0.0);
+
+	mv_masses[body] = mass;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setOrientation (unsigned int body,
+                                      const ObjLibrary::Vector3& forward,
+                                      const ObjLibrary::Vector3& up,
+                                      const ObjLibrary::Vector3& right)
+{
+	assert(body < getCount());
+	assert(forward.isNormal());
+	assert(up     .isNormal());
+	assert(right  .isNormal());
+
+	mv_forwards[body] = forward;
+	mv_ups     [body] = up;
+	mv_rights  [body] = right;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setGravityKernel (unsigned int kernel)
+{
+	assert(kernel < GravityKernels::COUNT);
+	assert(GravityKernels::isSupported(kernel));
+
+	m_gravity_kernel = kernel;
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: setKeplerOrbits (bool is_kepler_orbits)
+{
+	m_is_kepler_orbits = is_kepler_orbits;
+	if(!is_kepler_orbits)
+	{
+		for(unsigned int b = 0; b < getCount(); b++)
+			mv_is_on_orbit[b] = 0;
+	}
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: updateBody (unsigned int body,
+                                  double delta_time,
+                                  const ObjLibrary::Vector3& black_hole_position,
+                                  double black_hole_mass)
+{
+	assert(body < getCount());
+	assert(delta_time > 0.0);
+	assert(black_hole_mass > 0.0);
+
+	if(!mv_is_on_orbit[body])
+	{
+		GravityKernels::advance(GravityKernels::SCALAR, 1, delta_time,
+		                        black_hole_position, black_hole_mass,
+		                        &(mv_positions[body]), &(mv_velocities[body]));
+	}
+	if(m_is_kepler_orbits)
+		moveOnOrbit(body, delta_time, black_hole_position, black_hole_mass);
+
+	if(mv_rotation_rates[body] != 0.0)
+	{
+		if(delta_time == m_rotation_delta_time)
+			rotateBody(body, mv_rotation_matrices[body]);
+		else
+		{
+			rotateBody(body, calculateRotationMatrix(mv_rotation_axes[body],
+			                                         mv_rotation_rates[body] * delta_time));
+		}
+	}
+
+	assert(invariant());
+}
+
+void PhysicsBodies :: updatePhysics (double delta_time,
+                                     const ObjLibrary::Vector3& black_hole_position,
+                                     double black_hole_mass,
+                                     WorkerPool& r_worker_pool)
+{
+	assert(delta_time > 0.0);
+	assert(black_hole_mass > 0.0);
+
+	// the matrices are shared by all threads, so update them first
+	setRotationDeltaTime(delta_time);
+
+	r_worker_pool.run(getCount(), MIN_BODIES_PER_THREAD,
+	                  [&] (unsigned int begin, unsigned int end)
+	                  {
+	                      updateRange(begin, end, delta_time,
+	                                  black_hole_position, black_hole_mass);
+	                  });
+
+	assert(invariant());
+}
+
+
+
+void PhysicsBodies :: updateRange (unsigned int begin,
+                                   unsigned int end,
+                                   double delta_time,
+                                   const ObjLibrary::Vector3& black_hole_position,
+                                   double black_hole_mass)
+{
+	assert(begin <= end);
+	assert(end <= getCount());
+	assert(delta_time == m_rotation_delta_time);
+	assert(black_hole_mass > 0.0);
+
+	// move everything first, so each pass only touches the arrays it needs
+	for(unsigned int b = begin; b < end; )
+	{
+		if(!mv_is_active[b] || mv_is_on_orbit[b])
+		{
+			b++;
+			continue;
+		}
+
+		// find a run of bodies to pass to the kernel together
+		unsigned int run_start = b;
+		while(b < end && mv_is_active[b] && !mv_is_on_orbit[b])
+			b++;
+		GravityKernels::advance(m_gravity_kernel, b - run_start, delta_time,
+		                        black_hole_position, black_hole_mass,
+		                        &(mv_positions[run_start]), &(mv_velocities[run_start]));
+	}
+
+	// the bodies that were just moved start orbits here
+	if(m_is_kepler_orbits)
+	{
+		for(unsigned int b = begin; b < end; b++)
+			if(mv_is_active[b])
+				moveOnOrbit(b, delta_time, black_hole_position, black_hole_mass);
+	}
+
+	for(unsigned int b = begin; b < end; b++)
+		if(mv_is_active[b] && mv_rotation_rates[b] != 0.0)
+			rotateBody(b, mv_rotation_matrices[b]);
+}
+
+void PhysicsBodies :: moveOnOrbit (unsigned int body,
+                                   double delta_time,
+                                   const ObjLibrary::Vector3& black_hole_position,
+                                   double black_hole_mass)
+{
+	assert(body < getCount());
+	assert(isKeplerOrbits());
+	assert(delta_time > 0.0);
+	assert(black_hole_mass > 0.0);
+
+	if(mv_is_on_orbit[body] && !mv_orbits[body].isAround(black_hole_position, black_hole_mass))
+	{
+		mv_is_on_orbit[body] = 0;
+		GravityKernels::advance(GravityKernels::SCALAR, 1, delta_time,
+		                        black_hole_position, black_hole_mass,
+		                        &(mv_positions[body]), &(mv_velocities[body]));
+	}
+
+	if(mv_is_on_orbit[body])
+		mv_orbits[body].advance(delta_time, mv_positions[body], mv_velocities[body]);
+	else if(KeplerOrbit::isPossible(black_hole_position, mv_positions[body]))
+	{
+		mv_orbits[body] = KeplerOrbit(black_hole_position, black_hole_mass,
+		                              mv_positions[body], mv_velocities[body]);
+		mv_is_on_orbit[body] = 1;
+	}
+}
+
+
+
+PhysicsBodies::RotationMatrix PhysicsBodies :: calculateRotationMatrix (
+                                        const ObjLibrary::Vector3& axis,
+                                        double radians)
+{
+	assert(axis.isNormal());
+
+	static const double A_IDENTITY[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+
+	double aa = axis.x * axis.x;
+	double bb = axis.y * axis.y;
+	double cc = axis.z * axis.z;
+	double ab = axis.x * axis.y;
+	double ac = axis.x * axis.z;
+	double bc = axis.y * axis.z;
+
+	double a_hat [9] = { aa, ab, ac, ab, bb, bc, ac, bc, cc };
+	double a_star[9] = {       0, -axis.z,  axis.y,
+	                      axis.z,       0, -axis.x,
+	                     -axis.y,  axis.x,       0 };
+
+	double cos_radians = cos(radians);
+	double sin_radians = sin(radians);
+
+	// same order of operations as Vector3::rotateArbitraryNormal
+	RotationMatrix matrix;
+	for(unsigned int i = 0; i < 9; i++)
+		matrix.ma_entries[i] = (a_hat[i] + (A_IDENTITY[i] - a_hat[i]) * cos_radians) + a_star[i] * sin_radians;
+	return matrix;
+}
+
+void PhysicsBodies :: rotateByMatrix (const RotationMatrix& matrix,
+                                      ObjLibrary::Vector3& r_vector)
+{
+	const double* a_entries = matrix.ma_entries;
+	r_vector = Vector3(r_vector.x * a_entries[0] + r_vector.y * a_entries[1] + r_vector.z * a_entries[2],
+	                   r_vector.x * a_entries[3] + r_vector.y * a_entries[4] + r_vector.z * a_entries[5],
+	                   r_vector.x * a_entries[6] + r_vector.y * a_entries[7] + r_vector.z * a_entries[8]);
+}
+
+void PhysicsBodies :: rotateBody (unsigned int body,
+                                  const RotationMatrix& matrix)
+{
+	assert(body < getCount());
+
+	rotateByMatrix(matrix, mv_forwards[body]);
+	rotateByMatrix(matrix, mv_ups     [body]);
+	rotateByMatrix(matrix, mv_rights  [body]);
+}
+
+void PhysicsBodies :: setRotationDeltaTime (double delta_time)
+{
+	assert(delta_time >= 0.0);
+
+	if(delta_time == m_rotation_delta_time)
+		return;
+
+	m_rotation_delta_time = delta_time;
+	for(unsigned int b = 0; b < getCount(); b++)
+	{
+		mv_rotation_matrices[b] = calculateRotationMatrix(mv_rotation_axes[b],
+		                                                  mv_rotation_rates[b] * delta_time);
+	}
+}
+
+
+
+bool PhysicsBodies :: invariant () const
+{
+	unsigned int count = mv_positions.size();
+	if(mv_velocities    .size() != count) return false;
+	if(mv_masses        .size() != count) return false;
+	if(mv_forwards      .size() != count) return false;
+	if(mv_ups           .size() != count) return false;
+	if(mv_rights        .size() != count) return false;
+	if(mv_rotation_axes .size() != count) return false;
+	if(mv_rotation_rates.size() != count) return false;
+	if(mv_is_active     .size() != count) return false;
+	if(mv_rotation_matrices.size() != count) return false;
+	if(m_rotation_delta_time < 0.0) return false;
+	if(m_gravity_kernel >= GravityKernels::COUNT) return false;
+	if(!GravityKernels::isSupported(m_gravity_kernel)) return false;
+	if(mv_orbits        .size() != count) return false;
+	if(mv_is_on_orbit   .size() != count) return false;
+	// <15> is not checked here, because every body would have to be checked
+	//  after every change to one body.  Only moveOnOrbit starts an orbit, and
+	//  it asserts that Kepler orbits are on.
+	return true;
+}
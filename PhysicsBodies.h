@@ -0,0 +1,639 @@
+//
+//  PhysicsBodies.h
+//
+//  A module to store the physics state of many bodies in
+//    arrays.
+//
+
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "CoordinateSystem.h"
+#include "KeplerOrbit.h"
+
+class WorkerPool;
+
+
+
+//
+//  PhysicsBodies
+//
+//  A class to store the physics state for a collection of
+//    bodies that move under the gravity of the black hole and
+//    rotate at a constant rate.  Each body has a position, an
+//    orientation, a velocity, a mass, and a rotation axis and
+//    rate.  Each of these is stored in its own array, so that
+//    updating all the bodies reads and writes memory in order
+//    instead of jumping between Entity objects.  The rotation
+//    for one time step is also stored for each body, so that
+//    it does not have to be recalculated every time step while
+//    the time step stays the same.  The positions and
+//    velocities are updated with one of the GravityKernels,
+//    which is the fastest one supported by default.
+//
+//  Between collisions, the bodies only feel the gravity of the
+//    black hole, so their paths are KeplerOrbits.  If Kepler
+//    orbits are turned on (the default), each body follows a
+//    KeplerOrbit calculated from its position and velocity,
+//    which is exact for any time step.  Changing the position
+//    or velocity of a body (e.g. in a collision) ends its
+//    orbit.  It is then moved with the gravity kernel for one
+//    time step and a new orbit is calculated from where it is
+//    after that.
+//
+//  Bodies are identified by their index, which never changes.
+//    Bodies are never removed, but they can be marked inactive.
+//    Inactive bodies are not moved by updatePhysics and their
+//    index can be given to a new body with setBody.
+//
+//  The Entities stored here (see Entity::moveIntoBodies) keep
+//    the body index and a pointer to this PhysicsBodies, so it
+//    must not be moved or destroyed while they exist.
+//
+//  Class Invariant:
+//    <1> mv_velocities.size()     == mv_positions.size()
+//    <2> mv_masses.size()         == mv_positions.size()
+//    <3> mv_forwards.size()       == mv_positions.size()
+//    <4> mv_ups.size()            == mv_positions.size()
+//    <5> mv_rights.size()         == mv_positions.size()
+//    <6> mv_rotation_axes.size()  == mv_positions.size()
+//    <7> mv_rotation_rates.size() == mv_positions.size()
+//    <8> mv_is_active.size()      == mv_positions.size()
+//    <9> mv_rotation_matrices.size() == mv_positions.size()
+//   <10> m_rotation_delta_time >= 0.0
+//   <11> m_gravity_kernel < GravityKernels::COUNT
+//   <12> GravityKernels::isSupported(m_gravity_kernel)
+//   <13> mv_orbits.size()         == mv_positions.size()
+//   <14> mv_is_on_orbit.size()    == mv_positions.size()
+//   <15> m_is_kepler_orbits || !mv_is_on_orbit[b] for all b
+//
+class PhysicsBodies
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a PhysicsBodies with no bodies.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new PhysicsBodies is created.  It will use
+//               GravityKernels::getBest().
+//
+	PhysicsBodies ();
+
+	PhysicsBodies (const PhysicsBodies& to_copy) = default;
+	~PhysicsBodies () = default;
+	PhysicsBodies& operator= (const PhysicsBodies& to_copy) = default;
+
+//
+//  getCount
+//
+//  Purpose: To determine how many bodies there are, including
+//           inactive ones.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of bodies.
+//  Side Effect: N/A
+//
+	unsigned int getCount () const
+	{  return mv_positions.size();  }
+
+//
+//  getGravityKernel
+//
+//  Purpose: To determine which of the GravityKernels is used to
+//           update the bodies.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The gravity kernel.
+//  Side Effect: N/A
+//
+	unsigned int getGravityKernel () const
+	{  return m_gravity_kernel;  }
+
+//
+//  isKeplerOrbits
+//
+//  Purpose: To determine whether bodies follow KeplerOrbits
+//           between collisions.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether Kepler orbits are turned on.  If not, all
+//           bodies are always moved with the gravity kernel.
+//  Side Effect: N/A
+//
+	bool isKeplerOrbits () const
+	{  return m_is_kepler_orbits;  }
+
+//
+//  isOnOrbit
+//
+//  Purpose: To determine whether the specified body is
+//           following a KeplerOrbit.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: Whether body body is following a KeplerOrbit.
+//  Side Effect: N/A
+//
+	bool isOnOrbit (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_is_on_orbit[body] != 0;
+	}
+
+//
+//  getOrbit
+//
+//  Purpose: To retrieve the KeplerOrbit the specified body is
+//           following.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> isOnOrbit(body)
+//  Returns: The KeplerOrbit for body body.  Its current time is
+//           the current time for the body.
+//  Side Effect: N/A
+//
+	const KeplerOrbit& getOrbit (unsigned int body) const
+	{
+		assert(body < getCount());
+		assert(isOnOrbit(body));
+
+		return mv_orbits[body];
+	}
+
+//
+//  isActive
+//
+//  Purpose: To determine whether the specified body is moved by
+//           updatePhysics.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: Whether body body is active.
+//  Side Effect: N/A
+//
+	bool isActive (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_is_active[body];
+	}
+
+//
+//  getPosition
+//  getForward
+//  getUp
+//  getRight
+//  getVelocity
+//
+//  Purpose: To determine the position, local forward/up/right
+//           vector, or velocity of the specified body.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: The requested value for body body.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getPosition (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_positions[body];
+	}
+	const ObjLibrary::Vector3& getForward (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_forwards[body];
+	}
+	const ObjLibrary::Vector3& getUp (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_ups[body];
+	}
+	const ObjLibrary::Vector3& getRight (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_rights[body];
+	}
+	const ObjLibrary::Vector3& getVelocity (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_velocities[body];
+	}
+
+//
+//  getCoordinateSystem
+//
+//  Purpose: To retrieve the coordinate system for the specified
+//           body.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: A CoordinateSystem with the position and
+//           orientation of body body.
+//  Side Effect: N/A
+//
+	CoordinateSystem getCoordinateSystem (unsigned int body) const;
+
+//
+//  getMass
+//
+//  Purpose: To determine the mass of the specified body.
+//  Parameter(s):
+//    <1> body: Which body
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: The mass of body body.
+//  Side Effect: N/A
+//
+	double getMass (unsigned int body) const
+	{
+		assert(body < getCount());
+
+		return mv_masses[body];
+	}
+
+//
+//  addBody
+//
+//  Purpose: To add a new active body.
+//  Parameter(s):
+//    <1> coords: The body position and orientation
+//    <2> velocity: The body velocity
+//    <3> mass: The body mass
+//    <4> rotation_axis: The axis the body rotates around
+//    <5> rotation_rate: The rotation rate in radians per second
+//  Preconditions:
+//    <1> mass > 0.0
+//    <2> rotation_axis.isUnit()
+//    <3> rotation_rate >= 0.0
+//  Returns: The index of the new body.
+//  Side Effect: A new body is added with the specified values.
+//
+	unsigned int addBody (const CoordinateSystem& coords,
+	                      const ObjLibrary::Vector3& velocity,
+	                      double mass,
+	                      const ObjLibrary::Vector3& rotation_axis,
+	                      double rotation_rate);
+
+//
+//  setBody
+//
+//  Purpose: To replace the specified body.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> coords: The body position and orientation
+//    <3> velocity: The body velocity
+//    <4> mass: The body mass
+//    <5> rotation_axis: The axis the body rotates around
+//    <6> rotation_rate: The rotation rate in radians per second
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> mass > 0.0
+//    <3> rotation_axis.isUnit()
+//    <4> rotation_rate >= 0.0
+//  Returns: N/A
+//  Side Effect: Body body is replaced by a new active body with
+//               the specified values.
+//
+	void setBody (unsigned int body,
+	              const CoordinateSystem& coords,
+	              const ObjLibrary::Vector3& velocity,
+	              double mass,
+	              const ObjLibrary::Vector3& rotation_axis,
+	              double rotation_rate);
+
+//
+//  setActive
+//
+//  Purpose: To change whether the specified body is moved by
+//           updatePhysics.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> is_active: Whether the body should be active
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: N/A
+//  Side Effect: Body body is marked as active or inactive.
+//
+	void setActive (unsigned int body, bool is_active);
+
+//
+//  setPosition
+//  setVelocity
+//  setMass
+//
+//  Purpose: To change the position, velocity, or mass of the
+//           specified body.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> position
+//        velocity
+//        mass: The new value
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> mass > 0.0
+//  Returns: N/A
+//  Side Effect: The position, velocity, or mass of body body is
+//               changed.  If the position or velocity is
+//               changed, body body stops following its
+//               KeplerOrbit.
+//
+	void setPosition (unsigned int body,
+	                  const ObjLibrary::Vector3& position);
+	void setVelocity (unsigned int body,
+	                  const ObjLibrary::Vector3& velocity);
+	void setMass (unsigned int body, double mass);
+
+//
+//  setOrientation
+//
+//  Purpose: To change the orientation of the specified body.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> forward: The new forward vector
+//    <3> up: The new up vector
+//    <4> right: The new right vector
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> forward.isNormal()
+//    <3> up.isNormal()
+//    <4> right.isNormal()
+//  Returns: N/A
+//  Side Effect: Body body is turned to face the specified
+//               direction.  Its position, velocity, and
+//               KeplerOrbit are unchanged.
+//
+	void setOrientation (unsigned int body,
+	                     const ObjLibrary::Vector3& forward,
+	                     const ObjLibrary::Vector3& up,
+	                     const ObjLibrary::Vector3& right);
+
+//
+//  setGravityKernel
+//
+//  Purpose: To change which of the GravityKernels is used to
+//           update the bodies.
+//  Parameter(s):
+//    <1> kernel: The new gravity kernel
+//  Preconditions:
+//    <1> kernel < GravityKernels::COUNT
+//    <2> GravityKernels::isSupported(kernel)
+//  Returns: N/A
+//  Side Effect: Gravity kernel kernel will be used by
+//               updatePhysics.
+//
+	void setGravityKernel (unsigned int kernel);
+
+//
+//  setKeplerOrbits
+//
+//  Purpose: To change whether bodies follow KeplerOrbits
+//           between collisions.
+//  Parameter(s):
+//    <1> is_kepler_orbits: Whether to use Kepler orbits
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Kepler orbits are turned on or off.  If they
+//               are turned off, all bodies stop following
+//               their orbits.
+//
+	void setKeplerOrbits (bool is_kepler_orbits);
+
+//
+//  updateBody
+//
+//  Purpose: To perform the physics updates for the specified
+//           body for one time step.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> delta_time: The length of the time step in seconds
+//    <3> black_hole_position: The position of the black hole
+//    <4> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> delta_time > 0.0
+//    <3> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Body body is updated as in updatePhysics, even
+//               if it is inactive.  The scalar gravity kernel is
+//               used if it is not following a KeplerOrbit.
+//
+	void updateBody (unsigned int body,
+	                 double delta_time,
+	                 const ObjLibrary::Vector3& black_hole_position,
+	                 double black_hole_mass);
+
+//
+//  updatePhysics
+//
+//  Purpose: To perform the physics updates for all active
+//           bodies for one time step.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//    <2> black_hole_position: The position of the black hole
+//    <3> black_hole_mass: The mass of the black hole
+//    <4> r_worker_pool: The WorkerPool to split the bodies
+//                       between
+//  Preconditions:
+//    <1> delta_time > 0.0
+//    <2> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Each active body is moved along its KeplerOrbit
+//               or, if it is not following one, accelerated by
+//               the gravity of the black hole and moved
+//               according to its updated velocity.  Each active
+//               body is then rotated around its rotation axis.
+//               The results are the same as calling
+//               Entity::updatePhysics for each body.  Each body
+//               only depends on its own state, so the results
+//               are the same for any number of threads in
+//               r_worker_pool.
+//
+	void updatePhysics (double delta_time,
+	                    const ObjLibrary::Vector3& black_hole_position,
+	                    double black_hole_mass,
+	                    WorkerPool& r_worker_pool);
+
+private:
+//
+//  RotationMatrix
+//
+//  A record to store the rotation of a body for one time step.
+//
+	struct RotationMatrix
+	{
+		double ma_entries[9];
+	};
+
+//
+//  updateRange
+//
+//  Purpose: To perform the physics updates for the active
+//           bodies in the specified range for one time step.
+//  Parameter(s):
+//    <1> begin: The first body to update
+//    <2> end: One past the last body to update
+//    <3> delta_time: The length of the time step in seconds
+//    <4> black_hole_position: The position of the black hole
+//    <5> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> begin <= end
+//    <2> end <= getCount()
+//    <3> delta_time == m_rotation_delta_time
+//    <4> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Each active body from begin to end is updated
+//               as described for updatePhysics.  No other
+//               bodies are changed, so different ranges can
+//               be updated on different threads at once.
+//
+	void updateRange (unsigned int begin,
+	                  unsigned int end,
+	                  double delta_time,
+	                  const ObjLibrary::Vector3& black_hole_position,
+	                  double black_hole_mass);
+
+//
+//  moveOnOrbit
+//
+//  Purpose: To move the specified body along its KeplerOrbit,
+//           or start one for it.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> delta_time: The length of the time step in seconds
+//    <3> black_hole_position: The position of the black hole
+//    <4> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> body < getCount()
+//    <2> isKeplerOrbits()
+//    <3> delta_time > 0.0
+//    <4> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: If body body is following a KeplerOrbit, it is
+//               moved along it by delta_time.  Otherwise, the
+//               body has already been moved for this time step,
+//               so a new orbit is started from where it is, if
+//               possible.  If the black hole has changed since
+//               the orbit was calculated, the body is moved with
+//               the scalar gravity kernel instead and a new
+//               orbit is started.
+//
+	void moveOnOrbit (unsigned int body,
+	                  double delta_time,
+	                  const ObjLibrary::Vector3& black_hole_position,
+	                  double black_hole_mass);
+
+//
+//  Class Function: calculateRotationMatrix
+//
+//  Purpose: To calculate the matrix for a rotation around the
+//           specified axis.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Preconditions:
+//    <1> axis.isNormal()
+//  Returns: The rotation matrix.  This is calculated the same
+//           way as in Vector3::rotateArbitraryNormal, so using
+//           it with rotateByMatrix gives exactly the same
+//           result.
+//  Side Effect: N/A
+//
+	static RotationMatrix calculateRotationMatrix (
+	                                 const ObjLibrary::Vector3& axis,
+	                                 double radians);
+
+//
+//  Class Function: rotateByMatrix
+//
+//  Purpose: To rotate a vector by the specified matrix.
+//  Parameter(s):
+//    <1> matrix: The rotation matrix
+//    <2> r_vector: The vector to rotate
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: r_vector is multiplied by matrix.
+//
+	static void rotateByMatrix (const RotationMatrix& matrix,
+	                            ObjLibrary::Vector3& r_vector);
+
+//
+//  rotateBody
+//
+//  Purpose: To rotate the specified body by the specified
+//           matrix.
+//  Parameter(s):
+//    <1> body: Which body
+//    <2> matrix: The rotation matrix
+//  Preconditions:
+//    <1> body < getCount()
+//  Returns: N/A
+//  Side Effect: The orientation of body body is rotated by
+//               matrix.
+//
+	void rotateBody (unsigned int body,
+	                 const RotationMatrix& matrix);
+
+//
+//  setRotationDeltaTime
+//
+//  Purpose: To change the time step that the stored rotation
+//           matrices are for.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> delta_time >= 0.0
+//  Returns: N/A
+//  Side Effect: If delta_time is different from the current
+//               time step, the rotation matrices for all bodies
+//               are recalculated.
+//
+	void setRotationDeltaTime (double delta_time);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<ObjLibrary::Vector3> mv_positions;
+	std::vector<ObjLibrary::Vector3> mv_velocities;
+	std::vector<double> mv_masses;
+	std::vector<ObjLibrary::Vector3> mv_forwards;
+	std::vector<ObjLibrary::Vector3> mv_ups;
+	std::vector<ObjLibrary::Vector3> mv_rights;
+	std::vector<ObjLibrary::Vector3> mv_rotation_axes;  // normalized
+	std::vector<double> mv_rotation_rates;
+	std::vector<bool> mv_is_active;
+	std::vector<RotationMatrix> mv_rotation_matrices;
+	double m_rotation_delta_time;
+	unsigned int m_gravity_kernel;
+
+	std::vector<KeplerOrbit> mv_orbits;
+	std::vector<unsigned char> mv_is_on_orbit;  // not vector<bool>, so threads can write at once
+	bool m_is_kepler_orbits;
+};
@@ -0,0 +1,194 @@
+//
+//  PointGrid.cpp
+//
+
+#include "PointGrid.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	// keeps cell coordinates far from overflowing
+	const double CELL_MAX = 1.0e9;
+
+	// large primes to spread the cells between buckets
+	const unsigned int HASH_X = 73856093u;
+	const unsigned int HASH_Y = 19349663u;
+	const unsigned int HASH_Z = 83492791u;
+}
+
+
+
+PointGrid :: PointGrid ()
+		: m_cell_size(1.0)
+		, mv_points()
+		, mv_sorted()
+		, mv_bucket_starts(2, 0)
+		, m_bucket_count(1)
+		, m_is_built(true)
+{
+	assert(invariant());
+}
+
+PointGrid :: PointGrid (double cell_size)
+		: m_cell_size(cell_size)
+		, mv_points()
+		, mv_sorted()
+		, mv_bucket_starts(2, 0)
+		, m_bucket_count(1)
+		, m_is_built(true)
+{
+	assert(cell_size > 0.0);
+
+	assert(invariant());
+}
+
+
+
+void PointGrid :: clear ()
+{
+	mv_points.clear();
+	mv_sorted.clear();
+	m_bucket_count = 1;
+	mv_bucket_starts.assign(2, 0);
+	m_is_built = true;
+
+	assert(invariant());
+}
+
+void PointGrid :: addPoint (unsigned int id,
+                            const ObjLibrary::Vector3& position)
+{
+	Point point;
+	point.m_position = position;
+	point.m_id       = id;
+	point.ma_cell[0] = calculateCell(position.x);
+	point.ma_cell[1] = calculateCell(position.y);
+	point.ma_cell[2] = calculateCell(position.z);
+	mv_points.push_back(point);
+	m_is_built = false;
+
+	assert(invariant());
+}
+
+void PointGrid :: build ()
+{
+	// about 2 buckets per point keeps collisions rare
+	m_bucket_count = 1;
+	while(m_bucket_count < mv_points.size() * 2)
+		m_bucket_count *= 2;
+
+	//
+	//  Counting sort by bucket.  The points in each bucket stay
+	//    in the order they were added, so the search results do
+	//    not depend on anything else.
+	//
+
+	mv_bucket_starts.assign(m_bucket_count + 1, 0);
+	for(unsigned int p = 0; p < mv_points.size(); p++)
+	{
+		const int* a_cell = mv_points[p].ma_cell;
+		mv_bucket_starts[calculateBucket(a_cell[0], a_cell[1], a_cell[2]) + 1]++;
+	}
+	for(unsigned int b = 0; b < m_bucket_count; b++)
+		mv_bucket_starts[b + 1] += mv_bucket_starts[b];
+
+	// each start is moved to the next one while placing the points
+	mv_sorted.resize(mv_points.size());
+	for(unsigned int p = 0; p < mv_points.size(); p++)
+	{
+		const int* a_cell = mv_points[p].ma_cell;
+		unsigned int bucket = calculateBucket(a_cell[0], a_cell[1], a_cell[2]);
+		mv_sorted[mv_bucket_starts[bucket]] = mv_points[p];
+		mv_bucket_starts[bucket]++;
+	}
+	for(unsigned int b = m_bucket_count; b > 0; b--)
+		mv_bucket_starts[b] = mv_bucket_starts[b - 1];
+	mv_bucket_starts[0] = 0;
+
+	m_is_built = true;
+	assert(invariant());
+}
+
+void PointGrid :: findWithin (const ObjLibrary::Vector3& center,
+                              double radius,
+                              std::vector<unsigned int>& r_ids) const
+{
+	assert(isBuilt());
+	assert(radius >= 0.0);
+
+	int min_x = calculateCell(center.x - radius);
+	int min_y = calculateCell(center.y - radius);
+	int min_z = calculateCell(center.z - radius);
+	int max_x = calculateCell(center.x + radius);
+	int max_y = calculateCell(center.y + radius);
+	int max_z = calculateCell(center.z + radius);
+
+	// exact, unlike Vector3::isDistanceLessThan, so no point at or
+	//   past radius is ever returned
+	double radius_squared = radius * radius;
+
+	// if there are more cells than points, just check the points
+	double cell_count = (max_x - min_x + 1.0) * (max_y - min_y + 1.0) * (max_z - min_z + 1.0);
+	if(cell_count > mv_points.size())
+	{
+		for(unsigned int p = 0; p < mv_points.size(); p++)
+			if(mv_points[p].m_position.getDistanceSquared(center) < radius_squared)
+				r_ids.push_back(mv_points[p].m_id);
+		return;
+	}
+
+	for(int x = min_x; x <= max_x; x++)
+		for(int y = min_y; y <= max_y; y++)
+			for(int z = min_z; z <= max_z; z++)
+			{
+				unsigned int bucket = calculateBucket(x, y, z);
+				unsigned int end    = mv_bucket_starts[bucket + 1];
+				for(unsigned int s = mv_bucket_starts[bucket]; s < end; s++)
+				{
+					// other cells can share the bucket
+					const Point& point = mv_sorted[s];
+					if(point.ma_cell[0] == x &&
+					   point.ma_cell[1] == y &&
+					   point.ma_cell[2] == z &&
+					   point.m_position.getDistanceSquared(center) < radius_squared)
+					{
+						r_ids.push_back(point.m_id);
+					}
+				}
+			}
+}
+
+
+
+int PointGrid :: calculateCell (double coordinate) const
+{
+	double cell = floor(coordinate / m_cell_size);
+	if(cell >  CELL_MAX) return  (int)(CELL_MAX);
+	if(cell < -CELL_MAX) return -(int)(CELL_MAX);
+	return (int)(cell);
+}
+
+unsigned int PointGrid :: calculateBucket (int x, int y, int z) const
+{
+	unsigned int hash = ((unsigned int)(x) * HASH_X) ^
+	                    ((unsigned int)(y) * HASH_Y) ^
+	                    ((unsigned int)(z) * HASH_Z);
+	return hash & (m_bucket_count - 1);
+}
+
+bool PointGrid :: invariant () const
+{
+	if(m_cell_size <= 0.0) return false;
+	if(m_is_built && mv_sorted.size() != mv_points.size()) return false;
+	if(m_is_built && mv_bucket_starts.size() != m_bucket_count + 1) return false;
+	if(m_bucket_count == 0) return false;
+	if((m_bucket_count & (m_bucket_count - 1)) != 0) return false;
+	return true;
+}
@@ -0,0 +1,239 @@
+//
+//  PointGrid.h
+//
+//  A module to find the points near a position.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  PointGrid
+//
+//  A class to find which of a set of points are within a
+//    distance of a position without checking every point.  Each
+//    point has an ID chosen by the caller (e.g. an index into
+//    another array).  Space is divided into cubical cells, and
+//    the points are sorted by the cell they are in, so a search
+//    only checks the points in the cells it overlaps.  The
+//    cells are found with a hash table, so space does not have
+//    to be bounded and empty cells take no memory.
+//
+//  The points are added one at a time and then build is called
+//    to sort them.  Adding more points after that requires
+//    another call to build before searching again.  Memory is
+//    reused between builds, so rebuilding every time step does
+//    not allocate memory once the number of points stops
+//    growing.
+//
+//  The search time depends on how many points are near the
+//    position searched from, not on the total number of points.
+//    It is fastest when the search radius is about the same as
+//    the cell size.
+//
+//  Class Invariant:
+//    <1> m_cell_size > 0.0
+//    <2> !m_is_built || mv_sorted.size() == mv_points.size()
+//    <3> !m_is_built || mv_bucket_starts.size() == m_bucket_count + 1
+//    <4> m_bucket_count is a power of 2
+//
+class PointGrid
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty PointGrid with cells of size 1.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new PointGrid is created.  It contains no
+//               points and is built.
+//
+	PointGrid ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an empty PointGrid with the specified
+//           cell size.
+//  Parameter(s):
+//    <1> cell_size: The side length of each cell
+//  Preconditions:
+//    <1> cell_size > 0.0
+//  Returns: N/A
+//  Side Effect: A new PointGrid is created.  It contains no
+//               points and is built.
+//
+	PointGrid (double cell_size);
+
+	PointGrid (const PointGrid& to_copy) = default;
+	~PointGrid () = default;
+	PointGrid& operator= (const PointGrid& to_copy) = default;
+
+//
+//  getCellSize
+//
+//  Purpose: To determine the size of the cells in this
+//           PointGrid.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The side length of each cell.
+//  Side Effect: N/A
+//
+	double getCellSize () const
+	{  return m_cell_size;  }
+
+//
+//  getPointCount
+//
+//  Purpose: To determine how many points are in this
+//           PointGrid.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of points added since this PointGrid
+//           was last cleared.
+//  Side Effect: N/A
+//
+	unsigned int getPointCount () const
+	{  return mv_points.size();  }
+
+//
+//  isBuilt
+//
+//  Purpose: To determine whether this PointGrid can be
+//           searched.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether build has been called since the last point
+//           was added.
+//  Side Effect: N/A
+//
+	bool isBuilt () const
+	{  return m_is_built;  }
+
+//
+//  clear
+//
+//  Purpose: To remove all points from this PointGrid.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This PointGrid is emptied.  It is built.
+//
+	void clear ();
+
+//
+//  addPoint
+//
+//  Purpose: To add a point to this PointGrid.
+//  Parameter(s):
+//    <1> id: The ID for the point
+//    <2> position: The position of the point
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A point with ID id is added at position
+//               position.  This PointGrid is marked as not
+//               built.
+//
+	void addPoint (unsigned int id,
+	               const ObjLibrary::Vector3& position);
+
+//
+//  build
+//
+//  Purpose: To sort the points in this PointGrid into cells so
+//           that they can be searched.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The points are sorted into cells.  This
+//               PointGrid is marked as built.
+//
+	void build ();
+
+//
+//  findWithin
+//
+//  Purpose: To find the points within the specified distance
+//           of the specified position.
+//  Parameter(s):
+//    <1> center: The position to search from
+//    <2> radius: The search distance
+//    <3> r_ids: A vector to add the point IDs to
+//  Preconditions:
+//    <1> isBuilt()
+//    <2> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: The ID of every point less than radius from
+//               center is added to the end of r_ids.  The
+//               distance is compared exactly, with no
+//               tolerance.  Each point is added once.  The order the IDs are
+//               added in depends only on the points added and
+//               center and radius.
+//
+	void findWithin (const ObjLibrary::Vector3& center,
+	                 double radius,
+	                 std::vector<unsigned int>& r_ids) const;
+
+private:
+//
+//  calculateCell
+//
+//  Purpose: To determine which cell coordinate the specified
+//           position coordinate is in.
+//  Parameter(s):
+//    <1> coordinate: The position coordinate
+//  Preconditions: N/A
+//  Returns: The cell coordinate containing coordinate.
+//  Side Effect: N/A
+//
+	int calculateCell (double coordinate) const;
+
+//
+//  calculateBucket
+//
+//  Purpose: To determine which hash table bucket the specified
+//           cell is stored in.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The cell coordinates
+//  Preconditions: N/A
+//  Returns: The bucket index for the cell.
+//  Side Effect: N/A
+//
+	unsigned int calculateBucket (int x, int y, int z) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	struct Point
+	{
+		ObjLibrary::Vector3 m_position;
+		unsigned int m_id;
+		int ma_cell[3];
+	};
+
+private:
+	double m_cell_size;
+	std::vector<Point> mv_points;  // in the order added
+	std::vector<Point> mv_sorted;  // by bucket
+	std::vector<unsigned int> mv_bucket_starts;  // into mv_sorted, plus end
+	unsigned int m_bucket_count;
+	bool m_is_built;
+};
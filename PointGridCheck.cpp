@@ -0,0 +1,196 @@
+//
+//  PointGridCheck.cpp
+//
+//  A program to check that PointGrid::findWithin and
+//    Game::findNearestUnclaimedCrystal find the same points as
+//    checking every point.  The points are clustered so that
+//    cells hold many points, and the search distances range
+//    from 0 to larger than all the points.
+//
+//  Usage: point_grid_check
+//
+
+#include <cstdlib>  // for rand
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "ObjLibrary/Vector3.h"
+#include "PointGrid.h"
+#include "Spaceship.h"
+#include "Game.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+namespace
+{
+	const double CELL_SIZES[] = { 0.5, 10.0, 1000.0 };
+	const unsigned int CELL_SIZE_COUNT = sizeof(CELL_SIZES) / sizeof(CELL_SIZES[0]);
+	const unsigned int POINT_COUNT = 2000;
+	const unsigned int CLUSTER_COUNT = 20;
+	const double CLUSTER_SPREAD = 1000.0;
+	const double CLUSTER_SIZE = 20.0;
+	const unsigned int SEARCH_COUNT = 2000;
+	const double RADIUS_MAX = 200.0;
+	const double RADIUS_HUGE = 1.0e5;
+
+	const unsigned int DRONE_COUNT = 100;
+	const double DELTA_TIME = 0.5;
+	const unsigned int TICK_COUNT_MAX = 2000;
+	const unsigned int CRYSTAL_COUNT_MIN = 10;
+	const double CRYSTAL_SEARCH_SPREAD = 100.0;
+	const double CRYSTAL_DISTANCE_MAX = 2000.0;
+
+	double random0to1 ()
+	{
+		return rand() / (double)(RAND_MAX);
+	}
+
+	Vector3 randomPosition (const Vector3& center, double spread)
+	{
+		return center + Vector3((random0to1() * 2.0 - 1.0) * spread,
+		                        (random0to1() * 2.0 - 1.0) * spread,
+		                        (random0to1() * 2.0 - 1.0) * spread);
+	}
+
+	bool checkPointGrid ()
+	{
+		vector<Vector3> v_clusters;
+		for(unsigned int c = 0; c < CLUSTER_COUNT; c++)
+			v_clusters.push_back(randomPosition(Vector3::ZERO, CLUSTER_SPREAD));
+
+		vector<Vector3> v_points;
+		for(unsigned int p = 0; p < POINT_COUNT; p++)
+		{
+			// some points are in the same place as an earlier one
+			if(p > 0 && rand() % 10 == 0)
+				v_points.push_back(v_points[rand() % p]);
+			else
+				v_points.push_back(randomPosition(v_clusters[rand() % CLUSTER_COUNT], CLUSTER_SIZE));
+		}
+
+		vector<unsigned int> v_found;
+		vector<unsigned int> v_expected;
+		for(unsigned int s = 0; s < CELL_SIZE_COUNT; s++)
+		{
+			PointGrid grid(CELL_SIZES[s]);
+			for(unsigned int p = 0; p < POINT_COUNT; p++)
+				grid.addPoint(p, v_points[p]);
+			grid.build();
+
+			for(unsigned int i = 0; i < SEARCH_COUNT; i++)
+			{
+				Vector3 center;
+				double radius;
+				switch(i % 4)
+				{
+				case 0:  // on a point, so some distances are 0
+					center = v_points[rand() % POINT_COUNT];
+					radius = random0to1() * RADIUS_MAX;
+					break;
+				case 1:  // at the distance of a point, to check the boundary
+					center = randomPosition(v_clusters[rand() % CLUSTER_COUNT], CLUSTER_SIZE);
+					radius = center.getDistance(v_points[rand() % POINT_COUNT]);
+					break;
+				case 2:
+					center = randomPosition(v_clusters[rand() % CLUSTER_COUNT], CLUSTER_SIZE);
+					radius = (i % 8 == 2) ? 0.0 : RADIUS_HUGE;
+					break;
+				default:
+					center = randomPosition(Vector3::ZERO, CLUSTER_SPREAD);
+					radius = random0to1() * RADIUS_MAX;
+					break;
+				}
+
+				v_found.clear();
+				grid.findWithin(center, radius, v_found);
+				sort(v_found.begin(), v_found.end());
+
+				v_expected.clear();
+				for(unsigned int p = 0; p < POINT_COUNT; p++)
+					if(v_points[p].getDistanceSquared(center) < radius * radius)
+						v_expected.push_back(p);
+
+				if(v_found != v_expected)
+				{
+					cerr << "PointGrid with cell size " << CELL_SIZES[s] << " found " << v_found.size()
+					     << " points instead of " << v_expected.size() << " within " << radius
+					     << " of " << center << endl;
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool checkNearestUnclaimedCrystal ()
+	{
+		Game::loadModels("Models/");
+		Game game(1, DRONE_COUNT);
+		// the drones collect the crystals, so stop once there are some
+		for(unsigned int t = 0; t < TICK_COUNT_MAX && game.getNonGoneCrystalCount() < CRYSTAL_COUNT_MIN; t++)
+		{
+			game.update(DELTA_TIME);
+			game.knockOffCrystals();
+		}
+
+		// the claims only cover the crystals that existed when the
+		//   last update started, so no crystals are added after it
+		game.update(DELTA_TIME);
+		game.updateCrystalGrid();
+		if(game.getNonGoneCrystalCount() == 0)
+		{
+			cerr << "No crystals to search" << endl;
+			return false;
+		}
+
+		vector<unsigned int> v_crystals_near;
+		for(unsigned int i = 0; i < SEARCH_COUNT; i++)
+		{
+			unsigned int non_gone = rand() % game.getNonGoneCrystalCount();
+			const Vector3& crystal_position = game.getCrystal(game.getNonGoneCrystalIndex(non_gone)).getPosition();
+			Vector3 position = randomPosition(crystal_position, CRYSTAL_SEARCH_SPREAD);
+			double max_distance = random0to1() * CRYSTAL_DISTANCE_MAX;
+
+			unsigned int found = game.findNearestUnclaimedCrystal(position, max_distance, v_crystals_near);
+
+			// closest first, and then lowest index
+			unsigned int expected = Spaceship::NO_CRYSTAL;
+			double expected_distance = max_distance;
+			for(unsigned int c = 0; c < game.getTotalCrystalCount(); c++)
+			{
+				if(game.getCrystal(c).isGone() || game.isCrystalClaimed(c))
+					continue;
+				double distance = game.getCrystal(c).getPosition().getDistance(position);
+				if(distance < expected_distance)
+				{
+					expected = c;
+					expected_distance = distance;
+				}
+			}
+
+			if(found != expected)
+			{
+				cerr << "Found crystal " << found << " instead of " << expected << " within "
+				     << max_distance << " of " << position << endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	if(!checkPointGrid())
+		return 1;
+	if(!checkNearestUnclaimedCrystal())
+		return 1;
+
+	cout << "PointGrid check passed" << endl;
+	return 0;
+}
@@ -0,0 +1,217 @@
+//
+//  RenderQueue.cpp
+//
+
+#include "RenderQueue.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <algorithm>  // for stable_sort
+#include <unordered_map>
+
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "GetGlut.h"
+	#include "ObjLibrary/Material.h"
+#endif
+
+#include "ObjLibrary/DisplayList.h"
+
+#include "CoordinateSystem.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+RenderQueue :: RenderQueue ()
+		: mvp_materials()
+		, mv_material_textures()
+		, m_material_indexes()
+		, mv_textures()
+		, mv_items()
+		, mv_order()
+		, m_is_sorted(true)
+{
+	assert(invariant());
+}
+
+
+
+unsigned int RenderQueue :: getGroupCount () const
+{
+	assert(isSorted());
+
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < mv_order.size(); i++)
+	{
+		if(i == 0 || mv_items[mv_order[i]].m_material != mv_items[mv_order[i - 1]].m_material)
+			count++;
+	}
+	return count;
+}
+
+unsigned int RenderQueue :: getSortedItem (unsigned int position) const
+{
+	assert(isSorted());
+	assert(position < getItemCount());
+
+	return mv_order[position];
+}
+
+#ifndef GAME_HEADLESS
+void RenderQueue :: draw () const
+{
+	assert(isSorted());
+	assert(!Material::isMaterialActive());
+
+	unsigned int begin = 0;
+	while(begin < mv_order.size())
+	{
+		unsigned int material = mv_items[mv_order[begin]].m_material;
+		unsigned int end = begin + 1;
+		while(end < mv_order.size() && mv_items[mv_order[end]].m_material == material)
+			end++;
+
+		// same steps as ObjModel::drawMeshMaterial, but once for all the items
+		const Material* p_material = mvp_materials[material];
+		if(p_material == nullptr)
+			drawItems(begin, end);
+		else
+		{
+			p_material->activate();
+			drawItems(begin, end);
+			Material::deactivate();
+
+			if(p_material->isSeperateSpecular())
+			{
+				p_material->activateSeperateSpecular();
+				drawItems(begin, end);
+				Material::deactivate();
+			}
+		}
+
+		begin = end;
+	}
+
+	assert(!Material::isMaterialActive());
+}
+#endif  // GAME_HEADLESS is not defined
+
+
+
+void RenderQueue :: clear ()
+{
+	mv_items.clear();
+	mv_order.clear();
+	m_is_sorted = true;
+
+	assert(invariant());
+}
+
+#ifndef GAME_HEADLESS
+void RenderQueue :: add (const ObjLibrary::Material* p_material,
+                         const ObjLibrary::DisplayList& geometry,
+                         const CoordinateSystem& coords,
+                         double scaling_factor)
+{
+	string texture = "";
+	if(p_material != nullptr && p_material->isDiffuseMap())
+		texture = p_material->getDiffuseMapFilename();
+
+	add(p_material, texture, geometry, coords, scaling_factor);
+}
+#endif  // GAME_HEADLESS is not defined
+
+void RenderQueue :: add (const ObjLibrary::Material* p_material,
+                         const std::string& texture,
+                         const ObjLibrary::DisplayList& geometry,
+                         const CoordinateSystem& coords,
+                         double scaling_factor)
+{
+	assert(p_material != nullptr || texture == "");
+	assert(geometry.isReady());
+	assert(scaling_factor > 0.0);
+
+	Item item;
+	item.m_material       = getMaterialIndex(p_material, texture);
+	item.mp_geometry      = &geometry;
+	item.m_coords         = coords;
+	item.m_scaling_factor = scaling_factor;
+	mv_items.push_back(item);
+	m_is_sorted = false;
+
+	assert(invariant());
+}
+
+void RenderQueue :: sort ()
+{
+	mv_order.resize(mv_items.size());
+	for(unsigned int i = 0; i < mv_items.size(); i++)
+		mv_order[i] = i;
+
+	// stable, so items with the same material stay in the order added
+	stable_sort(mv_order.begin(), mv_order.end(),
+	            [this] (unsigned int a, unsigned int b)
+	{
+		unsigned int material_a = mv_items[a].m_material;
+		unsigned int material_b = mv_items[b].m_material;
+		if(mv_material_textures[material_a] != mv_material_textures[material_b])
+			return mv_material_textures[material_a] < mv_material_textures[material_b];
+		return material_a < material_b;
+	});
+
+	m_is_sorted = true;
+	assert(invariant());
+}
+
+
+
+unsigned int RenderQueue :: getMaterialIndex (const ObjLibrary::Material* p_material,
+                                              const std::string& texture)
+{
+	unordered_map<const Material*, unsigned int>::const_iterator found = m_material_indexes.find(p_material);
+	if(found != m_material_indexes.end())
+		return found->second;
+
+	unsigned int texture_index = find(mv_textures.begin(), mv_textures.end(), texture) - mv_textures.begin();
+	if(texture_index == mv_textures.size())
+		mv_textures.push_back(texture);
+
+	unsigned int index = mvp_materials.size();
+	mvp_materials.push_back(p_material);
+	mv_material_textures.push_back(texture_index);
+	m_material_indexes[p_material] = index;
+
+	assert(invariant());
+	return index;
+}
+
+#ifndef GAME_HEADLESS
+void RenderQueue :: drawItems (unsigned int begin,
+                               unsigned int end) const
+{
+	assert(isSorted());
+	assert(begin <= end);
+	assert(end <= getItemCount());
+
+	for(unsigned int i = begin; i < end; i++)
+	{
+		const Item& item = mv_items[mv_order[i]];
+		glPushMatrix();
+			item.m_coords.applyDrawTransformations();
+			glScaled(item.m_scaling_factor, item.m_scaling_factor, item.m_scaling_factor);
+			item.mp_geometry->draw();
+		glPopMatrix();
+	}
+}
+#endif  // GAME_HEADLESS is not defined
+
+bool RenderQueue :: invariant () const
+{
+	if(mvp_materials.size() != mv_material_textures.size()) return false;
+	if(m_material_indexes.size() != mvp_materials.size()) return false;
+	if(m_is_sorted && mv_order.size() != mv_items.size()) return false;
+	return true;
+}
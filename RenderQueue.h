@@ -0,0 +1,310 @@
+//
+//  RenderQueue.h
+//
+//  A module to draw many models with as few material changes as
+//    possible.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ObjLibrary/DisplayList.h"
+
+#include "CoordinateSystem.h"
+
+namespace ObjLibrary
+{
+	class Material;
+}
+
+
+
+//
+//  RenderQueue
+//
+//  A class to collect things to draw and then draw them sorted
+//    by material.  Each item is a material, a transformation,
+//    and a DisplayList containing only geometry (e.g. from
+//    ObjModel::getDisplayListMeshMaterialNone).  When the queue
+//    is drawn, each material is activated once and every item
+//    using it is drawn before it is deactivated.  Materials that
+//    use the same texture are drawn one after another.
+//
+//  Materials are given indexes when they are first added and
+//    keep them when the queue is cleared, so the sorting keys
+//    do not have to be found again every frame.  Items with the
+//    same material are drawn in the order they were added.
+//
+//  Class Invariant:
+//    <1> mvp_materials.size() == mv_material_textures.size()
+//    <2> m_material_indexes.size() == mvp_materials.size()
+//    <3> !m_is_sorted || mv_order.size() == mv_items.size()
+//
+class RenderQueue
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new RenderQueue is created.  It contains no
+//               items and is sorted.
+//
+	RenderQueue ();
+
+	RenderQueue (const RenderQueue& to_copy) = default;
+	~RenderQueue () = default;
+	RenderQueue& operator= (const RenderQueue& to_copy) = default;
+
+//
+//  getItemCount
+//
+//  Purpose: To determine how many items are in this
+//           RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of items added since this RenderQueue
+//           was last cleared.
+//  Side Effect: N/A
+//
+	unsigned int getItemCount () const
+	{  return mv_items.size();  }
+
+//
+//  getMaterialCount
+//
+//  Purpose: To determine how many different materials have been
+//           added to this RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of different materials added, including
+//           from before this RenderQueue was cleared.  Items
+//           with no material count as one material.
+//  Side Effect: N/A
+//
+	unsigned int getMaterialCount () const
+	{  return mvp_materials.size();  }
+
+//
+//  isSorted
+//
+//  Purpose: To determine whether this RenderQueue can be drawn.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether sort has been called since the last item
+//           was added.
+//  Side Effect: N/A
+//
+	bool isSorted () const
+	{  return m_is_sorted;  }
+
+//
+//  getGroupCount
+//
+//  Purpose: To determine how many times a material will be
+//           activated when this RenderQueue is drawn.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isSorted()
+//  Returns: The number of groups of items with the same
+//           material.
+//  Side Effect: N/A
+//
+	unsigned int getGroupCount () const;
+
+//
+//  getSortedItem
+//
+//  Purpose: To determine which item is drawn at the specified
+//           position in the drawing order.
+//  Parameter(s):
+//    <1> position: The position in the drawing order
+//  Preconditions:
+//    <1> isSorted()
+//    <2> position < getItemCount()
+//  Returns: The index of the item drawn at position position,
+//           counting the items in the order they were added.
+//  Side Effect: N/A
+//
+	unsigned int getSortedItem (unsigned int position) const;
+
+//
+//  clear
+//
+//  Purpose: To remove all items from this RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: All items are removed.  The material indexes
+//               are kept.  This RenderQueue is sorted.
+//
+	void clear ();
+
+#ifndef GAME_HEADLESS
+//
+//  add
+//
+//  Purpose: To add an item to this RenderQueue.
+//  Parameter(s):
+//    <1> p_material: The material to draw with, or nullptr for
+//                    none
+//    <2> geometry: The geometry to draw
+//    <3> coords: The position and orientation to draw at
+//    <4> scaling_factor: The scaling factor for geometry
+//  Preconditions:
+//    <1> geometry.isReady()
+//    <2> scaling_factor > 0.0
+//    <3> geometry is not destroyed before this RenderQueue is
+//        cleared
+//  Returns: N/A
+//  Side Effect: An item is added that draws geometry with
+//               material p_material, transformed by coords and
+//               scaled by scaling_factor.  This RenderQueue is
+//               marked as not sorted.
+//
+	void add (const ObjLibrary::Material* p_material,
+	          const ObjLibrary::DisplayList& geometry,
+	          const CoordinateSystem& coords,
+	          double scaling_factor);
+#endif  // GAME_HEADLESS is not defined
+
+//
+//  add
+//
+//  Purpose: To add an item to this RenderQueue with the
+//           specified texture.  This version never looks inside
+//           the material, so it also works in the headless
+//           build, where there are no Materials.
+//  Parameter(s):
+//    <1> p_material: The material to draw with, or nullptr for
+//                    none
+//    <2> texture: The diffuse map filename for p_material, or
+//                 "" for none
+//    <3> geometry: The geometry to draw
+//    <4> coords: The position and orientation to draw at
+//    <5> scaling_factor: The scaling factor for geometry
+//  Preconditions:
+//    <1> p_material != nullptr || texture == ""
+//    <2> texture is the same every time p_material is added
+//    <3> geometry.isReady()
+//    <4> scaling_factor > 0.0
+//    <5> geometry is not destroyed before this RenderQueue is
+//        cleared
+//  Returns: N/A
+//  Side Effect: An item is added that draws geometry with
+//               material p_material, transformed by coords and
+//               scaled by scaling_factor.  This RenderQueue is
+//               marked as not sorted.
+//
+	void add (const ObjLibrary::Material* p_material,
+	          const std::string& texture,
+	          const ObjLibrary::DisplayList& geometry,
+	          const CoordinateSystem& coords,
+	          double scaling_factor);
+
+//
+//  sort
+//
+//  Purpose: To sort the items in this RenderQueue by texture
+//           and material.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The drawing order is calculated.  This
+//               RenderQueue is marked as sorted.
+//
+	void sort ();
+
+#ifndef GAME_HEADLESS
+//
+//  draw
+//
+//  Purpose: To draw the items in this RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isSorted()
+//    <2> !ObjLibrary::Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: Every item is drawn, with each material
+//               activated once for each group.
+//
+	void draw () const;
+#endif  // GAME_HEADLESS is not defined
+
+private:
+//
+//  getMaterialIndex
+//
+//  Purpose: To determine the index for the specified material,
+//           giving it one if it does not have one yet.
+//  Parameter(s):
+//    <1> p_material: The material, or nullptr for none
+//    <2> texture: The diffuse map filename for p_material
+//  Preconditions: N/A
+//  Returns: The index for p_material.
+//  Side Effect: If p_material has not been added before, it is
+//               given the next material index, sorted with the
+//               other materials using texture texture.
+//
+	unsigned int getMaterialIndex (
+	                      const ObjLibrary::Material* p_material,
+	                      const std::string& texture);
+
+#ifndef GAME_HEADLESS
+//
+//  drawItems
+//
+//  Purpose: To draw the specified range of sorted items with
+//           the current material.
+//  Parameter(s):
+//    <1> begin: The first position in the sorted order
+//    <2> end: The position after the last one to draw
+//  Preconditions:
+//    <1> isSorted()
+//    <2> begin <= end
+//    <3> end <= getItemCount()
+//  Returns: N/A
+//  Side Effect: The items from begin to end in the sorted order
+//               are drawn.
+//
+	void drawItems (unsigned int begin,
+	                unsigned int end) const;
+#endif  // GAME_HEADLESS is not defined
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	struct Item
+	{
+		unsigned int m_material;
+		const ObjLibrary::DisplayList* mp_geometry;
+		CoordinateSystem m_coords;
+		double m_scaling_factor;
+	};
+
+private:
+	// by material index
+	std::vector<const ObjLibrary::Material*> mvp_materials;
+	std::vector<unsigned int> mv_material_textures;  // texture index
+	std::unordered_map<const ObjLibrary::Material*, unsigned int> m_material_indexes;
+	std::vector<std::string> mv_textures;  // diffuse map names
+
+	std::vector<Item> mv_items;  // in the order added
+	std::vector<unsigned int> mv_order;  // item indexes, sorted
+	bool m_is_sorted;
+};
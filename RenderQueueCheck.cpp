@@ -0,0 +1,134 @@
+//
+//  RenderQueueCheck.cpp
+//
+//  A program to check the drawing order and the material
+//    groups of a RenderQueue for a known mix of materials and
+//    textures.  Nothing is drawn, so this runs without OpenGL.
+//
+//  Usage: render_queue_check
+//
+
+#include <string>
+#include <iostream>
+#include <vector>
+
+#include "ObjLibrary/DisplayList.h"
+#include "CoordinateSystem.h"
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+namespace
+{
+	// the materials are never looked inside, so any distinct addresses will do
+	double a_material_standins[4];
+	const Material* const P_ROCK_1 = (const Material*)(&a_material_standins[0]);
+	const Material* const P_METAL  = (const Material*)(&a_material_standins[1]);
+	const Material* const P_ROCK_2 = (const Material*)(&a_material_standins[2]);
+	const Material* const P_PLAIN  = (const Material*)(&a_material_standins[3]);
+	const Material* const P_NONE   = nullptr;
+
+	const string TEXTURE_ROCK  = "rock.bmp";
+	const string TEXTURE_METAL = "metal.bmp";
+	const string TEXTURE_NONE  = "";
+
+	bool checkOrder (const RenderQueue& queue,
+	                 const vector<unsigned int>& v_expected,
+	                 unsigned int expected_groups,
+	                 const string& description)
+	{
+		if(queue.getItemCount() != v_expected.size())
+		{
+			cerr << description << ": " << queue.getItemCount() << " items instead of " << v_expected.size() << endl;
+			return false;
+		}
+		for(unsigned int i = 0; i < v_expected.size(); i++)
+		{
+			if(queue.getSortedItem(i) != v_expected[i])
+			{
+				cerr << description << ": item " << queue.getSortedItem(i) << " is drawn in position " << i
+				     << " instead of item " << v_expected[i] << endl;
+				return false;
+			}
+		}
+		if(queue.getGroupCount() != expected_groups)
+		{
+			cerr << description << ": " << queue.getGroupCount() << " material groups instead of "
+			     << expected_groups << endl;
+			return false;
+		}
+		return true;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	DisplayList geometry;
+	geometry.begin();
+	geometry.end();
+	CoordinateSystem coords;
+
+	RenderQueue queue;
+	queue.sort();
+	if(!checkOrder(queue, vector<unsigned int>(), 0, "Empty queue"))
+		return 1;
+
+	//
+	//  The textures are ordered by when they were first seen
+	//    (metal, rock, none), then the materials are (metal,
+	//    rock 1, none, rock 2, plain), and then the items with
+	//    the same material stay in the order they were added.
+	//
+
+	queue.add(P_METAL,  TEXTURE_METAL, geometry, coords, 1.0);  // 0
+	queue.add(P_ROCK_1, TEXTURE_ROCK,  geometry, coords, 1.0);  // 1
+	queue.add(P_NONE,   TEXTURE_NONE,  geometry, coords, 1.0);  // 2
+	queue.add(P_ROCK_2, TEXTURE_ROCK,  geometry, coords, 1.0);  // 3
+	queue.add(P_METAL,  TEXTURE_METAL, geometry, coords, 1.0);  // 4
+	queue.add(P_PLAIN,  TEXTURE_NONE,  geometry, coords, 1.0);  // 5
+	queue.add(P_ROCK_1, TEXTURE_ROCK,  geometry, coords, 1.0);  // 6
+	queue.add(P_NONE,   TEXTURE_NONE,  geometry, coords, 1.0);  // 7
+	queue.add(P_ROCK_2, TEXTURE_ROCK,  geometry, coords, 1.0);  // 8
+	queue.add(P_METAL,  TEXTURE_METAL, geometry, coords, 1.0);  // 9
+	if(queue.isSorted())
+	{
+		cerr << "Queue is sorted after adding items" << endl;
+		return 1;
+	}
+	queue.sort();
+
+	const unsigned int A_FIRST_ORDER[] = { 0, 4, 9,  1, 6,  3, 8,  2, 7,  5 };
+	vector<unsigned int> v_first_order(A_FIRST_ORDER, A_FIRST_ORDER + sizeof(A_FIRST_ORDER) / sizeof(A_FIRST_ORDER[0]));
+	if(!checkOrder(queue, v_first_order, 5, "First frame"))
+		return 1;
+	if(queue.getMaterialCount() != 5)
+	{
+		cerr << "First frame: " << queue.getMaterialCount() << " materials instead of 5" << endl;
+		return 1;
+	}
+
+	// the materials keep their order after clearing
+	queue.clear();
+	queue.add(P_PLAIN,  TEXTURE_NONE,  geometry, coords, 1.0);  // 0
+	queue.add(P_ROCK_1, TEXTURE_ROCK,  geometry, coords, 1.0);  // 1
+	queue.add(P_NONE,   TEXTURE_NONE,  geometry, coords, 1.0);  // 2
+	queue.add(P_METAL,  TEXTURE_METAL, geometry, coords, 1.0);  // 3
+	queue.sort();
+
+	const unsigned int A_SECOND_ORDER[] = { 3, 1, 2, 0 };
+	vector<unsigned int> v_second_order(A_SECOND_ORDER, A_SECOND_ORDER + sizeof(A_SECOND_ORDER) / sizeof(A_SECOND_ORDER[0]));
+	if(!checkOrder(queue, v_second_order, 4, "Second frame"))
+		return 1;
+	if(queue.getMaterialCount() != 5)
+	{
+		cerr << "Second frame: " << queue.getMaterialCount() << " materials instead of 5" << endl;
+		return 1;
+	}
+
+	cout << "RenderQueue check passed" << endl;
+	return 0;
+}
@@ -9,8 +9,13 @@
 #include <cassert>
 #include <climits>
 #include <cmath>
+#include <vector>
+
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "DebugDraw.h"
+#endif
 
-#include "GetGlut.h"
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
@@ -18,12 +23,12 @@
 #include "SteeringBehaviours.h"
 #include "Game.h"
 #include "Entity.h"
+#include "PathPrediction.h"
 
+using namespace std;
 using namespace ObjLibrary;
 namespace
 {
-	const double FAR_AWAY = 1.0e6;
-
 	const double INTERCEPT_SPEED = 100.0;
 }
 
@@ -40,6 +45,9 @@ Spaceship :: Spaceship ()
 		, m_rotation_rate_radians(1.0)
 		, m_escort_offset(Vector3(1.0, 0.0, 0.0))
 		, m_crystal_chased_index(NO_CRYSTAL)
+		, mv_asteroids_to_avoid()
+		, m_path()
+		, m_path_time(0.0)
 {
 	assert(!isInitialized());
 	assert(invariant());
@@ -61,6 +69,9 @@ Spaceship :: Spaceship (const ObjLibrary::Vector3& position,
 		, m_rotation_rate_radians(rotation_rate_radians)
 		, m_escort_offset(escort_offset)
 		, m_crystal_chased_index(NO_CRYSTAL)
+		, mv_asteroids_to_avoid()
+		, m_path()
+		, m_path_time(0.0)
 {
 	assert(mass                   >  0.0);
 	assert(radius                 >= 0.0);
@@ -80,74 +91,89 @@ Vector3 Spaceship :: getFollowCameraPosition (double back_distance,
 {
 	assert(isInitialized());
 
-	CoordinateSystem camera = m_coords;
+	CoordinateSystem camera = getCoordinateSystem();
 	camera.addPosition(camera.getForward() * -back_distance);
 	camera.addPosition(camera.getUp()      *  up_distance);
 	return camera.getPosition();
 }
 
+#ifndef GAME_HEADLESS
 void Spaceship :: setupFollowCamera (double back_distance,
                                      double up_distance) const
 {
 	assert(isInitialized());
 
-	CoordinateSystem camera = m_coords;
+	CoordinateSystem camera = getCoordinateSystem();
 	camera.addPosition(camera.getForward() * -back_distance);
 	camera.addPosition(camera.getUp() * up_distance);
 	camera.setupCamera();
 }
 
-void Spaceship :: drawPath (const Entity& black_hole,
-                            unsigned int point_count,
+void Spaceship :: drawPath (DebugDraw& r_debug_draw,
+                            const Entity& black_hole,
+                            double game_time,
                             const ObjLibrary::Vector3& colour) const
 {
 	assert(isInitialized());
+	assert(game_time >= m_path_time);
 
-	Spaceship future = *this;
+	updatePath(black_hole, game_time);
 
-	glBegin(GL_LINE_STRIP);
-		glColor3d(colour.x, colour.y, colour.z);
-		glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
+	// sample 0 is at or before now, so start from the current position instead
+	unsigned int point_count = m_path.getSampleCount();
 
-		for(unsigned int i = 1; i < point_count; i++)
-		{
-			double distance   = black_hole.getPosition().getDistance(future.getPosition());
-			double delta_time = sqrt(distance) / 25.0;
+	Vector3 previous_position = getPosition();
+	Vector3 previous_colour   = colour;
+	for(unsigned int i = 1; i < point_count; i++)
+	{
+		const Vector3& position = m_path.getSamplePosition(i);
 
-			future.updatePhysics(delta_time, black_hole);
+		double fraction = sqrt(1.0 - (double)(i) / point_count);
+		Vector3 current_colour = colour * fraction;
+		r_debug_draw.addLine(previous_position, previous_colour, position, current_colour);
 
-			double fraction = sqrt(1.0 - (double)(i) / point_count);
-			glColor3d(colour.x * fraction, colour.y * fraction, colour.z * fraction);
-			glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
-		}
-	glEnd();
+		previous_position = position;
+		previous_colour   = current_colour;
+	}
 }
 
-void Spaceship :: drawAI (const Game& game,
+void Spaceship :: drawAI (DebugDraw& r_debug_draw,
+                          const Game& game,
                           const ObjLibrary::Vector3& colour) const
 {
 	// draw avoiding asteroid (if applicable)
-	for(unsigned int a = 0; a < game.getAsteroidCount(); a++)
-		if(SteeringBehaviours::isAvoid(*this, game.getAsteroid(a), m_acceleration_manoeuver))
-		{
-			SteeringBehaviours::drawAvoid(*this, game.getAsteroid(a), m_acceleration_manoeuver, colour);
-			return;  // don't draw anything else
-		}
+	vector<unsigned int> v_asteroids_to_avoid;
+	game.findAsteroidsToAvoid(*this, m_acceleration_manoeuver, v_asteroids_to_avoid);
+	if(!v_asteroids_to_avoid.empty())
+	{
+		SteeringBehaviours::drawAvoid(r_debug_draw, *this, game.getAsteroid(v_asteroids_to_avoid[0]), m_acceleration_manoeuver, colour);
+		return;  // don't draw anything else
+	}
 
 	if(m_crystal_chased_index < game.getTotalCrystalCount())
 	{
 		const Crystal& crystal = game.getCrystal(m_crystal_chased_index);
-		SteeringBehaviours::drawPursue(*this, crystal, INTERCEPT_SPEED, m_acceleration_manoeuver, colour);
+		SteeringBehaviours::drawPursue(r_debug_draw, *this, crystal, INTERCEPT_SPEED, m_acceleration_manoeuver, colour);
 	}
 	else
-		SteeringBehaviours::drawEscort(*this, game.getPlayer(), m_escort_offset, m_acceleration_manoeuver, colour);
+		SteeringBehaviours::drawEscort(r_debug_draw, *this, game.getPlayer(), m_escort_offset, m_acceleration_manoeuver, colour);
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
+void Spaceship :: setPathPointCount (unsigned int point_count)
+{
+	m_path = PathPrediction(point_count);
+
+	assert(invariant());
+}
+
 void Spaceship :: markDead ()
 {
 	m_is_alive = false;
+	if(isInBodies())
+		setBodyActive(false);  // the wreck stays where it is
 
 	assert(invariant());
 }
@@ -157,8 +183,9 @@ void Spaceship :: thrustMainEngine (double delta_time)
 	assert(isInitialized());
 	assert(delta_time >= 0.0);
 
-	assert(m_coords.getForward().isUnit());
-	m_velocity += m_coords.getForward() * m_acceleration_main * delta_time;
+	assert(getForward().isUnit());
+	addVelocity(getForward() * m_acceleration_main * delta_time);
+	m_path.invalidate();
 
 	assert(invariant());
 }
@@ -174,7 +201,9 @@ void Spaceship :: thrustManoeuver (double delta_time,
 	assert(strength_fraction <= 1.0);
 
 	double delta_velocity = m_acceleration_manoeuver * delta_time * strength_fraction;
-	m_velocity += direction_world * delta_velocity;
+	addVelocity(direction_world * delta_velocity);
+	if(delta_velocity != 0.0)
+		m_path.invalidate();
 
 	assert(invariant());
 }
@@ -185,10 +214,12 @@ void Spaceship :: rotateAroundForward (double delta_time,
 	assert(delta_time >= 0.0);
 
 	double max_radians = m_rotation_rate_radians * delta_time;
+	CoordinateSystem coords = getCoordinateSystem();
 	if(is_backwards)
-		m_coords.rotateAroundForward(-max_radians);
+		coords.rotateAroundForward(-max_radians);
 	else
-		m_coords.rotateAroundForward(max_radians);
+		coords.rotateAroundForward(max_radians);
+	setOrientation(coords);
 
 	assert(invariant());
 }
@@ -199,10 +230,12 @@ void Spaceship :: rotateAroundUp (double delta_time,
 	assert(delta_time >= 0.0);
 
 	double max_radians = m_rotation_rate_radians * delta_time;
+	CoordinateSystem coords = getCoordinateSystem();
 	if(is_backwards)
-		m_coords.rotateAroundUp(-max_radians);
+		coords.rotateAroundUp(-max_radians);
 	else
-		m_coords.rotateAroundUp(max_radians);
+		coords.rotateAroundUp(max_radians);
+	setOrientation(coords);
 
 	assert(invariant());
 }
@@ -213,20 +246,53 @@ void Spaceship :: rotateAroundRight (double delta_time,
 	assert(delta_time >= 0.0);
 
 	double max_radians = m_rotation_rate_radians * delta_time;
+	CoordinateSystem coords = getCoordinateSystem();
 	if(is_backwards)
-		m_coords.rotateAroundRight(-max_radians);
+		coords.rotateAroundRight(-max_radians);
 	else
-		m_coords.rotateAroundRight(max_radians);
+		coords.rotateAroundRight(max_radians);
+	setOrientation(coords);
 
 	assert(invariant());
 }
 
-void Spaceship :: updateAI (double delta_time,
-                            Game& game)
+void Spaceship :: abandonGoneCrystal (const Game& game)
+{
+	if(m_crystal_chased_index < game.getTotalCrystalCount())
+	{
+		if(game.getCrystal(m_crystal_chased_index).isGone())
+			m_crystal_chased_index = NO_CRYSTAL;
+	}
+	else
+		m_crystal_chased_index = NO_CRYSTAL;
+
+	assert(invariant());
+}
+
+unsigned int Spaceship :: findCrystalToChase (const Game& game,
+                                              std::vector<unsigned int>& r_crystals_near) const
+{
+	static const double DETECT_CRYSTALS_DISTANCE = 1000.0;
+
+	assert(isInitialized());
+
+	if(m_crystal_chased_index != NO_CRYSTAL)
+		return NO_CRYSTAL;
+	return game.findNearestUnclaimedCrystal(getPosition(), DETECT_CRYSTALS_DISTANCE, r_crystals_near);
+}
+
+void Spaceship :: chaseCrystal (unsigned int index)
+{
+	m_crystal_chased_index = index;
+
+	assert(invariant());
+}
+
+void Spaceship :: updateSteering (double delta_time,
+                                  const Game& game)
 {
 	assert(delta_time > 0.0);
 
-	updateCrystalChased(game);
 	Vector3 desired = calculateDesiredVelocity(delta_time, game);
 	flyToMatchVelocity(delta_time, desired);
 
@@ -235,53 +301,30 @@ void Spaceship :: updateAI (double delta_time,
 
 
 
-void Spaceship :: updateCrystalChased (Game& game)
+#ifndef GAME_HEADLESS
+void Spaceship :: updatePath (const Entity& black_hole,
+                              double game_time) const
 {
-	static const double DETECT_CRYSTALS_DISTANCE = 1000.0;
-
-	// abandon current a crystal if it is gone
-	if(m_crystal_chased_index < game.getTotalCrystalCount())
-	{
-		if(game.getCrystal(m_crystal_chased_index).isGone())
-			m_crystal_chased_index = NO_CRYSTAL;
-	}
-	else
-		m_crystal_chased_index = NO_CRYSTAL;
+	assert(isInitialized());
+	assert(game_time >= m_path_time);
 
-	// choose a crystal if possible
-	if(m_crystal_chased_index == NO_CRYSTAL)
-	{
-		unsigned int closest_index    = NO_CRYSTAL;
-		double       closest_distance = FAR_AWAY;
-
-		for(unsigned int c = 0; c < game.getTotalCrystalCount(); c++)
-		{
-			const Crystal& crystal = game.getCrystal(c);
-			if(!crystal.isGone())
-				if(!game.isCrystalChased(c))
-				{
-					double distance = crystal.getPosition().getDistance(getPosition());
-					if(distance < DETECT_CRYSTALS_DISTANCE &&
-					   distance < closest_distance)
-					{
-						closest_index    = c;
-						closest_distance = distance;
-					}
-				}
-		}
-
-		if(closest_index != NO_CRYSTAL)
-			m_crystal_chased_index = closest_index;
-	}
+	m_path.update(game_time - m_path_time, getPosition(), getVelocity(),
+	              black_hole.getPosition(), black_hole.getMass());
+	m_path_time = game_time;
 }
+#endif  // GAME_HEADLESS is not defined
 
 ObjLibrary::Vector3 Spaceship :: calculateDesiredVelocity (double delta_time,
-                                                           Game& game)
+                                                           const Game& game)
 {
+	// avoid the asteroid we will be closest to first
 	double avoid_delta_speed = m_acceleration_manoeuver * delta_time;
-	for(unsigned int a = 0; a < game.getAsteroidCount(); a++)
-		if(SteeringBehaviours::isAvoid(*this, game.getAsteroid(a), m_acceleration_manoeuver))
-			return SteeringBehaviours::avoid(*this, game.getAsteroid(a), m_acceleration_manoeuver, avoid_delta_speed);
+	game.findAsteroidsToAvoid(*this, m_acceleration_manoeuver, mv_asteroids_to_avoid);
+	if(!mv_asteroids_to_avoid.empty())
+	{
+		const Asteroid& asteroid = game.getAsteroid(mv_asteroids_to_avoid[0]);
+		return SteeringBehaviours::avoid(*this, asteroid, m_acceleration_manoeuver, avoid_delta_speed);
+	}
 
 	// not avoiding anything
 	if(m_crystal_chased_index < game.getTotalCrystalCount())
@@ -320,11 +363,13 @@ void Spaceship :: flyToMatchVelocity (double delta_time,
 
 		thrustManoeuver(delta_time, relative.getNormalized(), fraction);
 	}
-	else if(relative.getAngleSafe(m_coords.getForward()) > MAIN_ENGINE_MIN_RADIANS)
+	else if(relative.getAngleSafe(getForward()) > MAIN_ENGINE_MIN_RADIANS)
 	{
 		// rotate to line up main engines
 		double max_radians = m_rotation_rate_radians * delta_time;
-		m_coords.rotateToVector(relative, max_radians);
+		CoordinateSystem coords = getCoordinateSystem();
+		coords.rotateToVector(relative, max_radians);
+		setOrientation(coords);
 	}
 	else
 	{
@@ -8,14 +8,18 @@
 
 #include <cassert>
 #include <climits>
+#include <vector>
 
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/DisplayList.h"
 
+#include "GameSettings.h"
 #include "CoordinateSystem.h"
 #include "Entity.h"
+#include "PathPrediction.h"
 
 class Game;
+class DebugDraw;
 
 
 
@@ -23,7 +27,10 @@ class Game;
 //  Spaceship
 //
 //  A class to represent a spaceship.  This can be the player
-//    ship or a drone.
+//    ship or a drone.  The drones are kept in a PhysicsBodies
+//    (see Entity::moveIntoBodies), so a Spaceship only changes
+//    its position, velocity, and orientation through the
+//    functions in Entity.
 //
 //  Class Invariant:
 //    <1> m_acceleration_main      > 0.0
@@ -135,6 +142,22 @@ public:
 		return m_crystal_chased_index;
 	}
 
+//
+//  getPath
+//
+//  Purpose: To retrieve the predicted path for this Spaceship.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The path this Spaceship is predicted to follow if
+//           it does not fire its engines.  This is only updated
+//           when the path is drawn, so it may be out of date.
+//  Side Effect: N/A
+//
+	const PathPrediction& getPath () const
+	{
+		return m_path;
+	}
+
 //
 //  getFollowCameraPosition
 //
@@ -155,6 +178,7 @@ public:
 	                                  double back_distance,
 	                                  double up_distance) const;
 
+#ifndef GAME_HEADLESS
 //
 //  setupFollowCamera
 //
@@ -179,22 +203,28 @@ public:
 //  drawPath
 //
 //  Purpose: To display the path that this Spaceship will follow
-//           if it is only affected by gravity from the
-//           specified black hole.
+//           if it is only affected by gravity from the black
+//           hole.
 //  Parameter(s):
-//    <1> black_hole: The black hole
-//    <2> point_count: How many points ahead to display
-//    <3> colour: How colour of the path
+//    <1> r_debug_draw: The DebugDraw to add the path to
+//    <2> black_hole: The black hole
+//    <3> game_time: The current game time
+//    <4> colour: How colour of the path
 //  Preconditions:
 //    <1> isInitialized()
+//    <2> game_time is not before the last time the path was
+//        drawn
 //  Returns: N/A
-//  Side Effect: A path of point_count vertexes is displayed for
-//               this Spaceship is displayed.  It will start
-//               with a colour of colour and then fade to black
-//               at the end.
-//
-	void drawPath (const Entity& black_hole,
-	               unsigned int point_count,
+//  Side Effect: The predicted path for this Spaceship is
+//               updated for the time since it was last
+//               drawn.  Lines for it are then added to
+//               r_debug_draw, starting at its current position.
+//               They start with a colour of colour and then
+//               fade to black at the end.
+//
+	void drawPath (DebugDraw& r_debug_draw,
+	               const Entity& black_hole,
+	               double game_time,
 	               const ObjLibrary::Vector3& colour) const;
 
 //
@@ -202,18 +232,39 @@ public:
 //
 //  Purpose: To display the current AI state for this spaceship.
 //  Parameter(s):
-//    <1> game: The state of the game
-//    <2> colour: The colour for the AI information
+//    <1> r_debug_draw: The DebugDraw to add the markers to
+//    <2> game: The state of the game
+//    <3> colour: The colour for the AI information
 //  Preconditions:
 //    <1> isInitialized()
 //  Returns: N/A
 //  Side Effect: If this Spaceship is chasing a crystal, that
 //               crystal is marked in colour colour.  If it is
 //               escorting the player, it's escort position is
-//               marked in colour colour.
+//               marked in colour colour.  The markers are added
+//               to r_debug_draw.
 //
-	void drawAI (const Game& game,
+	void drawAI (DebugDraw& r_debug_draw,
+	             const Game& game,
 	             const ObjLibrary::Vector3& colour) const;
+#endif  // GAME_HEADLESS is not defined
+
+//
+//  setPathPointCount
+//
+//  Purpose: To change how far ahead the path of this Spaceship
+//           is predicted.
+//  Parameter(s):
+//    <1> point_count: How many points to predict, including the
+//                     current position
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The predicted path is replaced with one with
+//               point_count points.  It will be calculated the
+//               next time it is drawn.  If point_count is 0, no
+//               path is predicted.
+//
+	void setPathPointCount (unsigned int point_count);
 
 //
 //  markDead
@@ -224,7 +275,9 @@ public:
 //  Preconditions:
 //    <1> isInitialized()
 //  Returns: N/A
-//  Side Effect: This Spaceship is marked as dead.
+//  Side Effect: This Spaceship is marked as dead.  If it is in
+//               a PhysicsBodies, its body is marked inactive,
+//               so the wreck is no longer moved.
 //
 	void markDead ();
 
@@ -239,7 +292,8 @@ public:
 //    <1> isInitialized()
 //    <2> delta_time >= 0.0
 //  Returns: N/A
-//  Side Effect: This spaceship accelerates forward.
+//  Side Effect: This spaceship accelerates forward.  The
+//               predicted path will be calculated again.
 //
 	void thrustMainEngine (double delta_time);
 
@@ -263,7 +317,8 @@ public:
 //  Returns: N/A
 //  Side Effect: This spaceship accelerates in direction
 //               direction_world at strength_fraction of maximum
-//               maneouvering power.
+//               maneouvering power.  If it accelerates at all,
+//               the predicted path will be calculated again.
 //
 	void thrustManoeuver (
 	                 double delta_time,
@@ -293,36 +348,91 @@ public:
 	                        bool is_backwards);
 
 //
-//  updateAI
+//  abandonGoneCrystal
+//
+//  Purpose: To stop chasing the current crystal if it is gone.
+//  Parameter(s):
+//    <1> game: The state of the game
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: If the crystal chased is gone or does not exist
+//               in game, the crystal chased is set to
+//               NO_CRYSTAL.
+//
+	void abandonGoneCrystal (const Game& game);
+
+//
+//  findCrystalToChase
 //
-//  Purpose: To perform the AI updates for this Entity for one
-//           time step.
+//  Purpose: To determine which crystal this Spaceship would
+//           like to start chasing.
+//  Parameter(s):
+//    <1> game: The state of the game
+//    <2> r_crystals_near: A vector to use while searching
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The index of the nearest crystal in detection range
+//           that is not claimed in game.  If this Spaceship is
+//           already chasing a crystal, or there is no such
+//           crystal, NO_CRYSTAL is returned.
+//  Side Effect: The contents of r_crystals_near are replaced.
+//
+	unsigned int findCrystalToChase (
+	                    const Game& game,
+	                    std::vector<unsigned int>& r_crystals_near) const;
+
+//
+//  chaseCrystal
+//
+//  Purpose: To start chasing the specified crystal.
+//  Parameter(s):
+//    <1> index: The index of the crystal
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This Spaceship chases crystal index.
+//
+	void chaseCrystal (unsigned int index);
+
+//
+//  updateSteering
+//
+//  Purpose: To fire the engines of this Spaceship as decided by
+//           its AI for one time step.
 //  Parameter(s):
 //    <1> delta_time: The length of the time step in seconds
 //    <2> game: The state of the game
 //  Preconditions:
 //    <1> delta_time > 0.0
 //  Returns: N/A
-//  Side Effect: The AI for this Spaceship runs for one time
-//               step.
+//  Side Effect: This Spaceship avoids an asteroid, chases its
+//               crystal, or escorts the player.  Only this
+//               Spaceship is changed, so different Spaceships
+//               can be updated at the same time.
 //
-	void updateAI (double delta_time,
-	               Game& game);
+	void updateSteering (double delta_time,
+	                     const Game& game);
 
 private:
+#ifndef GAME_HEADLESS
 //
-//  updateCrystalChased
+//  updatePath
 //
-//  Purpose: To determine which crystal should be chased.
+//  Purpose: To bring the predicted path for this Spaceship up
+//           to date.
 //  Parameter(s):
-//    <1> game: The state of the game
-//  Preconditions: N/A
+//    <1> black_hole: The black hole
+//    <2> game_time: The current game time
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> game_time >= m_path_time
 //  Returns: N/A
-//  Side Effect: The crystal chased is updated.  If this drone
-//               should not chase a crystal, the value is set to
-//               NO_CRYSTAL.
+//  Side Effect: The predicted path is moved forward to time
+//               game_time.  Samples are only calculated if they
+//               are needed.
 //
-	void updateCrystalChased (Game& game);
+	void updatePath (const Entity& black_hole,
+	                 double game_time) const;
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  calculateDesiredVelocity
@@ -342,7 +452,7 @@ private:
 //
 	ObjLibrary::Vector3 calculateDesiredVelocity (
 	                                          double delta_time,
-	                                          Game& game);
+	                                          const Game& game);
 
 //
 //  flyToMatchVelocity
@@ -386,6 +496,11 @@ private:
 	// for AI
 	ObjLibrary::Vector3 m_escort_offset;
 	unsigned int m_crystal_chased_index;
+	std::vector<unsigned int> mv_asteroids_to_avoid;  // kept to reuse memory
+
+	// only updated when needed, which is when drawing
+	mutable PathPrediction m_path;
+	mutable double m_path_time;  // game time when m_path was last updated
 };
 
 
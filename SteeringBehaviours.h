@@ -8,8 +8,11 @@
 
 #include "ObjLibrary/Vector3.h"
 
+#include "GameSettings.h"
+
 class Entity;
 class Spaceship;
+class DebugDraw;
 
 
 
@@ -64,11 +67,14 @@ namespace SteeringBehaviours
 	                            double max_speed_at_impact,
 	                            double max_acceleration);
 
-	void drawPursue (const Spaceship& agent,
+#ifndef GAME_HEADLESS
+	void drawPursue (DebugDraw& r_debug_draw,
+	                 const Spaceship& agent,
 	                 const Entity& target,
 	                 double max_speed_at_impact,
 	                 double max_acceleration,
 	                 const ObjLibrary::Vector3& colour);
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  escort
@@ -91,11 +97,14 @@ namespace SteeringBehaviours
 	                          const ObjLibrary::Vector3& offset,
 	                          double max_acceleration);
 
-	void drawEscort (const Spaceship& agent,
+#ifndef GAME_HEADLESS
+	void drawEscort (DebugDraw& r_debug_draw,
+	                 const Spaceship& agent,
 	                 const Entity& target,
 	                 const ObjLibrary::Vector3& offset,
 	                 double max_acceleration,
 	                 const ObjLibrary::Vector3& colour);
+#endif  // GAME_HEADLESS is not defined
 
 //
 //  getAvoidDistance
@@ -117,6 +126,32 @@ namespace SteeringBehaviours
 	                         const Entity& target,
 	                         double max_acceleration);
 
+//
+//  getAvoidDistanceMax
+//
+//  Purpose: To determine the largest avoid distance that the
+//           specified Spaceship could have for any of a group
+//           of Entities.
+//  Parameter(s):
+//    <1> agent: The spaceship to control
+//    <2> target_radius_max: The largest radius of any target
+//    <3> target_speed_max: The largest speed of any target
+//    <4> max_acceleration: The maximum spaceship accleration
+//  Preconditions:
+//    <1> target_radius_max >= 0.0
+//    <2> target_speed_max >= 0.0
+//    <3> max_acceleration > 0.0
+//  Returns: A distance at least as large as getAvoidDistance
+//           for any target with a radius of at most
+//           target_radius_max and a speed of at most
+//           target_speed_max.
+//  Side Effect: N/A
+//
+	double getAvoidDistanceMax (const Spaceship& agent,
+	                            double target_radius_max,
+	                            double target_speed_max,
+	                            double max_acceleration);
+
 	bool isAvoid (const Spaceship& agent,
 	              const Entity& target,
 	              double max_acceleration);
@@ -143,9 +178,30 @@ namespace SteeringBehaviours
 	                           double max_acceleration,
 	                           double max_delta_speed);
 
-	void drawAvoid (const Spaceship& agent,
+//
+//  getClosestApproachTime
+//
+//  Purpose: To determine when the specified Spaceship will be
+//           closest to the specified Entity.
+//  Parameter(s):
+//    <1> agent: The spaceship
+//    <2> target: The target
+//  Preconditions: N/A
+//  Returns: How long until agent and target are closest,
+//           assuming they both move in straight lines.  If
+//           they are moving apart or are not moving relative to
+//           each other, 0.0 is returned.
+//  Side Effect: N/A
+//
+	double getClosestApproachTime (const Spaceship& agent,
+	                               const Entity& target);
+
+#ifndef GAME_HEADLESS
+	void drawAvoid (DebugDraw& r_debug_draw,
+	                const Spaceship& agent,
 	                const Entity& target,
 	                double max_acceleration,
 	                const ObjLibrary::Vector3& colour);
+#endif  // GAME_HEADLESS is not defined
 
 }  // end of namespace SteeringBehaviours
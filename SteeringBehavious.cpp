@@ -11,7 +11,11 @@
 #include <cassert>
 #include <cmath>
 
-#include "GetGlut.h"
+#include "GameSettings.h"
+#ifndef GAME_HEADLESS
+	#include "DebugDraw.h"
+#endif
+
 #include "ObjLibrary/Vector3.h"
 
 #include "CoordinateSystem.h"
@@ -24,15 +28,11 @@ namespace
 	const double AS_FAST_AS_POSSIBLE = 1.0e10;
 
 	const double AHEAD_TIME_FACTOR = 1.0;  // 0.5;
+	const double AVOID_TIME_FACTOR = 10.0;
 
-	void drawMarker (const Vector3& position)
-	{
-		glPushMatrix();
-			glTranslated(position.x, position.y, position.z);
-			glScaled(3.0, 3.0, 3.0);
-			glutWireOctahedron();
-		glPopMatrix();
-	}
+#ifndef GAME_HEADLESS
+	const double MARKER_SIZE = 3.0;
+#endif  // GAME_HEADLESS is not defined
 }
 
 
@@ -143,7 +143,9 @@ ObjLibrary::Vector3 SteeringBehaviours :: pursue (const Spaceship& agent,
 	               max_speed_at_impact, max_acceleration);
 }
 
-void SteeringBehaviours :: drawPursue (const Spaceship& agent,
+#ifndef GAME_HEADLESS
+void SteeringBehaviours :: drawPursue (DebugDraw& r_debug_draw,
+                                       const Spaceship& agent,
                                        const Entity& target,
                                        double max_speed_at_impact,
                                        double max_acceleration,
@@ -158,10 +160,10 @@ void SteeringBehaviours :: drawPursue (const Spaceship& agent,
 	Vector3 target_ahead_position = target.getPosition() + target.getVelocity() * ahead_time;
 
 	// draw positions
-	glColor3d(colour.x, colour.y, colour.z);
-	drawMarker(target.getPosition());
-	drawMarker(target_ahead_position);
+	r_debug_draw.addWireMarker(target.getPosition(), MARKER_SIZE, colour);
+	r_debug_draw.addWireMarker(target_ahead_position, MARKER_SIZE, colour);
 }
+#endif  // GAME_HEADLESS is not defined
 
 ObjLibrary::Vector3 SteeringBehaviours :: escort (const Spaceship& agent,
                                                   const Entity& target,
@@ -184,7 +186,9 @@ ObjLibrary::Vector3 SteeringBehaviours :: escort (const Spaceship& agent,
 	               0.0, max_acceleration);
 }
 
-void SteeringBehaviours :: drawEscort (const Spaceship& agent,
+#ifndef GAME_HEADLESS
+void SteeringBehaviours :: drawEscort (DebugDraw& r_debug_draw,
+                                       const Spaceship& agent,
                                        const Entity& target,
                                        const ObjLibrary::Vector3& offset,
                                        double max_acceleration,
@@ -203,10 +207,10 @@ void SteeringBehaviours :: drawEscort (const Spaceship& agent,
 	Vector3 escort_ahead_position = escort_position + target.getVelocity() * ahead_time;
 
 	// draw positions
-	glColor3d(colour.x, colour.y, colour.z);
-	drawMarker(escort_position);
-	drawMarker(escort_ahead_position);
+	r_debug_draw.addWireMarker(escort_position, MARKER_SIZE, colour);
+	r_debug_draw.addWireMarker(escort_ahead_position, MARKER_SIZE, colour);
 }
+#endif  // GAME_HEADLESS is not defined
 
 
 
@@ -217,7 +221,21 @@ double SteeringBehaviours :: getAvoidDistance (const Spaceship& agent,
 	assert(max_acceleration > 0.0);
 
 	Vector3 relative_velocity = target.getVelocity() - agent.getVelocity();
-	return target.getRadius() + (relative_velocity.getNorm() / max_acceleration) * 10.0;
+	return target.getRadius() + (relative_velocity.getNorm() / max_acceleration) * AVOID_TIME_FACTOR;
+}
+
+double SteeringBehaviours :: getAvoidDistanceMax (const Spaceship& agent,
+                                                  double target_radius_max,
+                                                  double target_speed_max,
+                                                  double max_acceleration)
+{
+	assert(target_radius_max >= 0.0);
+	assert(target_speed_max >= 0.0);
+	assert(max_acceleration > 0.0);
+
+	// the relative speed is at most the sum of the speeds
+	double relative_speed_max = agent.getVelocity().getNorm() + target_speed_max;
+	return target_radius_max + (relative_speed_max / max_acceleration) * AVOID_TIME_FACTOR;
 }
 
 bool SteeringBehaviours :: isAvoid (const Spaceship& agent,
@@ -252,7 +270,25 @@ ObjLibrary::Vector3 SteeringBehaviours :: avoid (const Spaceship& agent,
 	return agent.getVelocity() + away_from_target.getCopyWithNormSafe(max_delta_speed);
 }
 
-void SteeringBehaviours :: drawAvoid (const Spaceship& agent,
+double SteeringBehaviours :: getClosestApproachTime (const Spaceship& agent,
+                                                     const Entity& target)
+{
+	Vector3 relative_position = target.getPosition() - agent.getPosition();
+	Vector3 relative_velocity = target.getVelocity() - agent.getVelocity();
+
+	double speed_squared = relative_velocity.getNormSquared();
+	if(speed_squared == 0.0)
+		return 0.0;  // always the same distance apart
+
+	double time = -relative_position.dotProduct(relative_velocity) / speed_squared;
+	if(time < 0.0)
+		return 0.0;  // moving apart
+	return time;
+}
+
+#ifndef GAME_HEADLESS
+void SteeringBehaviours :: drawAvoid (DebugDraw& r_debug_draw,
+                                      const Spaceship& agent,
                                       const Entity& target,
                                       double max_acceleration,
                                       const ObjLibrary::Vector3& colour)
@@ -264,10 +300,7 @@ void SteeringBehaviours :: drawAvoid (const Spaceship& agent,
 	double avoid_distance     = SteeringBehaviours::getAvoidDistance(agent, target, max_acceleration);
 	assert(distance_to_center < avoid_distance);
 
-	glPushMatrix();
-		glTranslated(target.getPosition().x, target.getPosition().y, target.getPosition().z);
-		glColor3d(colour.x, colour.y, colour.z);
-		glutWireSphere(avoid_distance, 20, 15);
-	glPopMatrix();
+	r_debug_draw.addWireSphere(target.getPosition(), avoid_distance, colour);
 }
+#endif  // GAME_HEADLESS is not defined
 
@@ -0,0 +1,171 @@
+//
+//  WorkerPool.cpp
+//
+
+#include "WorkerPool.h"
+
+#include <cassert>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+
+
+WorkerPool :: WorkerPool (unsigned int thread_count)
+		: m_thread_count(thread_count)
+		, mv_threads()
+		, m_mutex()
+		, m_work_ready()
+		, m_work_done()
+		, mp_work(nullptr)
+		, m_item_count(0)
+		, m_block_count(0)
+		, m_blocks_remaining(0)
+		, m_generation(0)
+		, m_is_stopping(false)
+{
+	assert(thread_count >= 1);
+
+	startThreads();
+
+	assert(invariant());
+}
+
+WorkerPool :: ~WorkerPool ()
+{
+	stopThreads();
+}
+
+
+
+void WorkerPool :: setThreadCount (unsigned int thread_count)
+{
+	assert(thread_count >= 1);
+
+	if(thread_count == m_thread_count)
+		return;
+
+	stopThreads();
+	m_thread_count = thread_count;
+	startThreads();
+
+	assert(invariant());
+}
+
+void WorkerPool :: run (unsigned int item_count,
+                        unsigned int min_items_per_thread,
+                        const Work& work)
+{
+	assert(min_items_per_thread >= 1);
+
+	unsigned int block_count = item_count / min_items_per_thread;
+	if(block_count > m_thread_count)
+		block_count = m_thread_count;
+
+	if(block_count <= 1)
+	{
+		// not worth waking the other threads
+		if(item_count > 0)
+			work(0, item_count);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mp_work            = &work;
+		m_item_count       = item_count;
+		m_block_count      = block_count;
+		m_blocks_remaining = block_count - 1;
+		m_generation++;
+	}
+	m_work_ready.notify_all();
+
+	work(0, getBlockBegin(1));
+
+	unique_lock<mutex> lock(m_mutex);
+	m_work_done.wait(lock, [this] () {  return m_blocks_remaining == 0;  });
+	mp_work = nullptr;
+}
+
+
+
+void WorkerPool :: startThreads ()
+{
+	assert(mv_threads.empty());
+
+	// no threads are running, so the shared state can be reset
+	//  without locking.  The new threads start waiting for
+	//  generation 0, so old work is not run again.
+	mp_work            = nullptr;
+	m_item_count       = 0;
+	m_block_count      = 0;
+	m_blocks_remaining = 0;
+	m_generation       = 0;
+	m_is_stopping      = false;
+	for(unsigned int t = 1; t < m_thread_count; t++)
+		mv_threads.push_back(thread(&WorkerPool::workerMain, this, t));
+}
+
+void WorkerPool :: stopThreads ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_work_ready.notify_all();
+
+	for(unsigned int t = 0; t < mv_threads.size(); t++)
+		mv_threads[t].join();
+	mv_threads.clear();
+}
+
+void WorkerPool :: workerMain (unsigned int block)
+{
+	assert(block >= 1);
+
+	unsigned int last_generation = 0;
+	unique_lock<mutex> lock(m_mutex);
+	while(true)
+	{
+		m_work_ready.wait(lock, [this, last_generation] ()
+		                  {  return m_is_stopping || m_generation != last_generation;  });
+		if(m_is_stopping)
+			return;
+		last_generation = m_generation;
+
+		if(block < m_block_count)
+		{
+			const Work& work = *mp_work;
+			unsigned int begin = getBlockBegin(block);
+			unsigned int end   = getBlockBegin(block + 1);
+
+			lock.unlock();
+			work(begin, end);
+			lock.lock();
+
+			assert(m_blocks_remaining > 0);
+			m_blocks_remaining--;
+			if(m_blocks_remaining == 0)
+				m_work_done.notify_one();
+		}
+	}
+}
+
+unsigned int WorkerPool :: getBlockBegin (unsigned int block) const
+{
+	assert(block <= m_block_count);
+	assert(m_block_count > 0);
+
+	return (unsigned int)((unsigned long long)(m_item_count) * block / m_block_count);
+}
+
+bool WorkerPool :: invariant () const
+{
+	if(mv_threads.size() + 1 != m_thread_count) return false;
+	if(m_thread_count < 1) return false;
+	return true;
+}
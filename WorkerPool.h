@@ -0,0 +1,217 @@
+//
+//  WorkerPool.h
+//
+//  A module to split work across several threads.
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+
+//
+//  WorkerPool
+//
+//  A class to run work on several threads at once.  The work is
+//    a range of items, which is split into contiguous blocks,
+//    one per thread.  The thread that calls run does the first
+//    block itself and then waits for the other threads to
+//    finish, so run returns when all the work is done.
+//
+//  Which items go to which thread depends only on the number of
+//    items and threads.  Work functions that only write to
+//    their own items therefore give the same results for any
+//    number of threads.
+//
+//  A WorkerPool with a thread count of 1 has no extra threads
+//    and runs all work on the calling thread.
+//
+//  Class Invariant:
+//    <1> mv_threads.size() + 1 == m_thread_count
+//    <2> m_thread_count >= 1
+//
+class WorkerPool
+{
+public:
+//
+//  Work
+//
+//  The type of the function run by the threads.  It is passed
+//    the first item to process and one past the last.
+//
+	typedef std::function<void (unsigned int begin, unsigned int end)> Work;
+
+public:
+//
+//  Constructor
+//
+//  Purpose: To create a WorkerPool with the specified number of
+//           threads.
+//  Parameter(s):
+//    <1> thread_count: The number of threads, including the
+//                      thread that calls run
+//  Preconditions:
+//    <1> thread_count >= 1
+//  Returns: N/A
+//  Side Effect: A new WorkerPool is created and thread_count - 1
+//               worker threads are started.
+//
+	WorkerPool (unsigned int thread_count);
+
+	WorkerPool (const WorkerPool& to_copy) = delete;
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this WorkerPool.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The worker threads are stopped.
+//
+	~WorkerPool ();
+
+	WorkerPool& operator= (const WorkerPool& to_copy) = delete;
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine how many threads this WorkerPool runs
+//           work on.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of threads, including the thread that
+//           calls run.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{  return m_thread_count;  }
+
+//
+//  setThreadCount
+//
+//  Purpose: To change the number of threads.
+//  Parameter(s):
+//    <1> thread_count: The new number of threads, including the
+//                      thread that calls run
+//  Preconditions:
+//    <1> thread_count >= 1
+//    <2> run is not currently running
+//  Returns: N/A
+//  Side Effect: The worker threads are stopped and
+//               thread_count - 1 new ones are started.
+//
+	void setThreadCount (unsigned int thread_count);
+
+//
+//  run
+//
+//  Purpose: To process the specified items with the worker
+//           threads.
+//  Parameter(s):
+//    <1> item_count: The number of items
+//    <2> min_items_per_thread: The fewest items worth starting
+//                              another thread for
+//    <3> work: The function to process items with
+//  Preconditions:
+//    <1> min_items_per_thread >= 1
+//    <2> work must not call run for this WorkerPool
+//  Returns: N/A
+//  Side Effect: The items are split into at most
+//               getThreadCount() contiguous blocks of at least
+//               min_items_per_thread items (unless there are
+//               fewer items than that in total).  work is called
+//               once for each block, all at the same time on
+//               different threads.  If there is only one block,
+//               it is processed on the calling thread.
+//
+	void run (unsigned int item_count,
+	          unsigned int min_items_per_thread,
+	          const Work& work);
+
+private:
+//
+//  startThreads
+//
+//  Purpose: To start the worker threads.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> mv_threads.empty()
+//  Returns: N/A
+//  Side Effect: The work state is reset and m_thread_count - 1
+//               worker threads are started.
+//
+	void startThreads ();
+
+//
+//  stopThreads
+//
+//  Purpose: To stop the worker threads.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: All worker threads are stopped and removed.
+//
+	void stopThreads ();
+
+//
+//  workerMain
+//
+//  Purpose: To run the loop for a worker thread.
+//  Parameter(s):
+//    <1> block: The block of items this worker processes
+//  Preconditions:
+//    <1> block >= 1
+//  Returns: N/A
+//  Side Effect: This thread waits for work, processes block
+//               block of it, and repeats until the WorkerPool
+//               is stopped.
+//
+	void workerMain (unsigned int block);
+
+//
+//  getBlockBegin
+//
+//  Purpose: To determine the first item in the specified block
+//           of the current work.
+//  Parameter(s):
+//    <1> block: Which block
+//  Preconditions:
+//    <1> block <= m_block_count
+//  Returns: The first item in block block.  If block is
+//           m_block_count, this is one past the last item.
+//  Side Effect: N/A
+//
+	unsigned int getBlockBegin (unsigned int block) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_thread_count;
+	std::vector<std::thread> mv_threads;
+
+	// shared with the worker threads, guarded by m_mutex
+	std::mutex m_mutex;
+	std::condition_variable m_work_ready;
+	std::condition_variable m_work_done;
+	const Work* mp_work;
+	unsigned int m_item_count;
+	unsigned int m_block_count;
+	unsigned int m_blocks_remaining;
+	unsigned int m_generation;
+	bool m_is_stopping;
+};
@@ -0,0 +1,67 @@
+//
+//  WorkerPoolCheck.cpp
+//
+//  A program to check that a WorkerPool still runs work
+//    correctly after its thread count is changed.  Each run
+//    adds one to every item, and the items are checked after
+//    every run.
+//
+//  Usage: worker_pool_check
+//
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "WorkerPool.h"
+
+using namespace std;
+
+namespace
+{
+	const unsigned int ITEM_COUNT = 10000;
+	const unsigned int MIN_ITEMS_PER_THREAD = 1;
+	const unsigned int RUNS_PER_THREAD_COUNT = 3;
+	const unsigned int ROUND_COUNT = 100;
+	const unsigned int THREAD_COUNTS[] = { 2, 4, 1, 3, 8, 2 };
+	const unsigned int THREAD_COUNT_COUNT = sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]);
+
+}  // end of anonymous namespace
+
+
+
+int main ()
+{
+	vector<unsigned int> v_items(ITEM_COUNT, 0);
+	WorkerPool::Work work = [&v_items] (unsigned int begin, unsigned int end)
+	{
+		for(unsigned int i = begin; i < end; i++)
+			v_items[i]++;
+	};
+
+	WorkerPool pool(THREAD_COUNTS[0]);
+	unsigned int expected = 0;
+	for(unsigned int round = 0; round < ROUND_COUNT; round++)
+		for(unsigned int c = 0; c < THREAD_COUNT_COUNT; c++)
+		{
+			pool.setThreadCount(THREAD_COUNTS[c]);
+			for(unsigned int r = 0; r < RUNS_PER_THREAD_COUNT; r++)
+			{
+				pool.run(ITEM_COUNT, MIN_ITEMS_PER_THREAD, work);
+				expected++;
+
+				for(unsigned int i = 0; i < ITEM_COUNT; i++)
+				{
+					if(v_items[i] != expected)
+					{
+						cerr << "Item " << i << " is " << v_items[i] << " instead of " << expected
+						     << " after run " << r << " with " << THREAD_COUNTS[c] << " threads" << endl;
+						return 1;
+					}
+				}
+			}
+		}
+
+	cout << "WorkerPool check passed" << endl;
+	return 0;
+}
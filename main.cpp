@@ -9,6 +9,7 @@
 #include <vector>
 #include <algorithm>  // for min/max
 #include <chrono>
+#include <thread>
 
 #include "GetGlut.h"
 #include "Sleep.h"
@@ -76,6 +77,14 @@ namespace
 
 	Game* gp_game = nullptr;
 
+	unsigned int getHardwareThreadCount ()
+	{
+		unsigned int thread_count = thread::hardware_concurrency();
+		if(thread_count == 0)
+			return 1;  // unknown
+		return thread_count;
+	}
+
 }  // end of anonymous namespace
 
 
@@ -106,7 +115,7 @@ int main (int argc, char* argv[])
 	Game::loadModels(path);
 
 	initDisplay();
-	gp_game = new Game();
+	gp_game = new Game(getHardwareThreadCount());
 	initTime();  // should be last
 
 	glutMainLoop();
@@ -338,7 +347,7 @@ void handleInput (double delta_time)
 	if(key_pressed[KEY_PRESSED_END])
 	{
 		delete gp_game;
-		gp_game = new Game();
+		gp_game = new Game(getHardwareThreadCount());
 		key_pressed[KEY_PRESSED_END] = false;  // only once per keypress
 	}
 }
@@ -427,13 +436,35 @@ void drawOverlays ()
 	stringstream drones_ss;
 	drones_ss << "Living Drones: " << gp_game->getLivingDroneCount();
 	font.draw(drones_ss.str(), 16, 112);
+
+	// display culling information
+
+	assert(gp_game != nullptr);
+	stringstream culling_ss;
+	culling_ss << "Drawn: " << gp_game->getDrawCounts().m_drawn
+	           << "  Culled: " << gp_game->getDrawCounts().m_culled;
+	font.draw(culling_ss.str(), 16, 136);
+
+	stringstream triangles_ss;
+	triangles_ss << "Asteroid triangles: " << gp_game->getDrawCounts().m_asteroid_triangles;
+	font.draw(triangles_ss.str(), 16, 160);
+
+	stringstream materials_ss;
+	materials_ss << "Material changes: " << gp_game->getDrawCounts().m_material_groups
+	             << " for " << gp_game->getDrawCounts().m_meshes << " meshes";
+	font.draw(materials_ss.str(), 16, 184);
+
+	stringstream debug_ss;
+	debug_ss << "Lines: " << gp_game->getDrawCounts().m_debug_lines
+	         << "  Markers: " << gp_game->getDrawCounts().m_debug_markers;
+	font.draw(debug_ss.str(), 16, 208);
 /*
 	// display player information
 
 	assert(gp_game != nullptr);
 	stringstream player_ss;
 	player_ss << "Player Speed: " << gp_game->getPlayer().getVelocity().getNorm();
-	font.draw(player_ss.str(), 16, 136);
+	font.draw(player_ss.str(), 16, 232);
 */
 	// display control keys
 